@@ -882,4 +882,13 @@ module TreeWriter TreeWriter {
   add Branch ScalarHT/energy ScalarHT ScalarHT
   add Branch Rho/rho Rho Rho
   add Branch PileUpMerger/vertices Vertex Vertex
+
+# write only the generator particles referenced by the other branches,
+# the particles matching Status PID MinPT (0 matches any status or PID)
+# and their ancestors
+#  set PruneParticles true
+#  add KeepParticles 0 6 0.0
+#  add KeepParticles 0 23 0.0
+#  add KeepParticles 0 24 0.0
+#  add KeepParticles 0 25 0.0
 }
@@ -64,6 +64,11 @@
 #pragma link C++ class ParticleFlowCandidate+;
 #pragma link C++ class HectorHit+;
 
+#pragma link C++ class CandidateBlock+;
+#pragma link C++ class CandidateSubstructure+;
+#pragma link C++ class CandidateTrackCovariance+;
+#pragma link C++ class CandidateTiming+;
+
 #pragma link C++ class Candidate+;
 
 #endif
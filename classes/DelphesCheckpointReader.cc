@@ -0,0 +1,219 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesCheckpointReader
+ *
+ *  Reads checkpoint file written by DelphesCheckpointWriter.
+ *
+ */
+
+#include "classes/DelphesCheckpointReader.h"
+
+#include "classes/DelphesClasses.h"
+#include "classes/DelphesFactory.h"
+
+#include "TClonesArray.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <string.h>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesCheckpointReader::DelphesCheckpointReader(const char *fileName) :
+  fFile(0), fTree(0), fEventNumber(0), fInputNumber(0),
+  fCandidates(0), fSubstructures(0), fTrackCovariances(0), fTimings(0),
+  fArraySizes(0), fArrayEntries(0), fConstituentSizes(0), fConstituents(0),
+  fSubstructureIndices(0), fTrackCovarianceIndices(0), fTimingIndices(0)
+{
+  stringstream message;
+  TObject *object;
+
+  fFile = TFile::Open(fileName);
+  if(fFile == NULL)
+  {
+    message << "can't open " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  fTree = static_cast<TTree *>(fFile->Get("Checkpoint"));
+  if(!fTree)
+  {
+    message << "no checkpoint tree in " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  TIter itInfo(fTree->GetUserInfo());
+  while((object = itInfo.Next()))
+  {
+    if(strcmp(object->GetName(), "Module") == 0)
+    {
+      fModuleName = object->GetTitle();
+    }
+    else if(strcmp(object->GetName(), "Array") == 0)
+    {
+      fArrayNames.push_back(object->GetTitle());
+      fArrays.push_back(0);
+    }
+  }
+
+  fTree->SetBranchAddress("Number", &fEventNumber);
+  fTree->SetBranchAddress("Input", &fInputNumber);
+
+  fTree->SetBranchAddress("Candidate", &fCandidates);
+  fTree->SetBranchAddress("Substructure", &fSubstructures);
+  fTree->SetBranchAddress("TrackCovariance", &fTrackCovariances);
+  fTree->SetBranchAddress("Timing", &fTimings);
+
+  fTree->SetBranchAddress("ArraySize", &fArraySizes);
+  fTree->SetBranchAddress("ArrayEntry", &fArrayEntries);
+  fTree->SetBranchAddress("ConstituentSize", &fConstituentSizes);
+  fTree->SetBranchAddress("Constituent", &fConstituents);
+  fTree->SetBranchAddress("SubstructureIndex", &fSubstructureIndices);
+  fTree->SetBranchAddress("TrackCovarianceIndex", &fTrackCovarianceIndices);
+  fTree->SetBranchAddress("TimingIndex", &fTimingIndices);
+}
+
+//------------------------------------------------------------------------------
+
+DelphesCheckpointReader::~DelphesCheckpointReader()
+{
+  if(fTree) fTree->ResetBranchAddresses();
+  if(fFile) fFile->Close();
+
+  delete fFile;
+
+  delete fCandidates;
+  delete fSubstructures;
+  delete fTrackCovariances;
+  delete fTimings;
+
+  delete fArraySizes;
+  delete fArrayEntries;
+  delete fConstituentSizes;
+  delete fConstituents;
+  delete fSubstructureIndices;
+  delete fTrackCovarianceIndices;
+  delete fTimingIndices;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesCheckpointReader::GetEntries() const
+{
+  return fTree->GetEntries();
+}
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+T *DelphesCheckpointReader::GetBlock(Int_t index, TClonesArray *array, vector<T *> &blocks, DelphesFactory *factory)
+{
+  T *block;
+
+  if(index < 0) return 0;
+
+  // blocks shared in the checkpoint are shared again
+  block = blocks[index];
+  if(!block)
+  {
+    block = factory->New<T>();
+    *block = *static_cast<T *>(array->At(index));
+    block->fReferences = 0;
+    blocks[index] = block;
+  }
+  ++block->fReferences;
+
+  return block;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpointReader::ReadEntry(Long64_t entry, DelphesFactory *factory)
+{
+  stringstream message;
+  vector<CandidateSubstructure *> substructures;
+  vector<CandidateTrackCovariance *> trackCovariances;
+  vector<CandidateTiming *> timings;
+  Candidate *candidate, *stored;
+  UInt_t candidateID;
+  Int_t i, j, k, size;
+
+  if(fTree->GetEntry(entry) <= 0)
+  {
+    message << "can't read checkpoint entry " << entry;
+    throw runtime_error(message.str());
+  }
+
+  size = fCandidates->GetEntriesFast();
+
+  substructures.assign(fSubstructures->GetEntriesFast(), 0);
+  trackCovariances.assign(fTrackCovariances->GetEntriesFast(), 0);
+  timings.assign(fTimings->GetEntriesFast(), 0);
+
+  fCandidateList.resize(size);
+  for(i = 0; i < size; ++i)
+  {
+    stored = static_cast<Candidate *>(fCandidates->At(i));
+    candidate = factory->NewCandidate();
+
+    // the factory link and the identifier of the new candidate are kept
+    candidateID = candidate->fCandidateID;
+    *candidate = *stored;
+    candidate->SetUniqueID(0);
+    candidate->ResetBit(TObject::kIsReferenced);
+    candidate->fFactory = factory;
+    candidate->fArray = 0;
+    candidate->fCandidateID = candidateID;
+
+    candidate->fSubstructure = GetBlock((*fSubstructureIndices)[i], fSubstructures, substructures, factory);
+    candidate->fTrackCovariance = GetBlock((*fTrackCovarianceIndices)[i], fTrackCovariances, trackCovariances, factory);
+    candidate->fTiming = GetBlock((*fTimingIndices)[i], fTimings, timings, factory);
+
+    fCandidateList[i] = candidate;
+  }
+
+  k = 0;
+  for(i = 0; i < size; ++i)
+  {
+    for(j = 0; j < (*fConstituentSizes)[i]; ++j, ++k)
+    {
+      fCandidateList[i]->AddCandidate(fCandidateList[(*fConstituents)[k]]);
+    }
+  }
+
+  k = 0;
+  for(i = 0; i < Int_t(fArrays.size()); ++i)
+  {
+    for(j = 0; j < (*fArraySizes)[i]; ++j, ++k)
+    {
+      if(fArrays[i]) fArrays[i]->Add(fCandidateList[(*fArrayEntries)[k]]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesCheckpointReader_h
+#define DelphesCheckpointReader_h
+
+/** \class DelphesCheckpointReader
+ *
+ *  Reads checkpoint file written by DelphesCheckpointWriter.
+ *
+ *  The candidates of each entry are allocated from the factory with their
+ *  constituents and data blocks restored, and added to the arrays set up
+ *  with SetArray. Arrays of the checkpoint without a destination are
+ *  skipped.
+ *
+ */
+
+#include "Rtypes.h"
+#include "TString.h"
+
+#include <vector>
+
+class TClonesArray;
+class TFile;
+class TObjArray;
+class TTree;
+
+class Candidate;
+class DelphesFactory;
+
+class DelphesCheckpointReader
+{
+public:
+  DelphesCheckpointReader(const char *fileName);
+
+  ~DelphesCheckpointReader();
+
+  Long64_t GetEntries() const;
+
+  // name of the module instance that wrote the checkpoint
+  const char *GetModuleName() const { return fModuleName; }
+
+  Int_t GetNumberOfArrays() const { return fArrayNames.size(); }
+  const char *GetArrayName(Int_t i) const { return fArrayNames[i]; }
+
+  void SetArray(Int_t i, TObjArray *array) { fArrays[i] = array; }
+
+  void ReadEntry(Long64_t entry, DelphesFactory *factory);
+
+  ULong64_t GetEventNumber() const { return fEventNumber; }
+  UInt_t GetInputNumber() const { return fInputNumber; }
+
+private:
+  template <typename T>
+  T *GetBlock(Int_t index, TClonesArray *array, std::vector<T *> &blocks, DelphesFactory *factory);
+
+  TFile *fFile;
+  TTree *fTree;
+
+  TString fModuleName;
+
+  std::vector<TString> fArrayNames;
+  std::vector<TObjArray *> fArrays;
+
+  std::vector<Candidate *> fCandidateList;
+
+  ULong64_t fEventNumber;
+  UInt_t fInputNumber;
+
+  TClonesArray *fCandidates;
+  TClonesArray *fSubstructures;
+  TClonesArray *fTrackCovariances;
+  TClonesArray *fTimings;
+
+  std::vector<Int_t> *fArraySizes, *fArrayEntries;
+  std::vector<Int_t> *fConstituentSizes, *fConstituents;
+  std::vector<Int_t> *fSubstructureIndices, *fTrackCovarianceIndices, *fTimingIndices;
+};
+
+#endif // DelphesCheckpointReader_h
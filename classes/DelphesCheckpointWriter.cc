@@ -0,0 +1,242 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesCheckpointWriter
+ *
+ *  Writes checkpoint file with the candidate arrays of each event.
+ *
+ */
+
+#include "classes/DelphesCheckpointWriter.h"
+
+#include "classes/DelphesClasses.h"
+
+#include "TClonesArray.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesCheckpointWriter::DelphesCheckpointWriter(const char *fileName, const char *moduleName) :
+  fFile(0), fTree(0), fEventNumber(0), fInputNumber(0),
+  fCandidates(0), fSubstructures(0), fTrackCovariances(0), fTimings(0),
+  fArraySizes(0), fArrayEntries(0), fConstituentSizes(0), fConstituents(0),
+  fSubstructureIndices(0), fTrackCovarianceIndices(0), fTimingIndices(0)
+{
+  stringstream message;
+
+  fFile = TFile::Open(fileName, "RECREATE");
+  if(fFile == NULL)
+  {
+    message << "can't create " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  fTree = new TTree("Checkpoint", "Delphes checkpoint");
+  fTree->SetDirectory(fFile);
+
+  // name of the module instance at which ExecutionPath is resumed
+  fTree->GetUserInfo()->Add(new TNamed("Module", moduleName));
+
+  fCandidates = new TClonesArray(Candidate::Class());
+  fSubstructures = new TClonesArray(CandidateSubstructure::Class());
+  fTrackCovariances = new TClonesArray(CandidateTrackCovariance::Class());
+  fTimings = new TClonesArray(CandidateTiming::Class());
+
+  fArraySizes = new vector<Int_t>;
+  fArrayEntries = new vector<Int_t>;
+  fConstituentSizes = new vector<Int_t>;
+  fConstituents = new vector<Int_t>;
+  fSubstructureIndices = new vector<Int_t>;
+  fTrackCovarianceIndices = new vector<Int_t>;
+  fTimingIndices = new vector<Int_t>;
+
+  fTree->Branch("Number", &fEventNumber, "Number/l");
+  fTree->Branch("Input", &fInputNumber, "Input/i");
+
+  fTree->Branch("Candidate", &fCandidates, 64000);
+  fTree->Branch("Substructure", &fSubstructures, 64000);
+  fTree->Branch("TrackCovariance", &fTrackCovariances, 64000);
+  fTree->Branch("Timing", &fTimings, 64000);
+
+  fTree->Branch("ArraySize", &fArraySizes);
+  fTree->Branch("ArrayEntry", &fArrayEntries);
+  fTree->Branch("ConstituentSize", &fConstituentSizes);
+  fTree->Branch("Constituent", &fConstituents);
+  fTree->Branch("SubstructureIndex", &fSubstructureIndices);
+  fTree->Branch("TrackCovarianceIndex", &fTrackCovarianceIndices);
+  fTree->Branch("TimingIndex", &fTimingIndices);
+}
+
+//------------------------------------------------------------------------------
+
+DelphesCheckpointWriter::~DelphesCheckpointWriter()
+{
+  if(fFile) fFile->Close();
+
+  delete fFile;
+
+  delete fCandidates;
+  delete fSubstructures;
+  delete fTrackCovariances;
+  delete fTimings;
+
+  delete fArraySizes;
+  delete fArrayEntries;
+  delete fConstituentSizes;
+  delete fConstituents;
+  delete fSubstructureIndices;
+  delete fTrackCovarianceIndices;
+  delete fTimingIndices;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpointWriter::AddArray(const char *name, const TObjArray *array)
+{
+  fTree->GetUserInfo()->Add(new TNamed("Array", name));
+  fArrays.push_back(array);
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesCheckpointWriter::GetIndex(Candidate *candidate)
+{
+  map<const Candidate *, Int_t>::iterator itCandidateIndices;
+  Int_t index;
+
+  itCandidateIndices = fCandidateIndices.find(candidate);
+  if(itCandidateIndices != fCandidateIndices.end()) return itCandidateIndices->second;
+
+  index = fCandidateList.size();
+  fCandidateIndices[candidate] = index;
+  fCandidateList.push_back(candidate);
+
+  return index;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename T>
+Int_t DelphesCheckpointWriter::AddBlock(const T *block, TClonesArray *array)
+{
+  map<const TObject *, Int_t>::iterator itBlockIndices;
+  Int_t index;
+
+  if(!block) return -1;
+
+  itBlockIndices = fBlockIndices.find(block);
+  if(itBlockIndices != fBlockIndices.end()) return itBlockIndices->second;
+
+  index = array->GetEntriesFast();
+  *static_cast<T *>(array->ConstructedAt(index)) = *block;
+  fBlockIndices[block] = index;
+
+  return index;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpointWriter::WriteEntry(ULong64_t eventNumber, UInt_t inputNumber)
+{
+  vector<const TObjArray *>::const_iterator itArrays;
+  Candidate *candidate, *constituent, *entry;
+  Int_t i, j, size;
+
+  fEventNumber = eventNumber;
+  fInputNumber = inputNumber;
+
+  fCandidateIndices.clear();
+  fBlockIndices.clear();
+  fCandidateList.clear();
+
+  fCandidates->Clear("C");
+  fSubstructures->Clear("C");
+  fTrackCovariances->Clear("C");
+  fTimings->Clear("C");
+
+  fArraySizes->clear();
+  fArrayEntries->clear();
+  fConstituentSizes->clear();
+  fConstituents->clear();
+  fSubstructureIndices->clear();
+  fTrackCovarianceIndices->clear();
+  fTimingIndices->clear();
+
+  for(itArrays = fArrays.begin(); itArrays != fArrays.end(); ++itArrays)
+  {
+    size = (*itArrays)->GetEntriesFast();
+    fArraySizes->push_back(size);
+    for(i = 0; i < size; ++i)
+    {
+      fArrayEntries->push_back(GetIndex(static_cast<Candidate *>((*itArrays)->At(i))));
+    }
+  }
+
+  // constituents are appended to the list while it is being written
+  for(i = 0; i < Int_t(fCandidateList.size()); ++i)
+  {
+    candidate = fCandidateList[i];
+
+    // plain copy of the data members, the links to the factory,
+    // the constituents and the data blocks are stored separately
+    entry = static_cast<Candidate *>(fCandidates->ConstructedAt(i));
+    *entry = *candidate;
+    entry->SetUniqueID(0);
+    entry->ResetBit(TObject::kIsReferenced);
+    entry->fFactory = 0;
+    entry->fArray = 0;
+    entry->fCandidateID = 0;
+    entry->fSubstructure = 0;
+    entry->fTrackCovariance = 0;
+    entry->fTiming = 0;
+
+    fSubstructureIndices->push_back(AddBlock(candidate->fSubstructure, fSubstructures));
+    fTrackCovarianceIndices->push_back(AddBlock(candidate->fTrackCovariance, fTrackCovariances));
+    fTimingIndices->push_back(AddBlock(candidate->fTiming, fTimings));
+
+    size = candidate->fArray ? candidate->fArray->GetEntriesFast() : 0;
+    fConstituentSizes->push_back(size);
+    for(j = 0; j < size; ++j)
+    {
+      constituent = static_cast<Candidate *>(candidate->fArray->At(j));
+      fConstituents->push_back(GetIndex(constituent));
+    }
+  }
+
+  fTree->Fill();
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesCheckpointWriter::Write()
+{
+  fFile->cd();
+  fTree->Write("", TObject::kOverwrite);
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesCheckpointWriter_h
+#define DelphesCheckpointWriter_h
+
+/** \class DelphesCheckpointWriter
+ *
+ *  Writes checkpoint file with the candidate arrays of each event.
+ *
+ *  The candidates of the arrays and all the candidates reachable through
+ *  their constituents are written once per event to the "Candidate"
+ *  branch, together with their substructure, track covariance and timing
+ *  blocks. Constituent lists and array contents are stored as indices
+ *  into this branch, so that candidates shared between several arrays
+ *  or jets are shared again when the checkpoint is read back.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <map>
+#include <vector>
+
+class TClonesArray;
+class TFile;
+class TObjArray;
+class TTree;
+
+class Candidate;
+
+class DelphesCheckpointWriter
+{
+public:
+  DelphesCheckpointWriter(const char *fileName, const char *moduleName);
+
+  ~DelphesCheckpointWriter();
+
+  // arrays are identified by their Module/array name in the checkpoint
+  void AddArray(const char *name, const TObjArray *array);
+
+  void WriteEntry(ULong64_t eventNumber, UInt_t inputNumber);
+
+  void Write();
+
+private:
+  Int_t GetIndex(Candidate *candidate);
+
+  template <typename T>
+  Int_t AddBlock(const T *block, TClonesArray *array);
+
+  TFile *fFile;
+  TTree *fTree;
+
+  std::vector<const TObjArray *> fArrays;
+
+  std::map<const Candidate *, Int_t> fCandidateIndices;
+  std::map<const TObject *, Int_t> fBlockIndices;
+  std::vector<Candidate *> fCandidateList;
+
+  ULong64_t fEventNumber;
+  UInt_t fInputNumber;
+
+  TClonesArray *fCandidates;
+  TClonesArray *fSubstructures;
+  TClonesArray *fTrackCovariances;
+  TClonesArray *fTimings;
+
+  std::vector<Int_t> *fArraySizes, *fArrayEntries;
+  std::vector<Int_t> *fConstituentSizes, *fConstituents;
+  std::vector<Int_t> *fSubstructureIndices, *fTrackCovarianceIndices, *fTimingIndices;
+};
+
+#endif // DelphesCheckpointWriter_h
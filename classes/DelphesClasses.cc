@@ -208,6 +208,101 @@ TMatrixDSym ParticleFlowCandidate::CovarianceMatrix() const
 
 //------------------------------------------------------------------------------
 
+CandidateBlock::CandidateBlock() :
+  fReferences(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+CandidateBlock::CandidateBlock(const CandidateBlock &object) :
+  TObject(object), fReferences(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+CandidateBlock &CandidateBlock::operator=(const CandidateBlock &object)
+{
+  TObject::operator=(object);
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateBlock::Clear(Option_t *option)
+{
+  fReferences = 0;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateSubstructure::CandidateSubstructure()
+{
+  Clear();
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateSubstructure::Clear(Option_t *option)
+{
+  int i;
+
+  CandidateBlock::Clear(option);
+
+  for(i = 0; i < 5; ++i)
+  {
+    Tau[i] = 0.0;
+    TrimmedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
+    PrunedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
+    SoftDroppedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
+  }
+
+  SoftDroppedJet.SetXYZT(0.0, 0.0, 0.0, 0.0);
+  SoftDroppedSubJet1.SetXYZT(0.0, 0.0, 0.0, 0.0);
+  SoftDroppedSubJet2.SetXYZT(0.0, 0.0, 0.0, 0.0);
+
+  NSubJetsTrimmed = 0;
+  NSubJetsPruned = 0;
+  NSubJetsSoftDropped = 0;
+
+  ExclYmerge23 = 0.0;
+  ExclYmerge34 = 0.0;
+  ExclYmerge45 = 0.0;
+  ExclYmerge56 = 0.0;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateTrackCovariance::CandidateTrackCovariance() :
+  Covariance(5)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateTrackCovariance::Clear(Option_t *option)
+{
+  CandidateBlock::Clear(option);
+  Covariance.Zero();
+}
+
+//------------------------------------------------------------------------------
+
+CandidateTiming::CandidateTiming()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CandidateTiming::Clear(Option_t *option)
+{
+  CandidateBlock::Clear(option);
+  ECalEnergyTimePairs.clear();
+}
+
+//------------------------------------------------------------------------------
+
 Candidate::Candidate() :
   PID(0), Status(0), M1(-1), M2(-1), D1(-1), D2(-1),
   Charge(0), Mass(0.0),
@@ -222,7 +317,6 @@ Candidate::Candidate() :
   DecayPosition(0.0, 0.0, 0.0, 0.0),
   PositionError(0.0, 0.0, 0.0, 0.0),
   Area(0.0, 0.0, 0.0, 0.0),
-  TrackCovariance(5),
   L(0),
   D0(0), ErrorD0(0),
   DZ(0), ErrorDZ(0),
@@ -252,18 +346,14 @@ Candidate::Candidate() :
   SumPtChargedPU(-999),
   SumPt(-999),
   ClusterIndex(-1), ClusterNDF(0), ClusterSigma(0), SumPT2(0), BTVSumPT2(0), GenDeltaZ(0), GenSumPT2(0),
-  NSubJetsTrimmed(0),
-  NSubJetsPruned(0),
-  NSubJetsSoftDropped(0),
-  ExclYmerge23(0),
-  ExclYmerge34(0),
-  ExclYmerge45(0),
-  ExclYmerge56(0),
   ParticleDensity(0),
   fFactory(0),
-  fArray(0)
+  fArray(0),
+  fCandidateID(0),
+  fSubstructure(0),
+  fTrackCovariance(0),
+  fTiming(0)
 {
-  int i;
   Edges[0] = 0.0;
   Edges[1] = 0.0;
   Edges[2] = 0.0;
@@ -273,29 +363,13 @@ Candidate::Candidate() :
   FracPt[2] = 0.0;
   FracPt[3] = 0.0;
   FracPt[4] = 0.0;
-  Tau[0] = 0.0;
-  Tau[1] = 0.0;
-  Tau[2] = 0.0;
-  Tau[3] = 0.0;
-  Tau[4] = 0.0;
-
-  SoftDroppedJet.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet1.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet2.SetXYZT(0.0, 0.0, 0.0, 0.0);
-
-  for(i = 0; i < 5; ++i)
-  {
-    TrimmedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    PrunedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    SoftDroppedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-  }
 }
 
 //------------------------------------------------------------------------------
 
 void Candidate::AddCandidate(Candidate *object)
 {
-  if(!fArray) fArray = fFactory->NewArray();
+  if(!fArray) fFactory->AllocateArray(fArray);
   fArray->Add(object);
 }
 
@@ -303,17 +377,24 @@ void Candidate::AddCandidate(Candidate *object)
 
 TObjArray *Candidate::GetCandidates()
 {
-  if(!fArray) fArray = fFactory->NewArray();
+  if(!fArray) fFactory->AllocateArray(fArray);
   return fArray;
 }
 
 //------------------------------------------------------------------------------
 
+Int_t Candidate::GetNumberOfCandidates() const
+{
+  return fArray ? fArray->GetEntriesFast() : 0;
+}
+
+//------------------------------------------------------------------------------
+
 Bool_t Candidate::Overlaps(const Candidate *object) const
 {
   const Candidate *candidate;
 
-  if(object->GetUniqueID() == GetUniqueID()) return kTRUE;
+  if(object->GetCandidateID() == GetCandidateID()) return kTRUE;
 
   if(fArray)
   {
@@ -338,6 +419,73 @@ Bool_t Candidate::Overlaps(const Candidate *object) const
 
 //------------------------------------------------------------------------------
 
+template <typename T>
+T *Candidate::EditBlock(T *&block)
+{
+  T *object;
+
+  if(block && block->fReferences.load(std::memory_order_acquire) == 1) return block;
+
+  // allocate a new block, or detach from the block shared with other candidates
+  object = fFactory->New<T>();
+  if(block)
+  {
+    *object = *block;
+    block->fReferences.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  object->fReferences = 1;
+  block = object;
+
+  return block;
+}
+
+//------------------------------------------------------------------------------
+
+const CandidateSubstructure &Candidate::GetSubstructure() const
+{
+  static const CandidateSubstructure empty;
+  return fSubstructure ? *fSubstructure : empty;
+}
+
+//------------------------------------------------------------------------------
+
+CandidateSubstructure &Candidate::EditSubstructure()
+{
+  return *EditBlock(fSubstructure);
+}
+
+//------------------------------------------------------------------------------
+
+const TMatrixDSym &Candidate::GetTrackCovariance() const
+{
+  static const CandidateTrackCovariance empty;
+  return fTrackCovariance ? fTrackCovariance->Covariance : empty.Covariance;
+}
+
+//------------------------------------------------------------------------------
+
+void Candidate::SetTrackCovariance(const TMatrixDSym &covariance)
+{
+  EditBlock(fTrackCovariance)->Covariance = covariance;
+}
+
+//------------------------------------------------------------------------------
+
+const std::vector<std::pair<Float_t, Float_t> > &Candidate::GetECalEnergyTimePairs() const
+{
+  static const CandidateTiming empty;
+  return fTiming ? fTiming->ECalEnergyTimePairs : empty.ECalEnergyTimePairs;
+}
+
+//------------------------------------------------------------------------------
+
+void Candidate::AddECalEnergyTimePair(Float_t energy, Float_t time)
+{
+  EditBlock(fTiming)->ECalEnergyTimePairs.push_back(std::make_pair(energy, time));
+}
+
+//------------------------------------------------------------------------------
+
 TObject *Candidate::Clone(const char *newname) const
 {
   Candidate *object = fFactory->NewCandidate();
@@ -444,41 +592,17 @@ void Candidate::Copy(TObject &obj) const
   object.FracPt[2] = FracPt[2];
   object.FracPt[3] = FracPt[3];
   object.FracPt[4] = FracPt[4];
-  object.Tau[0] = Tau[0];
-  object.Tau[1] = Tau[1];
-  object.Tau[2] = Tau[2];
-  object.Tau[3] = Tau[3];
-  object.Tau[4] = Tau[4];
-
-  object.TrimmedP4[0] = TrimmedP4[0];
-  object.TrimmedP4[1] = TrimmedP4[1];
-  object.TrimmedP4[2] = TrimmedP4[2];
-  object.TrimmedP4[3] = TrimmedP4[3];
-  object.TrimmedP4[4] = TrimmedP4[4];
-  object.PrunedP4[0] = PrunedP4[0];
-  object.PrunedP4[1] = PrunedP4[1];
-  object.PrunedP4[2] = PrunedP4[2];
-  object.PrunedP4[3] = PrunedP4[3];
-  object.PrunedP4[4] = PrunedP4[4];
-  object.SoftDroppedP4[0] = SoftDroppedP4[0];
-  object.SoftDroppedP4[1] = SoftDroppedP4[1];
-  object.SoftDroppedP4[2] = SoftDroppedP4[2];
-  object.SoftDroppedP4[3] = SoftDroppedP4[3];
-  object.SoftDroppedP4[4] = SoftDroppedP4[4];
-
-  object.NSubJetsTrimmed = NSubJetsTrimmed;
-  object.NSubJetsPruned = NSubJetsPruned;
-  object.NSubJetsSoftDropped = NSubJetsSoftDropped;
-
-  object.SoftDroppedJet = SoftDroppedJet;
-  object.SoftDroppedSubJet1 = SoftDroppedSubJet1;
-  object.SoftDroppedSubJet2 = SoftDroppedSubJet2;
-  object.TrackCovariance = TrackCovariance;
+
   object.fFactory = fFactory;
   object.fArray = 0;
 
-  // copy cluster timing info
-  copy(ECalEnergyTimePairs.begin(), ECalEnergyTimePairs.end(), back_inserter(object.ECalEnergyTimePairs));
+  // share substructure, covariance and timing blocks until one of the candidates modifies them
+  object.fSubstructure = fSubstructure;
+  object.fTrackCovariance = fTrackCovariance;
+  object.fTiming = fTiming;
+  if(fSubstructure) fSubstructure->fReferences.fetch_add(1, std::memory_order_relaxed);
+  if(fTrackCovariance) fTrackCovariance->fReferences.fetch_add(1, std::memory_order_relaxed);
+  if(fTiming) fTiming->fReferences.fetch_add(1, std::memory_order_relaxed);
 
   if(fArray && fArray->GetEntriesFast() > 0)
   {
@@ -495,9 +619,9 @@ void Candidate::Copy(TObject &obj) const
 
 void Candidate::Clear(Option_t *option)
 {
-  int i;
   SetUniqueID(0);
   ResetBit(kIsReferenced);
+  fCandidateID = 0;
   PID = 0;
   Status = 0;
   M1 = -1;
@@ -532,7 +656,6 @@ void Candidate::Clear(Option_t *option)
   InitialPosition.SetXYZT(0.0, 0.0, 0.0, 0.0);
   DecayPosition.SetXYZT(0.0, 0.0, 0.0, 0.0);
   Area.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  TrackCovariance.Zero();
   L = 0.0;
   ErrorT = 0.0;
   D0 = 0.0;
@@ -566,7 +689,6 @@ void Candidate::Clear(Option_t *option)
   PTD = 0.0;
 
   NTimeHits = 0;
-  ECalEnergyTimePairs.clear();
 
   IsolationVar = -999;
   IsolationVarRhoCorr = -999;
@@ -588,26 +710,11 @@ void Candidate::Clear(Option_t *option)
   FracPt[2] = 0.0;
   FracPt[3] = 0.0;
   FracPt[4] = 0.0;
-  Tau[0] = 0.0;
-  Tau[1] = 0.0;
-  Tau[2] = 0.0;
-  Tau[3] = 0.0;
-  Tau[4] = 0.0;
 
-  SoftDroppedJet.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet1.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  SoftDroppedSubJet2.SetXYZT(0.0, 0.0, 0.0, 0.0);
-
-  for(i = 0; i < 5; ++i)
-  {
-    TrimmedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    PrunedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-    SoftDroppedP4[i].SetXYZT(0.0, 0.0, 0.0, 0.0);
-  }
-
-  NSubJetsTrimmed = 0;
-  NSubJetsPruned = 0;
-  NSubJetsSoftDropped = 0;
+  // blocks are owned by the factory and recycled at the end of the event
+  fSubstructure = 0;
+  fTrackCovariance = 0;
+  fTiming = 0;
 
   fArray = 0;
 }
@@ -39,6 +39,8 @@
 
 #include "classes/SortableObject.h"
 
+#include <atomic>
+
 class DelphesFactory;
 
 //---------------------------------------------------------------------------
@@ -682,9 +684,104 @@ public:
 
 //---------------------------------------------------------------------------
 
+// Rarely used candidate data blocks, allocated on demand by the factory
+// and shared between a candidate and its clones until one of them
+// modifies the block (copy-on-write)
+
+class CandidateBlock: public TObject
+{
+  friend class Candidate;
+  friend class DelphesCheckpointReader;
+
+public:
+  CandidateBlock();
+
+  // a copy is a new block that is not shared yet
+  CandidateBlock(const CandidateBlock &object);
+  CandidateBlock &operator=(const CandidateBlock &object);
+
+  virtual void Clear(Option_t *option = "");
+
+private:
+  // candidates of concurrently running modules may share this block
+  std::atomic<Int_t> fReferences; //! number of candidates sharing this block
+
+  ClassDef(CandidateBlock, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateSubstructure: public CandidateBlock
+{
+public:
+  CandidateSubstructure();
+
+  // N-subjettiness variables
+
+  Float_t Tau[5];
+
+  // Other Substructure variables
+
+  TLorentzVector SoftDroppedJet;
+  TLorentzVector SoftDroppedSubJet1;
+  TLorentzVector SoftDroppedSubJet2;
+
+  TLorentzVector TrimmedP4[5]; // first entry (i = 0) is the total Trimmed Jet 4-momenta and from i = 1 to 4 are the trimmed subjets 4-momenta
+  TLorentzVector PrunedP4[5]; // first entry (i = 0) is the total Pruned Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
+  TLorentzVector SoftDroppedP4[5]; // first entry (i = 0) is the total SoftDropped Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
+
+  Int_t NSubJetsTrimmed; // number of subjets trimmed
+  Int_t NSubJetsPruned; // number of subjets pruned
+  Int_t NSubJetsSoftDropped; // number of subjets soft-dropped
+
+  // Exclusive clustering variables
+  Double_t ExclYmerge23;
+  Double_t ExclYmerge34;
+  Double_t ExclYmerge45;
+  Double_t ExclYmerge56;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateSubstructure, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateTrackCovariance: public CandidateBlock
+{
+public:
+  CandidateTrackCovariance();
+
+  // ACTS compliant 6x6 track covariance (D0, phi, Curvature, dz, ctg(theta))
+
+  TMatrixDSym Covariance;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateTrackCovariance, 1)
+};
+
+//---------------------------------------------------------------------------
+
+class CandidateTiming: public CandidateBlock
+{
+public:
+  CandidateTiming();
+
+  std::vector<std::pair<Float_t, Float_t> > ECalEnergyTimePairs;
+
+  virtual void Clear(Option_t *option = "");
+
+  ClassDef(CandidateTiming, 1)
+};
+
+//---------------------------------------------------------------------------
+
 class Candidate: public SortableObject
 {
   friend class DelphesFactory;
+  friend class DelphesCheckpointReader;
+  friend class DelphesCheckpointWriter;
 
 public:
   Candidate();
@@ -773,7 +870,6 @@ public:
   // Timing information
 
   Int_t NTimeHits;
-  std::vector<std::pair<Float_t, Float_t> > ECalEnergyTimePairs;
 
   // Isolation variables
 
@@ -784,10 +880,6 @@ public:
   Float_t SumPtChargedPU;
   Float_t SumPt;
 
-  // ACTS compliant 6x6 track covariance (D0, phi, Curvature, dz, ctg(theta))
-
-  TMatrixDSym TrackCovariance;
-
   // vertex variables
 
   Int_t ClusterIndex;
@@ -798,30 +890,6 @@ public:
   Double_t GenDeltaZ;
   Double_t GenSumPT2;
 
-  // N-subjettiness variables
-
-  Float_t Tau[5];
-
-  // Other Substructure variables
-
-  TLorentzVector SoftDroppedJet;
-  TLorentzVector SoftDroppedSubJet1;
-  TLorentzVector SoftDroppedSubJet2;
-
-  TLorentzVector TrimmedP4[5]; // first entry (i = 0) is the total Trimmed Jet 4-momenta and from i = 1 to 4 are the trimmed subjets 4-momenta
-  TLorentzVector PrunedP4[5]; // first entry (i = 0) is the total Pruned Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
-  TLorentzVector SoftDroppedP4[5]; // first entry (i = 0) is the total SoftDropped Jet 4-momenta and from i = 1 to 4 are the pruned subjets 4-momenta
-
-  Int_t NSubJetsTrimmed; // number of subjets trimmed
-  Int_t NSubJetsPruned; // number of subjets pruned
-  Int_t NSubJetsSoftDropped; // number of subjets soft-dropped
-
-  // Exclusive clustering variables
-  Double_t ExclYmerge23;
-  Double_t ExclYmerge34;
-  Double_t ExclYmerge45;
-  Double_t ExclYmerge56;
-
   // event characteristics variables
   Double_t ParticleDensity; // particle multiplicity density in the proximity of the particle
 
@@ -831,8 +899,32 @@ public:
   void AddCandidate(Candidate *object);
   TObjArray *GetCandidates();
 
+  // number of constituents, without allocating the array of a candidate that has none
+  Int_t GetNumberOfCandidates() const;
+
   Bool_t Overlaps(const Candidate *object) const;
 
+  // per-event identifier assigned by the factory, starting from 0;
+  // unique only among the candidates of one factory and of the factories
+  // sharing its sequence (see DelphesFactory::ShareCandidateIDs),
+  // candidates from unrelated factories must not be compared by identifier;
+  // ROOT reference identifiers are assigned by TreeWriter to written objects only
+
+  UInt_t GetCandidateID() const { return fCandidateID; }
+  DelphesFactory *GetFactory() const { return fFactory; }
+
+  // jet substructure, track covariance and cluster timing blocks,
+  // Get returns default values if the block was never set
+
+  const CandidateSubstructure &GetSubstructure() const;
+  CandidateSubstructure &EditSubstructure();
+
+  const TMatrixDSym &GetTrackCovariance() const;
+  void SetTrackCovariance(const TMatrixDSym &covariance);
+
+  const std::vector<std::pair<Float_t, Float_t> > &GetECalEnergyTimePairs() const;
+  void AddECalEnergyTimePair(Float_t energy, Float_t time);
+
   virtual void Copy(TObject &object) const;
   virtual TObject *Clone(const char *newname = "") const;
   virtual void Clear(Option_t *option = "");
@@ -841,9 +933,19 @@ private:
   DelphesFactory *fFactory; //!
   TObjArray *fArray; //!
 
+  UInt_t fCandidateID; //!
+
+  CandidateSubstructure *fSubstructure; //!
+  CandidateTrackCovariance *fTrackCovariance; //!
+  CandidateTiming *fTiming; //!
+
+  template <typename T>
+  T *EditBlock(T *&block);
+
   void SetFactory(DelphesFactory *factory) { fFactory = factory; }
+  void SetCandidateID(UInt_t id) { fCandidateID = id; }
 
-  ClassDef(Candidate, 6)
+  ClassDef(Candidate, 7)
 };
 
 #endif // DelphesClasses_h
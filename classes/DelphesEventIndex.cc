@@ -0,0 +1,358 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesEventIndex
+ *
+ *  Event -> byte offset index of HepMC and LHEF input files.
+ *
+ */
+
+#include "classes/DelphesEventIndex.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "classes/DelphesXDRReader.h"
+#include "classes/DelphesXDRWriter.h"
+
+using namespace std;
+
+static const int kChunkSize = 1048576;
+static const int kBufferSize = 16384;
+static const int kHeadSize = 8;
+
+static const int32_t kIndexMagic = 0x44494458;
+static const int32_t kIndexVersion = 1;
+static const int64_t kHeaderSize = 28;
+static const int64_t kRecordSize = 12;
+
+//------------------------------------------------------------------------------
+
+DelphesEventIndex::DelphesEventIndex(Format format) :
+  fFormat(format), fInEvent(false), fInfoLine(false)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventIndex::Clear()
+{
+  fInEvent = false;
+  fInfoLine = false;
+  fOffsets.clear();
+  fParticles.clear();
+}
+
+//------------------------------------------------------------------------------
+
+bool DelphesEventIndex::IsBoundary(const char *line) const
+{
+  while(*line == ' ' || *line == '\t') ++line;
+
+  switch(fFormat)
+  {
+    case kHepMC:
+      return line[0] == 'E' && (line[1] == '\0' || isspace(line[1]));
+    case kLHEF:
+      return strncmp(line, "<event", 6) == 0 && (line[6] == '>' || isspace(line[6]));
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventIndex::AddLine(const char *line, int64_t offset)
+{
+  if(IsBoundary(line))
+  {
+    fOffsets.push_back(offset);
+    fParticles.push_back(0);
+    fInEvent = true;
+    fInfoLine = true;
+    return;
+  }
+
+  if(!fInEvent) return;
+
+  switch(fFormat)
+  {
+    case kHepMC:
+      if(line[0] == 'P' && (line[1] == '\0' || isspace(line[1]))) ++fParticles.back();
+      break;
+    case kLHEF:
+      if(strncmp(line, "</event", 7) == 0)
+      {
+        fInEvent = false;
+      }
+      else if(isdigit(line[0]) || line[0] == '-' || line[0] == '+')
+      {
+        // the first numeric line of an event block is the event information
+        if(fInfoLine)
+          fInfoLine = false;
+        else
+          ++fParticles.back();
+      }
+      break;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesEventIndex::Build(FILE *file)
+{
+  vector<char> chunk(kChunkSize);
+  char head[kHeadSize + 1];
+  const char *begin, *end, *current, *newline;
+  int headSize;
+  bool headDone;
+  size_t size;
+  int64_t position, lineOffset;
+
+  Clear();
+
+  fseeko(file, 0, SEEK_SET);
+
+  position = 0;
+  lineOffset = 0;
+  headSize = 0;
+  headDone = false;
+
+  // only the first characters of each line are looked at, the rest of the
+  // line is skipped with memchr
+  while((size = fread(&chunk[0], 1, kChunkSize, file)) > 0)
+  {
+    begin = &chunk[0];
+    end = begin + size;
+    current = begin;
+
+    while(current < end)
+    {
+      if(!headDone)
+      {
+        while(current < end && *current != '\n' && headSize < kHeadSize)
+        {
+          if(headSize > 0 || (*current != ' ' && *current != '\t')) head[headSize++] = *current;
+          ++current;
+        }
+
+        // the beginning of the line continues in the next chunk
+        if(current == end && headSize < kHeadSize) break;
+
+        head[headSize] = '\0';
+        AddLine(head, lineOffset);
+        headDone = true;
+      }
+
+      newline = static_cast<const char *>(memchr(current, '\n', end - current));
+      if(!newline)
+      {
+        current = end;
+        break;
+      }
+
+      current = newline + 1;
+      lineOffset = position + (current - begin);
+      headSize = 0;
+      headDone = false;
+    }
+
+    position += size;
+  }
+
+  // last line without end of line character
+  if(!headDone && headSize > 0)
+  {
+    head[headSize] = '\0';
+    AddLine(head, lineOffset);
+  }
+
+  clearerr(file);
+  fseeko(file, 0, SEEK_SET);
+}
+
+//------------------------------------------------------------------------------
+
+int64_t DelphesEventIndex::FindEntry(int64_t offset) const
+{
+  return lower_bound(fOffsets.begin(), fOffsets.end(), offset) - fOffsets.begin();
+}
+
+//------------------------------------------------------------------------------
+
+int64_t DelphesEventIndex::FindBoundary(FILE *file, int64_t offset) const
+{
+  char buffer[kBufferSize];
+  int64_t lineOffset;
+  bool lineStart;
+  size_t length;
+
+  lineStart = true;
+
+  // offset may point in the middle of a line
+  if(offset > 0)
+  {
+    fseeko(file, offset - 1, SEEK_SET);
+    lineStart = (fgetc(file) == '\n');
+  }
+  else
+  {
+    fseeko(file, 0, SEEK_SET);
+  }
+
+  while(true)
+  {
+    lineOffset = ftello(file);
+    if(!fgets(buffer, kBufferSize, file)) break;
+
+    if(lineStart && IsBoundary(buffer)) return lineOffset;
+
+    // lines longer than the buffer are read in several pieces
+    length = strlen(buffer);
+    lineStart = (length > 0 && buffer[length - 1] == '\n');
+  }
+
+  clearerr(file);
+
+  return lineOffset;
+}
+
+//------------------------------------------------------------------------------
+
+bool DelphesEventIndex::Read(const char *fileName, int64_t inputSize)
+{
+  FILE *indexFile;
+  DelphesXDRReader reader;
+  int32_t magic, version, format;
+  int64_t size, entries, entry, length;
+
+  Clear();
+
+  indexFile = fopen(fileName, "rb");
+  if(!indexFile) return false;
+
+  fseeko(indexFile, 0, SEEK_END);
+  length = ftello(indexFile);
+  fseeko(indexFile, 0, SEEK_SET);
+
+  if(length < kHeaderSize)
+  {
+    fclose(indexFile);
+    return false;
+  }
+
+  reader.SetFile(indexFile);
+
+  reader.ReadValue(&magic, 4);
+  reader.ReadValue(&version, 4);
+  reader.ReadValue(&format, 4);
+  reader.ReadValue(&size, 8);
+  reader.ReadValue(&entries, 8);
+
+  // ignore stale or foreign index files
+  if(magic != kIndexMagic || version != kIndexVersion || format != fFormat
+    || size != inputSize || entries < 0 || length != kHeaderSize + entries * kRecordSize)
+  {
+    cout << "** WARNING: ignoring event index " << fileName << endl;
+    fclose(indexFile);
+    return false;
+  }
+
+  fOffsets.resize(entries);
+  fParticles.resize(entries);
+
+  for(entry = 0; entry < entries; ++entry)
+  {
+    reader.ReadValue(&fOffsets[entry], 8);
+    reader.ReadValue(&fParticles[entry], 4);
+  }
+
+  if(ferror(indexFile))
+  {
+    fclose(indexFile);
+    Clear();
+    return false;
+  }
+
+  fclose(indexFile);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool DelphesEventIndex::Write(const char *fileName, int64_t inputSize) const
+{
+  FILE *indexFile;
+  DelphesXDRWriter writer;
+  int32_t magic, version, format;
+  int64_t size, entries, entry;
+  bool success;
+
+  indexFile = fopen(fileName, "wb");
+  if(!indexFile)
+  {
+    cout << "** WARNING: can't create event index " << fileName << endl;
+    return false;
+  }
+
+  magic = kIndexMagic;
+  version = kIndexVersion;
+  format = fFormat;
+  size = inputSize;
+  entries = fOffsets.size();
+
+  writer.SetFile(indexFile);
+
+  writer.WriteValue(&magic, 4);
+  writer.WriteValue(&version, 4);
+  writer.WriteValue(&format, 4);
+  writer.WriteValue(&size, 8);
+  writer.WriteValue(&entries, 8);
+
+  for(entry = 0; entry < entries; ++entry)
+  {
+    writer.WriteValue(const_cast<int64_t *>(&fOffsets[entry]), 8);
+    writer.WriteValue(const_cast<int32_t *>(&fParticles[entry]), 4);
+  }
+
+  success = !ferror(indexFile);
+  success = (fclose(indexFile) == 0) && success;
+
+  if(!success)
+  {
+    cout << "** WARNING: can't write event index " << fileName << endl;
+    remove(fileName);
+  }
+
+  return success;
+}
+
+//------------------------------------------------------------------------------
+
+string DelphesEventIndex::GetIndexName(const char *fileName)
+{
+  return string(fileName) + ".idx";
+}
+
+//------------------------------------------------------------------------------
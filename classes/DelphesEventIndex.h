@@ -0,0 +1,83 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesEventIndex_h
+#define DelphesEventIndex_h
+
+/** \class DelphesEventIndex
+ *
+ *  Event -> byte offset index of HepMC and LHEF input files.
+ *
+ *  The index is built by a line scan that only looks for event boundaries
+ *  and is stored in a sidecar file (input file name + ".idx") written in XDR,
+ *  together with the number of particle lines found in each event.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+class DelphesEventIndex
+{
+public:
+  enum Format
+  {
+    kHepMC, // HepMC2 and HepMC3 ASCII, events start with an "E" line
+    kLHEF // Les Houches Event File, events start with an "<event>" line
+  };
+
+  DelphesEventIndex(Format format);
+
+  // scan the input file for event boundaries
+  void Build(FILE *file);
+
+  // sidecar file, only read back when it matches the input file size
+  bool Read(const char *fileName, int64_t inputSize);
+  bool Write(const char *fileName, int64_t inputSize) const;
+
+  void Clear();
+
+  int64_t GetEntries() const { return fOffsets.size(); }
+  int64_t GetOffset(int64_t entry) const { return fOffsets[entry]; }
+  int32_t GetParticles(int64_t entry) const { return fParticles[entry]; }
+
+  // first event starting at or after offset, GetEntries() if none
+  int64_t FindEntry(int64_t offset) const;
+
+  // resynchronise without index: offset of the first event boundary at or
+  // after offset, end of file if none
+  int64_t FindBoundary(FILE *file, int64_t offset) const;
+
+  static std::string GetIndexName(const char *fileName);
+
+private:
+  bool IsBoundary(const char *line) const;
+  void AddLine(const char *line, int64_t offset);
+
+  Format fFormat;
+
+  bool fInEvent, fInfoLine;
+
+  std::vector<int64_t> fOffsets;
+  std::vector<int32_t> fParticles;
+};
+
+#endif // DelphesEventIndex_h
@@ -33,12 +33,15 @@
 #include "TClass.h"
 #include "TObjArray.h"
 
+#include <iostream>
+
 using namespace std;
 
 //------------------------------------------------------------------------------
 
 DelphesFactory::DelphesFactory(const char *name) :
-  TNamed(name, ""), fObjArrays(0)
+  TNamed(name, ""), fObjArrays(0), fMutex(0), fThreadSafe(0), fCandidateCount(0),
+  fCandidateSequence(&fCandidateCount), fWindow(100), fPeakBytes(0)
 {
   fObjArrays = new ExRootTreeBranch("PermanentObjArrays", TObjArray::Class(), 0);
 }
@@ -48,6 +51,7 @@ DelphesFactory::DelphesFactory(const char *name) :
 DelphesFactory::~DelphesFactory()
 {
   if(fObjArrays) delete fObjArrays;
+  if(fMutex) delete fMutex;
 
   map<const TClass *, ExRootTreeBranch *>::iterator itBranches;
   for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
@@ -60,13 +64,18 @@ DelphesFactory::~DelphesFactory()
 
 void DelphesFactory::Clear(Option_t *option)
 {
+  Long64_t bytes = GetBytes();
+  if(bytes > fPeakBytes) fPeakBytes = bytes;
+
   set<TObject *>::iterator itPool;
   for(itPool = fPool.begin(); itPool != fPool.end(); ++itPool)
   {
     (*itPool)->Clear();
   }
 
+  // reference identifiers are assigned by TreeWriter to written objects only
   TProcessID::SetObjectCount(0);
+  fCandidateCount = 0;
 
   map<const TClass *, ExRootTreeBranch *>::iterator itBranches;
   for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
@@ -77,8 +86,26 @@ void DelphesFactory::Clear(Option_t *option)
 
 //------------------------------------------------------------------------------
 
+void DelphesFactory::SetThreadSafe(Bool_t flag)
+{
+  if(flag)
+  {
+    if(fThreadSafe++ == 0) fMutex = new mutex;
+  }
+  else if(fThreadSafe > 0 && --fThreadSafe == 0)
+  {
+    delete fMutex;
+    fMutex = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
 TObjArray *DelphesFactory::NewPermanentArray()
 {
+  unique_lock<mutex> lock;
+  if(fMutex) lock = unique_lock<mutex>(*fMutex);
+
   TObjArray *array = static_cast<TObjArray *>(fObjArrays->NewEntry());
   fPool.insert(array);
   return array;
@@ -86,17 +113,48 @@ TObjArray *DelphesFactory::NewPermanentArray()
 
 //------------------------------------------------------------------------------
 
+TObjArray *DelphesFactory::AllocateArray(TObjArray *&array)
+{
+  unique_lock<mutex> lock;
+  if(fMutex) lock = unique_lock<mutex>(*fMutex);
+
+  if(!array) array = static_cast<TObjArray *>(NewEntry(TObjArray::Class()));
+  return array;
+}
+
+//------------------------------------------------------------------------------
+
 Candidate *DelphesFactory::NewCandidate()
 {
-  Candidate *object = New<Candidate>();
+  unique_lock<mutex> lock;
+  if(fMutex) lock = unique_lock<mutex>(*fMutex);
+
+  Candidate *object = static_cast<Candidate *>(NewEntry(Candidate::Class()));
   object->SetFactory(this);
-  TProcessID::AssignID(object);
+  object->SetCandidateID(fCandidateSequence->fetch_add(1, memory_order_relaxed));
   return object;
 }
 
 //------------------------------------------------------------------------------
 
+void DelphesFactory::ShareCandidateIDs(DelphesFactory *factory)
+{
+  fCandidateSequence = factory->fCandidateSequence;
+}
+
+//------------------------------------------------------------------------------
+
 TObject *DelphesFactory::New(TClass *cl)
+{
+  unique_lock<mutex> lock;
+  if(fMutex) lock = unique_lock<mutex>(*fMutex);
+
+  return NewEntry(cl);
+}
+
+//------------------------------------------------------------------------------
+
+TObject *DelphesFactory::NewEntry(TClass *cl)
 {
   TObject *object = 0;
   ExRootTreeBranch *branch = 0;
@@ -109,6 +167,7 @@ TObject *DelphesFactory::New(TClass *cl)
   else
   {
     branch = new ExRootTreeBranch(cl->GetName(), cl, 0);
+    branch->SetWindow(fWindow);
     fBranches.insert(make_pair(cl, branch));
   }
 
@@ -118,3 +177,64 @@ TObject *DelphesFactory::New(TClass *cl)
 }
 
 //------------------------------------------------------------------------------
+
+void DelphesFactory::SetWindow(Int_t events)
+{
+  fWindow = events;
+
+  map<const TClass *, ExRootTreeBranch *>::iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    itBranches->second->SetWindow(fWindow);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesFactory::Trim()
+{
+  Long64_t bytes = 0;
+
+  // permanent arrays live for the whole job and are not trimmed
+  map<const TClass *, ExRootTreeBranch *>::iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    bytes += itBranches->second->Trim();
+  }
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesFactory::GetBytes() const
+{
+  Long64_t bytes = fObjArrays->GetBytes();
+
+  map<const TClass *, ExRootTreeBranch *>::const_iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    bytes += itBranches->second->GetBytes();
+  }
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesFactory::PrintMemory() const
+{
+  ExRootTreeBranch::PrintMemoryHeader();
+  fObjArrays->PrintMemory();
+
+  map<const TClass *, ExRootTreeBranch *>::const_iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    itBranches->second->PrintMemory();
+  }
+
+  cout << "** " << GetName() << ": " << GetBytes() / 1048576.0 << " MB allocated, ";
+  cout << fPeakBytes / 1048576.0 << " MB peak" << endl;
+}
+
+//------------------------------------------------------------------------------
@@ -33,6 +33,11 @@
 #include <map>
 #include <set>
 
+#if !defined(__CINT__) && !defined(__CLING__)
+#include <atomic>
+#include <mutex>
+#endif
+
 class TObjArray;
 class Candidate;
 
@@ -46,26 +51,58 @@ public:
 
   virtual void Clear(Option_t *option = "");
 
+  // serialise allocations when modules run concurrently, the requests
+  // are counted and allocations stay serialised until all are withdrawn
+  void SetThreadSafe(Bool_t flag);
+
   TObjArray *NewPermanentArray();
 
   TObjArray *NewArray() { return New<TObjArray>(); }
 
+  // allocate array if it is still null and return it
+  TObjArray *AllocateArray(TObjArray *&array);
+
   Candidate *NewCandidate();
 
+  // take candidate identifiers from the sequence of another factory,
+  // so that they stay unique among the candidates of both factories;
+  // the sequence is restarted when the other factory is cleared
+  void ShareCandidateIDs(DelphesFactory *factory);
+
   TObject *New(TClass *cl);
 
   template <typename T>
   T *New() { return static_cast<T *>(New(T::Class())); }
 
+  // memory accounting of the object pools
+  void SetWindow(Int_t events);
+  Long64_t Trim();
+
+  Long64_t GetBytes() const;
+  Long64_t GetPeakBytes() const { return fPeakBytes; }
+
+  void PrintMemory() const;
+
 private:
+  TObject *NewEntry(TClass *cl);
+
   ExRootTreeBranch *fObjArrays; //!
 
 #if !defined(__CINT__) && !defined(__CLING__)
   std::map<const TClass *, ExRootTreeBranch *> fBranches; //!
+
+  std::mutex *fMutex; //!
+  Int_t fThreadSafe; //!
+
+  std::atomic<UInt_t> fCandidateCount; //!
+  std::atomic<UInt_t> *fCandidateSequence; //!
 #endif
 
   std::set<TObject *> fPool; //!
 
+  Int_t fWindow; //!
+  Long64_t fPeakBytes; //!
+
   ClassDef(DelphesFactory, 1)
 };
 
@@ -0,0 +1,300 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesLookupTable
+ *
+ *  Flat copy of a two-dimensional histogram (e.g. resolution map)
+ *  with direct bin index arithmetic for uniform and logarithmic axes
+ *  and optional bilinear interpolation between bin centers.
+ *
+ */
+
+#include "classes/DelphesLookupTable.h"
+
+#include "TAxis.h"
+#include "TH2.h"
+#include "TMath.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+void DelphesLookupTable::Axis::Load(const TAxis *axis)
+{
+  Int_t i;
+  Double_t width, tolerance;
+  Bool_t uniform, logarithmic;
+
+  fNBins = axis->GetNbins();
+  if(fNBins < 1)
+  {
+    throw runtime_error("histogram axis without bins");
+  }
+
+  fEdges.resize(fNBins + 1);
+  for(i = 0; i < fNBins; ++i)
+  {
+    fEdges[i] = axis->GetBinLowEdge(i + 1);
+  }
+  fEdges[fNBins] = axis->GetXmax();
+
+  fMin = fEdges[0];
+  fMax = fEdges[fNBins];
+
+  width = (fMax - fMin) / fNBins;
+  tolerance = 1.0E-9 * (fMax - fMin);
+  uniform = kTRUE;
+  for(i = 1; i < fNBins && uniform; ++i)
+  {
+    uniform = TMath::Abs(fEdges[i] - (fMin + i * width)) <= tolerance;
+  }
+
+  logarithmic = !uniform && fMin > 0.0;
+  if(logarithmic)
+  {
+    width = (TMath::Log(fMax) - TMath::Log(fMin)) / fNBins;
+    tolerance = 1.0E-9 * (TMath::Log(fMax) - TMath::Log(fMin));
+    for(i = 1; i < fNBins && logarithmic; ++i)
+    {
+      logarithmic = TMath::Abs(TMath::Log(fEdges[i]) - (TMath::Log(fMin) + i * width)) <= tolerance;
+    }
+  }
+
+  if(uniform)
+  {
+    fMode = kUniform;
+    fOffset = fMin;
+    fScale = fNBins / (fMax - fMin);
+  }
+  else if(logarithmic)
+  {
+    fMode = kLogarithmic;
+    fOffset = TMath::Log(fMin);
+    fScale = fNBins / (TMath::Log(fMax) - TMath::Log(fMin));
+  }
+  else
+  {
+    fMode = kVariable;
+    fOffset = 0.0;
+    fScale = 0.0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesLookupTable::Axis::operator==(const Axis &axis) const
+{
+  return fNBins == axis.fNBins && fMode == axis.fMode && fEdges == axis.fEdges;
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesLookupTable::Axis::FindBin(Double_t value) const
+{
+  Int_t bin;
+
+  // also rejects NaN
+  if(!(value >= fMin)) return -1;
+  if(value >= fMax) return fNBins;
+
+  switch(fMode)
+  {
+    case kUniform:
+      bin = Int_t((value - fOffset) * fScale);
+      break;
+    case kLogarithmic:
+      bin = Int_t((TMath::Log(value) - fOffset) * fScale);
+      break;
+    default:
+      return upper_bound(fEdges.begin(), fEdges.end(), value) - fEdges.begin() - 1;
+  }
+
+  // correct for rounding at the bin edges
+  if(bin >= fNBins) bin = fNBins - 1;
+  if(value < fEdges[bin])
+    --bin;
+  else if(value >= fEdges[bin + 1])
+    ++bin;
+
+  return bin;
+}
+
+//------------------------------------------------------------------------------
+
+Double_t DelphesLookupTable::Axis::GetBinCenter(Int_t bin) const
+{
+  if(fMode == kLogarithmic)
+  {
+    return 0.5 * (TMath::Log(fEdges[bin]) + TMath::Log(fEdges[bin + 1]));
+  }
+  return 0.5 * (fEdges[bin] + fEdges[bin + 1]);
+}
+
+//------------------------------------------------------------------------------
+
+DelphesLookupTable::DelphesLookupTable() :
+  fInterpolate(kFALSE)
+{
+}
+
+//------------------------------------------------------------------------------
+
+DelphesLookupTable::DelphesLookupTable(const TH2 *hist, Bool_t interpolate) :
+  fInterpolate(interpolate)
+{
+  Load(hist);
+}
+
+//------------------------------------------------------------------------------
+
+DelphesLookupTable::~DelphesLookupTable()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesLookupTable::Load(const TH2 *hist)
+{
+  Int_t ix, iy, nx, ny;
+
+  if(!hist)
+  {
+    throw runtime_error("can't create lookup table from null histogram");
+  }
+
+  fAxisX.Load(hist->GetXaxis());
+  fAxisY.Load(hist->GetYaxis());
+
+  nx = fAxisX.fNBins;
+  ny = fAxisY.fNBins;
+
+  // GetBinContent is virtual and returns bin means for TProfile2D
+  fContent.resize(nx * ny);
+  for(iy = 0; iy < ny; ++iy)
+  {
+    for(ix = 0; ix < nx; ++ix)
+    {
+      fContent[iy * nx + ix] = hist->GetBinContent(ix + 1, iy + 1);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesLookupTable::HasSameBinning(const DelphesLookupTable &table) const
+{
+  return fAxisX == table.fAxisX && fAxisY == table.fAxisY;
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesLookupTable::FindBin(Double_t x, Double_t y) const
+{
+  Int_t ix, iy;
+
+  ix = fAxisX.FindBin(x);
+  if(ix < 0) return -1;
+  if(ix >= fAxisX.fNBins) ix = fAxisX.fNBins - 1;
+
+  iy = fAxisY.FindBin(y);
+  if(iy < 0 || iy >= fAxisY.fNBins) return -1;
+
+  return iy * fAxisX.fNBins + ix;
+}
+
+//------------------------------------------------------------------------------
+
+Double_t DelphesLookupTable::Eval(Double_t x, Double_t y) const
+{
+  return fInterpolate ? Interpolate(x, y) : GetBinContent(FindBin(x, y));
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesLookupTable::Eval(Int_t size, const Double_t *x, const Double_t *y, Double_t *result) const
+{
+  Int_t i;
+
+  if(fInterpolate)
+  {
+    for(i = 0; i < size; ++i) result[i] = Interpolate(x[i], y[i]);
+  }
+  else
+  {
+    for(i = 0; i < size; ++i) result[i] = GetBinContent(FindBin(x[i], y[i]));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Double_t DelphesLookupTable::Interpolate(Double_t x, Double_t y) const
+{
+  Int_t bin, ix, iy, ix1, ix2, iy1, iy2, nx;
+  Double_t u, v, wx, wy, c11, c12, c21, c22;
+
+  bin = FindBin(x, y);
+  if(bin < 0) return 0.0;
+
+  nx = fAxisX.fNBins;
+  ix = bin % nx;
+  iy = bin / nx;
+
+  // interpolation is done in log(x) for logarithmic axes
+  u = (fAxisX.fMode == Axis::kLogarithmic) ? TMath::Log(x) : x;
+  v = y;
+
+  ix1 = (u < fAxisX.GetBinCenter(ix)) ? ix - 1 : ix;
+  ix2 = ix1 + 1;
+  if(ix1 < 0 || ix2 >= nx)
+  {
+    ix1 = ix2 = ix;
+    wx = 0.0;
+  }
+  else
+  {
+    wx = (u - fAxisX.GetBinCenter(ix1)) / (fAxisX.GetBinCenter(ix2) - fAxisX.GetBinCenter(ix1));
+    wx = TMath::Min(TMath::Max(wx, 0.0), 1.0);
+  }
+
+  iy1 = (v < fAxisY.GetBinCenter(iy)) ? iy - 1 : iy;
+  iy2 = iy1 + 1;
+  if(iy1 < 0 || iy2 >= fAxisY.fNBins)
+  {
+    iy1 = iy2 = iy;
+    wy = 0.0;
+  }
+  else
+  {
+    wy = (v - fAxisY.GetBinCenter(iy1)) / (fAxisY.GetBinCenter(iy2) - fAxisY.GetBinCenter(iy1));
+  }
+
+  c11 = fContent[iy1 * nx + ix1];
+  c12 = fContent[iy2 * nx + ix1];
+  c21 = fContent[iy1 * nx + ix2];
+  c22 = fContent[iy2 * nx + ix2];
+
+  // empty bins mean "no resolution available", do not mix them in
+  if(c11 == 0.0 || c12 == 0.0 || c21 == 0.0 || c22 == 0.0) return fContent[bin];
+
+  return (1.0 - wy) * ((1.0 - wx) * c11 + wx * c21) + wy * ((1.0 - wx) * c12 + wx * c22);
+}
+
+//------------------------------------------------------------------------------
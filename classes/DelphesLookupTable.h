@@ -0,0 +1,96 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesLookupTable_h
+#define DelphesLookupTable_h
+
+/** \class DelphesLookupTable
+ *
+ *  Flat copy of a two-dimensional histogram (e.g. resolution map)
+ *  with direct bin index arithmetic for uniform and logarithmic axes
+ *  and optional bilinear interpolation between bin centers.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <vector>
+
+class TAxis;
+class TH2;
+
+class DelphesLookupTable
+{
+public:
+  DelphesLookupTable();
+
+  DelphesLookupTable(const TH2 *hist, Bool_t interpolate = kFALSE);
+
+  ~DelphesLookupTable();
+
+  void Load(const TH2 *hist);
+
+  void SetInterpolate(Bool_t interpolate) { fInterpolate = interpolate; }
+
+  Bool_t HasSameBinning(const DelphesLookupTable &table) const;
+
+  // returns flat bin index or -1 if (x, y) is outside of the table,
+  // x values above the upper edge are assigned to the last bin
+  Int_t FindBin(Double_t x, Double_t y) const;
+
+  Double_t GetBinContent(Int_t bin) const { return bin < 0 ? 0.0 : fContent[bin]; }
+
+  Double_t Eval(Double_t x, Double_t y) const;
+
+  void Eval(Int_t size, const Double_t *x, const Double_t *y, Double_t *result) const;
+
+private:
+  class Axis
+  {
+  public:
+    enum EMode
+    {
+      kUniform,
+      kLogarithmic,
+      kVariable
+    };
+
+    void Load(const TAxis *axis);
+
+    Bool_t operator==(const Axis &axis) const;
+
+    Int_t FindBin(Double_t value) const;
+
+    Double_t GetBinCenter(Int_t bin) const;
+
+    Int_t fNBins;
+    EMode fMode;
+    Double_t fMin, fMax, fOffset, fScale;
+    std::vector<Double_t> fEdges;
+  };
+
+  Double_t Interpolate(Double_t x, Double_t y) const;
+
+  Axis fAxisX, fAxisY;
+
+  std::vector<Double_t> fContent;
+
+  Bool_t fInterpolate;
+};
+
+#endif /* DelphesLookupTable_h */
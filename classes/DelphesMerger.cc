@@ -0,0 +1,334 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesMerger
+ *
+ *  Concatenates the Delphes trees of several output files.
+ *
+ */
+
+#include "classes/DelphesMerger.h"
+
+#include "TBranch.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TParameter.h"
+#include "TProcessID.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include "TTreeCloner.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DelphesMerger::DelphesMerger(const char *treeName) :
+  fTreeName(treeName), fNumberOfThreads(1), fFastFiles(0), fSlowFiles(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesMerger::Merge(TFile *outputFile)
+{
+  vector<vector<TString> > groups;
+  vector<TString> parts;
+  vector<TString>::iterator itParts;
+  vector<thread> threads;
+  vector<thread>::iterator itThreads;
+  vector<exception_ptr> exceptions;
+  vector<exception_ptr>::iterator itExceptions;
+  TString partName;
+  Int_t i, size, numberOfGroups;
+  Long64_t entries;
+
+  size = fFiles.size();
+  if(size == 0)
+  {
+    throw runtime_error("no input files to merge");
+  }
+
+  fFastFiles = 0;
+  fSlowFiles = 0;
+
+  // the groups are copied once more at the end,
+  // which only pays off with a few files in each of them
+  numberOfGroups = TMath::Min(fNumberOfThreads, size / 2);
+
+  if(numberOfGroups <= 1) return MergeFiles(fFiles, outputFile, kTRUE);
+
+  ROOT::EnableThreadSafety();
+
+  for(i = 0; i < numberOfGroups; ++i)
+  {
+    groups.push_back(vector<TString>(fFiles.begin() + size * i / numberOfGroups, fFiles.begin() + size * (i + 1) / numberOfGroups));
+
+    partName = outputFile->GetName();
+    if(partName.EndsWith(".root")) partName.Remove(partName.Length() - 5);
+    partName += Form("_part%d.root", i);
+    parts.push_back(partName);
+  }
+
+  exceptions.resize(numberOfGroups);
+
+  for(i = 0; i < numberOfGroups; ++i)
+  {
+    threads.push_back(thread(&DelphesMerger::MergeGroup, this, cref(groups[i]), cref(parts[i]),
+      outputFile->GetCompressionSettings(), ref(exceptions[i])));
+  }
+
+  for(itThreads = threads.begin(); itThreads != threads.end(); ++itThreads)
+  {
+    itThreads->join();
+  }
+
+  for(itExceptions = exceptions.begin(); itExceptions != exceptions.end(); ++itExceptions)
+  {
+    if(!*itExceptions) continue;
+    for(itParts = parts.begin(); itParts != parts.end(); ++itParts)
+    {
+      unlink(*itParts);
+    }
+    rethrow_exception(*itExceptions);
+  }
+
+  entries = MergeFiles(parts, outputFile, kFALSE);
+
+  for(itParts = parts.begin(); itParts != parts.end(); ++itParts)
+  {
+    unlink(*itParts);
+  }
+
+  return entries;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesMerger::MergeGroup(const vector<TString> &files, const TString &outputName, Int_t compression, exception_ptr &exception)
+{
+  stringstream message;
+  TFile *outputFile = 0;
+
+  try
+  {
+    outputFile = TFile::Open(outputName, "RECREATE");
+    if(!outputFile)
+    {
+      message << "can't create output file " << outputName;
+      throw runtime_error(message.str());
+    }
+
+    // same compression as the final output for the baskets written again
+    outputFile->SetCompressionSettings(compression);
+
+    MergeFiles(files, outputFile, kTRUE);
+
+    outputFile->Close();
+  }
+  catch(...)
+  {
+    exception = current_exception();
+  }
+
+  if(outputFile) delete outputFile;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t DelphesMerger::MergeFiles(const vector<TString> &files, TFile *outputFile, Bool_t count)
+{
+  stringstream message;
+  vector<TString>::const_iterator itFiles;
+  TDirectory *directory = gDirectory;
+  TFile *inputFile;
+  TObject *object;
+  TTree *inputTree, *outputTree = 0;
+  Bool_t fast;
+
+  for(itFiles = files.begin(); itFiles != files.end(); ++itFiles)
+  {
+    inputFile = TFile::Open(*itFiles);
+    if(!inputFile || inputFile->IsZombie())
+    {
+      if(inputFile) delete inputFile;
+      message << "can't open " << *itFiles;
+      throw runtime_error(message.str());
+    }
+
+    object = inputFile->Get(fTreeName);
+    if(!object || !object->InheritsFrom(TTree::Class()))
+    {
+      delete inputFile;
+      message << "can't find tree " << fTreeName << " in " << *itFiles;
+      throw runtime_error(message.str());
+    }
+
+    inputTree = static_cast<TTree *>(object);
+
+    if(!outputTree)
+    {
+      outputFile->cd();
+      outputTree = inputTree->CloneTree(0);
+      outputTree->SetDirectory(outputFile);
+
+      // detach the output tree from the input, which is deleted below
+      inputTree->GetListOfClones()->Remove(outputTree);
+      inputTree->ResetBranchAddresses();
+      outputTree->ResetBranchAddresses();
+
+      outputTree->GetUserInfo()->Delete();
+    }
+    else
+    {
+      CheckBranches(outputTree, inputTree, *itFiles);
+    }
+
+    MergeInfo(outputTree->GetUserInfo(), inputTree->GetUserInfo());
+
+    if(inputTree->GetEntries() > 0)
+    {
+      fast = kFALSE;
+
+      if(!HasProcessIDs(outputFile, inputFile))
+      {
+        TTreeCloner cloner(inputTree, outputTree, "fast", TTreeCloner::kNoWarnings);
+        if(cloner.IsValid())
+        {
+          outputTree->SetEntries(outputTree->GetEntries() + inputTree->GetEntries());
+          if(!cloner.Exec())
+          {
+            delete inputFile;
+            message << "can't copy the baskets of " << *itFiles;
+            throw runtime_error(message.str());
+          }
+          fast = kTRUE;
+        }
+        else
+        {
+          cout << "** WARNING: " << *itFiles << ": " << cloner.GetWarning() << endl;
+        }
+      }
+
+      if(!fast)
+      {
+        outputTree->CopyAddresses(inputTree);
+        outputTree->CopyEntries(inputTree, -1, "");
+        outputTree->CopyAddresses(inputTree, kTRUE);
+      }
+
+      if(count)
+      {
+        lock_guard<mutex> lock(fMutex);
+        if(fast)
+          ++fFastFiles;
+        else
+          ++fSlowFiles;
+      }
+    }
+
+    delete inputFile;
+  }
+
+  outputFile->cd();
+  outputTree->Write("", TObject::kOverwrite);
+  directory->cd();
+
+  return outputTree->GetEntries();
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesMerger::CheckBranches(TTree *outputTree, TTree *inputTree, const char *fileName)
+{
+  stringstream message;
+  TIter itBranches(outputTree->GetListOfBranches());
+  TBranch *outputBranch, *inputBranch;
+
+  if(outputTree->GetListOfBranches()->GetEntriesFast() != inputTree->GetListOfBranches()->GetEntriesFast())
+  {
+    message << "branches of " << fileName << " differ from the first input file";
+    throw runtime_error(message.str());
+  }
+
+  while((outputBranch = static_cast<TBranch *>(itBranches.Next())))
+  {
+    inputBranch = inputTree->GetBranch(outputBranch->GetName());
+    if(!inputBranch || strcmp(inputBranch->GetClassName(), outputBranch->GetClassName()) != 0)
+    {
+      message << "branch " << outputBranch->GetName() << " of " << fileName << " differs from the first input file";
+      throw runtime_error(message.str());
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t DelphesMerger::HasProcessIDs(TFile *outputFile, TFile *inputFile)
+{
+  TObjArray *processes = outputFile->GetListOfProcessIDs();
+  TProcessID *process;
+  Int_t i;
+
+  // the basket offsets of the fast copy assume that the TProcessIDs
+  // of the input file are appended after the ones already written
+  for(i = 0; processes && i < inputFile->GetNProcessIDs(); ++i)
+  {
+    process = inputFile->ReadProcessID(i);
+    if(process && processes->IndexOf(process) >= 0) return kTRUE;
+  }
+
+  return kFALSE;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesMerger::MergeInfo(TList *info, TList *input)
+{
+  TIter itInput(input);
+  TObject *object;
+  TParameter<Double_t> *parameter, *merged;
+
+  while((object = itInput.Next()))
+  {
+    parameter = dynamic_cast<TParameter<Double_t> *>(object);
+    merged = dynamic_cast<TParameter<Double_t> *>(info->FindObject(object->GetName()));
+
+    if(!merged)
+    {
+      if(!info->FindObject(object->GetName())) info->Add(object->Clone());
+    }
+    else if(parameter && strstr(parameter->GetName(), "Peak"))
+    {
+      merged->SetVal(TMath::Max(merged->GetVal(), parameter->GetVal()));
+    }
+    else if(parameter)
+    {
+      merged->SetVal(merged->GetVal() + parameter->GetVal());
+    }
+  }
+}
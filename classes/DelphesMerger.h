@@ -0,0 +1,91 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesMerger_h
+#define DelphesMerger_h
+
+/** \class DelphesMerger
+ *
+ *  Concatenates the Delphes trees of several output files, for example
+ *  the shards written by forked worker processes or by separate jobs.
+ *
+ *  The compressed baskets of a file are copied as they are whenever its
+ *  branch layout allows it, otherwise its entries are read and written
+ *  again. The TProcessID tables of the input files are carried over with
+ *  the baskets, so that TRef and TRefArray members keep pointing to the
+ *  right objects. Files whose TProcessIDs are already in the output
+ *  (shards of a single process or copies of the same file) can not be
+ *  given consistent basket offsets and are always copied entry by entry.
+ *
+ *  With several threads, consecutive groups of files are merged
+ *  concurrently into temporary files, which are then concatenated in
+ *  order, so that the entries keep the order of the input files.
+ *
+ *  Tree user info parameters are summed, except for the peak values,
+ *  for which the maximum is kept.
+ *
+ */
+
+#include "Rtypes.h"
+#include "TString.h"
+
+#include <exception>
+#include <mutex>
+#include <vector>
+
+class TFile;
+class TList;
+class TTree;
+
+class DelphesMerger
+{
+public:
+  DelphesMerger(const char *treeName = "Delphes");
+
+  void SetTreeName(const char *name) { fTreeName = name; }
+  void SetNumberOfThreads(Int_t threads) { fNumberOfThreads = threads; }
+
+  void AddFile(const char *fileName) { fFiles.push_back(fileName); }
+
+  // returns the number of entries written to the output file
+  Long64_t Merge(TFile *outputFile);
+
+  // input files whose baskets were copied without decompression
+  Int_t GetFastFiles() const { return fFastFiles; }
+  Int_t GetSlowFiles() const { return fSlowFiles; }
+
+private:
+  Long64_t MergeFiles(const std::vector<TString> &files, TFile *outputFile, Bool_t count);
+  void MergeGroup(const std::vector<TString> &files, const TString &outputName, Int_t compression, std::exception_ptr &exception);
+
+  void CheckBranches(TTree *outputTree, TTree *inputTree, const char *fileName);
+  Bool_t HasProcessIDs(TFile *outputFile, TFile *inputFile);
+
+  static void MergeInfo(TList *info, TList *input);
+
+  TString fTreeName;
+  Int_t fNumberOfThreads;
+
+  std::vector<TString> fFiles;
+
+  Int_t fFastFiles, fSlowFiles;
+
+  std::mutex fMutex;
+};
+
+#endif /* DelphesMerger_h */
@@ -27,6 +27,7 @@
 #include "classes/DelphesModule.h"
 
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootResult.h"
 #include "ExRootAnalysis/ExRootTreeBranch.h"
@@ -35,8 +36,10 @@
 
 #include "TClass.h"
 #include "TFolder.h"
+#include "TNamed.h"
 #include "TObjArray.h"
 #include "TROOT.h"
+#include "TString.h"
 
 #include <iostream>
 #include <sstream>
@@ -46,7 +49,9 @@ using namespace std;
 
 DelphesModule::DelphesModule() :
   fTreeWriter(0), fFactory(0), fPlots(0),
-  fPlotFolder(0), fExportFolder(0)
+  fPlotFolder(0), fExportFolder(0),
+  fEventFilter(kFALSE), fEventAccepted(kTRUE),
+  fRandom(0), fEventNumber(0), fInputNumber(0)
 {
 }
 
@@ -54,6 +59,7 @@ DelphesModule::DelphesModule() :
 
 DelphesModule::~DelphesModule()
 {
+  if(fRandom) delete fRandom;
 }
 
 //------------------------------------------------------------------------------
@@ -80,8 +86,19 @@ TObjArray *DelphesModule::ImportArray(const char *name)
 {
   stringstream message;
   TObjArray *object;
+  TObject *alias;
+  TString path = name;
+  Int_t depth;
 
-  object = static_cast<TObjArray *>(GetObject(Form("Export/%s", name), TObjArray::Class()));
+  // follow aliases registered with ExportAlias
+  for(depth = 0; depth < kMaxAliasDepth; ++depth)
+  {
+    alias = GetFolder()->FindObject(Form("Export/%s", path.Data()));
+    if(!alias || alias->IsA() != TNamed::Class()) break;
+    path = alias->GetTitle();
+  }
+
+  object = static_cast<TObjArray *>(GetObject(Form("Export/%s", path.Data()), TObjArray::Class()));
   if(!object)
   {
     message << "can't access input list '" << name;
@@ -89,6 +106,23 @@ TObjArray *DelphesModule::ImportArray(const char *name)
     throw runtime_error(message.str());
   }
 
+  if(object->TestBit(kArrayImported)) object->SetBit(kArrayImportedTwice);
+  object->SetBit(kArrayImported);
+
+  fImportedArrays.push_back(path.Data());
+  fImportedObjects.push_back(object);
+
+  return object;
+}
+
+//------------------------------------------------------------------------------
+
+TObjArray *DelphesModule::UpdateArray(const char *name)
+{
+  TObjArray *object = ImportArray(name);
+
+  fUpdatedArrays.push_back(fImportedArrays.back());
+
   return object;
 }
 
@@ -107,11 +141,60 @@ TObjArray *DelphesModule::ExportArray(const char *name)
   array->SetName(name);
   fExportFolder->Add(array);
 
+  fExportedArrays.push_back(string(GetName()) + "/" + name);
+  fExportedObjects.push_back(array);
+
   return array;
 }
 
 //------------------------------------------------------------------------------
 
+TString DelphesModule::GetTraceArguments() const
+{
+  TString arguments;
+  size_t i;
+
+  arguments = "\"in\":{";
+  for(i = 0; i < fImportedObjects.size(); ++i)
+  {
+    arguments += Form("%s\"%s\":%d", i > 0 ? "," : "", fImportedArrays[i].c_str(), fImportedObjects[i]->GetEntriesFast());
+  }
+
+  arguments += "},\"out\":{";
+  for(i = 0; i < fExportedObjects.size(); ++i)
+  {
+    arguments += Form("%s\"%s\":%d", i > 0 ? "," : "", fExportedArrays[i].c_str(), fExportedObjects[i]->GetEntriesFast());
+  }
+  arguments += "}";
+
+  return arguments;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesModule::ExportAlias(const char *name, const char *source)
+{
+  stringstream message;
+  TObject *object;
+
+  if(!fExportFolder)
+  {
+    fExportFolder = NewFolder("Export");
+  }
+
+  object = GetFolder()->FindObject(Form("Export/%s", source));
+  if(!object)
+  {
+    message << "can't access input list '" << source;
+    message << "' in module '" << GetName() << "'";
+    throw runtime_error(message.str());
+  }
+
+  fExportFolder->Add(new TNamed(name, source));
+}
+
+//------------------------------------------------------------------------------
+
 ExRootTreeBranch *DelphesModule::NewBranch(const char *name, TClass *cl)
 {
   stringstream message;
@@ -172,3 +255,26 @@ DelphesFactory *DelphesModule::GetFactory()
   }
   return fFactory;
 }
+
+//------------------------------------------------------------------------------
+
+DelphesRandom *DelphesModule::NewRandom()
+{
+  Int_t seed = 0;
+  if(GetConfReader()) seed = GetConfReader()->GetInt("::RandomSeed", 0);
+
+  fRandom = new DelphesRandom(seed, GetName());
+  fRandom->SetEvent(fEventNumber, fInputNumber);
+
+  return fRandom;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesModule::SetEventNumber(ULong64_t number, UInt_t input)
+{
+  fEventNumber = number;
+  fInputNumber = input;
+
+  if(fRandom) fRandom->SetEvent(number, input);
+}
@@ -29,6 +29,9 @@
 
 #include "ExRootAnalysis/ExRootTask.h"
 
+#include <string>
+#include <vector>
+
 class TClass;
 class TObject;
 class TFolder;
@@ -39,6 +42,7 @@ class ExRootTreeBranch;
 class ExRootTreeWriter;
 
 class DelphesFactory;
+class DelphesRandom;
 
 class DelphesModule: public ExRootTask
 {
@@ -50,24 +54,91 @@ public:
   virtual void Process();
   virtual void Finish();
 
+  // set by ImportArray on every array read by some module,
+  // producers may skip filling exported arrays nobody reads;
+  // kArrayImportedTwice is set on arrays read by more than one module
+  enum
+  {
+    kArrayImported = BIT(22),
+    kArrayImportedTwice = BIT(23)
+  };
+
+  // imported arrays may be aliases read by other modules as well,
+  // they must not be reordered or resized, sort a copy instead
   TObjArray *ImportArray(const char *name);
   TObjArray *ExportArray(const char *name);
 
+  // import an array whose candidates this module modifies in place
+  TObjArray *UpdateArray(const char *name);
+
+  // export source ("Module/array") under name without copying it;
+  // only whole arrays can be aliased, concatenations, subsets and
+  // filtered selections are still copied by the modules producing them
+  void ExportAlias(const char *name, const char *source);
+
   ExRootTreeBranch *NewBranch(const char *name, TClass *cl);
   void AddInfo(const char *name, Double_t value);
 
   ExRootResult *GetPlots();
   DelphesFactory *GetFactory();
 
+  // random number stream of this module, restarted for every event
+  DelphesRandom *GetRandom() { return fRandom ? fRandom : NewRandom(); }
+
+  void SetEventNumber(ULong64_t number, UInt_t input = 0);
+  ULong64_t GetEventNumber() const { return fEventNumber; }
+  UInt_t GetInputNumber() const { return fInputNumber; }
+
+  // modules able to reject the current event, see Delphes::ProcessTask
+  Bool_t IsEventFilter() const { return fEventFilter; }
+  Bool_t IsEventAccepted() const { return fEventAccepted; }
+
+  // sizes of the imported and exported arrays for timeline spans
+  virtual TString GetTraceArguments() const;
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  // arrays accessed through ImportArray and ExportArray, as "Module/array"
+  const std::vector<std::string> &GetImportedArrays() const { return fImportedArrays; }
+  const std::vector<std::string> &GetExportedArrays() const { return fExportedArrays; }
+
+  // arrays imported with UpdateArray
+  const std::vector<std::string> &GetUpdatedArrays() const { return fUpdatedArrays; }
+#endif
+
 protected:
+  void SetEventFilter(Bool_t flag) { fEventFilter = flag; }
+  void SetEventAccepted(Bool_t flag) { fEventAccepted = flag; }
+
   ExRootTreeWriter *fTreeWriter;
   DelphesFactory *fFactory;
 
 private:
+  enum
+  {
+    kMaxAliasDepth = 16
+  };
+
+  DelphesRandom *NewRandom();
+
   ExRootResult *fPlots;
 
   TFolder *fPlotFolder, *fExportFolder;
 
+  Bool_t fEventFilter, fEventAccepted; //!
+
+  DelphesRandom *fRandom; //!
+  ULong64_t fEventNumber; //!
+  UInt_t fInputNumber; //!
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  std::vector<std::string> fImportedArrays; //!
+  std::vector<std::string> fExportedArrays; //!
+  std::vector<std::string> fUpdatedArrays; //!
+
+  std::vector<TObjArray *> fImportedObjects; //!
+  std::vector<TObjArray *> fExportedObjects; //!
+#endif
+
   ClassDef(DelphesModule, 1)
 };
 
@@ -0,0 +1,205 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesRandom
+ *
+ *  Counter-based random number stream (Philox4x32-10).
+ *
+ *  The key is derived from the random seed and the stream name (one stream
+ *  per module), the counter from the event number, the input number and
+ *  the position of the draw within the event. The numbers drawn by a module
+ *  in a given event therefore do not depend on other modules or on the
+ *  events processed before it.
+ *
+ *  All TRandom distributions are available on top of Rndm.
+ *
+ */
+
+#include "classes/DelphesRandom.h"
+
+#include "TMath.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+static const UInt_t kPhiloxM0 = 0xD2511F53;
+static const UInt_t kPhiloxM1 = 0xCD9E8D57;
+static const UInt_t kPhiloxW0 = 0x9E3779B9;
+static const UInt_t kPhiloxW1 = 0xBB67AE85;
+
+//------------------------------------------------------------------------------
+
+DelphesRandom::DelphesRandom(UInt_t seed, const char *stream) :
+  TRandom(seed), fBufferIndex(2)
+{
+  UInt_t hash = 2166136261U;
+
+  // FNV-1a hash of the stream name
+  while(stream && *stream)
+  {
+    hash ^= UChar_t(*stream++);
+    hash *= 16777619U;
+  }
+
+  fKey[0] = seed;
+  fKey[1] = hash;
+
+  SetEvent(0, 0);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::SetEvent(ULong64_t event, UInt_t input)
+{
+  fCounter[0] = 0;
+  fCounter[1] = input;
+  fCounter[2] = UInt_t(event);
+  fCounter[3] = UInt_t(event >> 32);
+
+  fBufferIndex = 2;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::SetSeed(ULong_t seed)
+{
+  fKey[0] = UInt_t(seed);
+
+  fCounter[0] = 0;
+  fBufferIndex = 2;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::NextBlock()
+{
+  UInt_t c[4], k[2];
+  ULong64_t p0, p1;
+  Int_t i;
+
+  c[0] = fCounter[0];
+  c[1] = fCounter[1];
+  c[2] = fCounter[2];
+  c[3] = fCounter[3];
+
+  k[0] = fKey[0];
+  k[1] = fKey[1];
+
+  for(i = 0; i < 10; ++i)
+  {
+    if(i > 0)
+    {
+      k[0] += kPhiloxW0;
+      k[1] += kPhiloxW1;
+    }
+
+    p0 = ULong64_t(kPhiloxM0) * c[0];
+    p1 = ULong64_t(kPhiloxM1) * c[2];
+
+    c[0] = UInt_t(p1 >> 32) ^ c[1] ^ k[0];
+    c[1] = UInt_t(p1);
+    c[2] = UInt_t(p0 >> 32) ^ c[3] ^ k[1];
+    c[3] = UInt_t(p0);
+  }
+
+  ++fCounter[0];
+
+  // 53 random bits per number, never 0 or 1
+  fBuffer[0] = ((((ULong64_t(c[0]) << 32) | c[1]) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+  fBuffer[1] = ((((ULong64_t(c[2]) << 32) | c[3]) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+
+  fBufferIndex = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Double_t DelphesRandom::Rndm()
+{
+  if(fBufferIndex > 1) NextBlock();
+  return fBuffer[fBufferIndex++];
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::RndmArray(Int_t n, Float_t *array)
+{
+  Int_t i;
+  for(i = 0; i < n; ++i)
+  {
+    if(fBufferIndex > 1) NextBlock();
+    array[i] = fBuffer[fBufferIndex++];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::RndmArray(Int_t n, Double_t *array)
+{
+  Int_t i;
+  for(i = 0; i < n; ++i)
+  {
+    if(fBufferIndex > 1) NextBlock();
+    array[i] = fBuffer[fBufferIndex++];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::UniformArray(Int_t n, Double_t *array, Double_t x1, Double_t x2)
+{
+  Int_t i;
+
+  RndmArray(n, array);
+  for(i = 0; i < n; ++i)
+  {
+    array[i] = x1 + (x2 - x1) * array[i];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::GausArray(Int_t n, Double_t *array, Double_t mean, Double_t sigma)
+{
+  Double_t r, phi, u[2];
+  Int_t i;
+
+  // Box-Muller, two numbers per pair of uniform draws
+  for(i = 0; i < n; i += 2)
+  {
+    RndmArray(2, u);
+    r = sigma * TMath::Sqrt(-2.0 * TMath::Log(u[0]));
+    phi = 2.0 * TMath::Pi() * u[1];
+
+    array[i] = mean + r * TMath::Cos(phi);
+    if(i + 1 < n) array[i + 1] = mean + r * TMath::Sin(phi);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesRandom::PoissonArray(Int_t n, const Double_t *mean, Int_t *array)
+{
+  Int_t i;
+  for(i = 0; i < n; ++i)
+  {
+    array[i] = Poisson(mean[i]);
+  }
+}
+
+//------------------------------------------------------------------------------
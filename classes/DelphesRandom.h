@@ -0,0 +1,68 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesRandom_h
+#define DelphesRandom_h
+
+/** \class DelphesRandom
+ *
+ *  Counter-based random number stream (Philox4x32-10).
+ *
+ *  The key is derived from the random seed and the stream name (one stream
+ *  per module), the counter from the event number, the input number and
+ *  the position of the draw within the event. The numbers drawn by a module
+ *  in a given event therefore do not depend on other modules or on the
+ *  events processed before it.
+ *
+ *  All TRandom distributions are available on top of Rndm.
+ *
+ */
+
+#include "TRandom.h"
+
+class DelphesRandom: public TRandom
+{
+public:
+  DelphesRandom(UInt_t seed = 0, const char *stream = "");
+
+  // restart the stream for a new event
+  void SetEvent(ULong64_t event, UInt_t input = 0);
+
+  virtual void SetSeed(ULong_t seed = 0);
+  virtual UInt_t GetSeed() const { return fKey[0]; }
+
+  virtual Double_t Rndm();
+  virtual void RndmArray(Int_t n, Float_t *array);
+  virtual void RndmArray(Int_t n, Double_t *array);
+
+  // batched draws
+  void UniformArray(Int_t n, Double_t *array, Double_t x1, Double_t x2);
+  void GausArray(Int_t n, Double_t *array, Double_t mean = 0.0, Double_t sigma = 1.0);
+  void PoissonArray(Int_t n, const Double_t *mean, Int_t *array);
+
+private:
+  void NextBlock();
+
+  UInt_t fKey[2];
+  UInt_t fCounter[4];
+
+  Double_t fBuffer[2];
+  Int_t fBufferIndex;
+};
+
+#endif /* DelphesRandom_h */
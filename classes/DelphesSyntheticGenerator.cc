@@ -0,0 +1,359 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DelphesSyntheticGenerator
+ *
+ *  Generates reproducible synthetic events without external generator.
+ *
+ */
+
+#include "classes/DelphesSyntheticGenerator.h"
+
+#include "classes/DelphesClasses.h"
+#include "classes/DelphesFactory.h"
+
+#include "TDatabasePDG.h"
+#include "TLorentzVector.h"
+#include "TMath.h"
+#include "TMatrixDSym.h"
+#include "TObjArray.h"
+#include "TParticlePDG.h"
+#include "TRandom3.h"
+
+#include <vector>
+
+using namespace std;
+
+// beam spot, in mm
+static const Double_t kVertexSigmaZ = 50.0;
+static const Double_t kVertexSigmaT = 50.0;
+
+// angular spread of jet constituents around the jet axis
+static const Double_t kJetSigma = 0.1;
+
+// mean pt of minimum bias particles, in GeV
+static const Double_t kSoftPT = 0.6;
+static const Double_t kSoftPTMin = 0.1;
+static const Double_t kSoftEtaMax = 5.0;
+
+// track parameter resolutions of synthetic candidates, lengths in mm
+static const Double_t kErrorD0 = 0.02;
+static const Double_t kErrorDZ = 0.05;
+static const Double_t kErrorPhi = 1.0e-3;
+static const Double_t kErrorCtgTheta = 1.0e-3;
+static const Double_t kErrorPT = 0.01;
+
+// curvature of a unit charge with pt = 1 GeV in a 3.8 T field, in 1/mm
+static const Double_t kCurvature = 0.5 * 0.299792458e-3 * 3.8;
+
+static const Int_t kGunPID[] = {11, -11, 13, -13, 22, 211, -211};
+
+//------------------------------------------------------------------------------
+
+DelphesSyntheticGenerator::DelphesSyntheticGenerator(UInt_t seed) :
+  fGunParticles(2), fGunPTMin(10.0), fGunPTMax(100.0), fGunEtaMax(2.5),
+  fJets(2), fJetPTMin(30.0), fJetPTMax(300.0), fJetMultiplicity(30.0),
+  fPileUpVertices(0.0), fPileUpMultiplicity(15.0),
+  fRandom(0), fPDG(0)
+{
+  fRandom = new TRandom3(seed);
+  fPDG = TDatabasePDG::Instance();
+}
+
+//------------------------------------------------------------------------------
+
+DelphesSyntheticGenerator::~DelphesSyntheticGenerator()
+{
+  if(fRandom) delete fRandom;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::SetSeed(UInt_t seed)
+{
+  fRandom->SetSeed(seed);
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::SetGun(Int_t particles, Double_t ptMin, Double_t ptMax, Double_t etaMax)
+{
+  fGunParticles = particles;
+  fGunPTMin = ptMin;
+  fGunPTMax = ptMax;
+  fGunEtaMax = etaMax;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::SetJets(Int_t jets, Double_t ptMin, Double_t ptMax, Double_t multiplicity)
+{
+  fJets = jets;
+  fJetPTMin = ptMin;
+  fJetPTMax = ptMax;
+  fJetMultiplicity = multiplicity;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::SetPileUp(Double_t vertices, Double_t multiplicity)
+{
+  fPileUpVertices = vertices;
+  fPileUpMultiplicity = multiplicity;
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::GenerateEvent(DelphesFactory *factory,
+  TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray)
+{
+  Candidate *candidate;
+  TLorentzVector position;
+  vector<Double_t> fractions;
+  Int_t i, j, pid, size, vertices;
+  Double_t pt, eta, phi, sum;
+
+  position.SetXYZT(0.0, 0.0, fRandom->Gaus(0.0, kVertexSigmaZ), fRandom->Gaus(0.0, kVertexSigmaT));
+
+  // particle gun
+  for(i = 0; i < fGunParticles; ++i)
+  {
+    pid = kGunPID[fRandom->Integer(sizeof(kGunPID) / sizeof(kGunPID[0]))];
+    pt = fRandom->Uniform(fGunPTMin, fGunPTMax);
+    eta = fRandom->Uniform(-fGunEtaMax, fGunEtaMax);
+    phi = fRandom->Uniform(-TMath::Pi(), TMath::Pi());
+
+    candidate = NewParticle(factory, pid, 1, pt, eta, phi, position);
+    allParticleOutputArray->Add(candidate);
+    stableParticleOutputArray->Add(candidate);
+  }
+
+  // jets: a gluon shared out between exponentially distributed fractions
+  for(i = 0; i < fJets; ++i)
+  {
+    pt = fRandom->Uniform(fJetPTMin, fJetPTMax);
+    eta = fRandom->Uniform(-fGunEtaMax, fGunEtaMax);
+    phi = fRandom->Uniform(-TMath::Pi(), TMath::Pi());
+
+    candidate = NewParticle(factory, 21, 23, pt, eta, phi, position);
+    allParticleOutputArray->Add(candidate);
+    partonOutputArray->Add(candidate);
+
+    size = TMath::Max(1, Int_t(fRandom->Poisson(fJetMultiplicity)));
+    fractions.resize(size);
+    sum = 0.0;
+    for(j = 0; j < size; ++j)
+    {
+      fractions[j] = fRandom->Exp(1.0);
+      sum += fractions[j];
+    }
+
+    for(j = 0; j < size; ++j)
+    {
+      candidate = NewParticle(factory, DrawHadron(kFALSE), 1, pt * fractions[j] / sum,
+        eta + fRandom->Gaus(0.0, kJetSigma), phi + fRandom->Gaus(0.0, kJetSigma), position);
+      allParticleOutputArray->Add(candidate);
+      stableParticleOutputArray->Add(candidate);
+    }
+  }
+
+  // in-time pile-up
+  if(fPileUpVertices > 0.0)
+  {
+    vertices = fRandom->Poisson(fPileUpVertices);
+    for(i = 0; i < vertices; ++i)
+    {
+      size = stableParticleOutputArray->GetEntriesFast();
+      GenerateMinBias(factory, stableParticleOutputArray,
+        fRandom->Gaus(0.0, kVertexSigmaZ), fRandom->Gaus(0.0, kVertexSigmaT), 1);
+      for(j = size; j < stableParticleOutputArray->GetEntriesFast(); ++j)
+      {
+        allParticleOutputArray->Add(stableParticleOutputArray->At(j));
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::GenerateMinBias(DelphesFactory *factory, TObjArray *outputArray,
+  Double_t z, Double_t t, Int_t isPU)
+{
+  Candidate *candidate;
+  TLorentzVector position;
+  Int_t i, size;
+  Double_t pt;
+
+  position.SetXYZT(0.0, 0.0, z, t);
+
+  size = fRandom->Poisson(fPileUpMultiplicity);
+  for(i = 0; i < size; ++i)
+  {
+    pt = kSoftPTMin + fRandom->Exp(kSoftPT - kSoftPTMin);
+    candidate = NewParticle(factory, DrawHadron(kTRUE), 1, pt,
+      fRandom->Uniform(-kSoftEtaMax, kSoftEtaMax), fRandom->Uniform(-TMath::Pi(), TMath::Pi()), position);
+    candidate->IsPU = isPU;
+    outputArray->Add(candidate);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DelphesSyntheticGenerator::GenerateCandidates(DelphesFactory *factory, TObjArray *outputArray, Int_t size,
+  Double_t radius, Double_t halfLength)
+{
+  Candidate *candidate;
+  TLorentzVector vertex;
+  TMatrixDSym covariance(5);
+  vector<TLorentzVector> vertices;
+  Int_t i, index;
+  Double_t pt, eta, phi, ux, uy, uz, ut, length, beta;
+
+  // one primary and enough pile-up vertices for the requested multiplicity
+  vertices.resize(1 + Int_t(size / TMath::Max(fPileUpMultiplicity, 1.0)));
+  for(i = 0; i < Int_t(vertices.size()); ++i)
+  {
+    vertices[i].SetXYZT(0.0, 0.0, fRandom->Gaus(0.0, kVertexSigmaZ), fRandom->Gaus(0.0, kVertexSigmaT));
+  }
+
+  for(i = 0; i < size; ++i)
+  {
+    index = (vertices.size() == 1 || fRandom->Rndm() < 0.1) ? 0 : 1 + fRandom->Integer(vertices.size() - 1);
+    vertex = vertices[index];
+
+    if(index == 0)
+    {
+      pt = kSoftPTMin + fRandom->Exp(fGunPTMin);
+      eta = fRandom->Uniform(-fGunEtaMax, fGunEtaMax);
+    }
+    else
+    {
+      pt = kSoftPTMin + fRandom->Exp(kSoftPT - kSoftPTMin);
+      eta = fRandom->Uniform(-kSoftEtaMax, kSoftEtaMax);
+    }
+    phi = fRandom->Uniform(-TMath::Pi(), TMath::Pi());
+
+    candidate = NewParticle(factory, DrawHadron(index > 0), 1, pt, eta, phi, vertex);
+    candidate->IsPU = index > 0;
+    candidate->InitialPosition = vertex;
+
+    const TLorentzVector &momentum = candidate->Momentum;
+
+    // straight line from the vertex to the barrel or to the endcaps
+    ux = momentum.Px() / momentum.P();
+    uy = momentum.Py() / momentum.P();
+    uz = momentum.Pz() / momentum.P();
+    ut = TMath::Sqrt(ux * ux + uy * uy);
+
+    length = radius / ut;
+    if(TMath::Abs(vertex.Z() + length * uz) > halfLength)
+    {
+      length = (TMath::Sign(halfLength, uz) - vertex.Z()) / uz;
+    }
+    beta = momentum.P() / momentum.E();
+
+    candidate->Position.SetXYZT(vertex.X() + length * ux, vertex.Y() + length * uy,
+      vertex.Z() + length * uz, vertex.T() + length / beta);
+    candidate->L = length;
+
+    // track parameters at the point of closest approach
+    candidate->D0 = fRandom->Gaus(0.0, kErrorD0);
+    candidate->DZ = vertex.Z();
+    candidate->P = momentum.P();
+    candidate->PT = pt;
+    candidate->CtgTheta = momentum.Pz() / pt;
+    candidate->Phi = phi;
+    candidate->C = kCurvature * candidate->Charge / pt;
+
+    candidate->ErrorD0 = kErrorD0;
+    candidate->ErrorDZ = kErrorDZ;
+    candidate->ErrorP = kErrorPT * candidate->P;
+    candidate->ErrorPT = kErrorPT * pt;
+    candidate->ErrorCtgTheta = kErrorCtgTheta;
+    candidate->ErrorPhi = kErrorPhi;
+    candidate->ErrorC = kErrorPT * TMath::Abs(candidate->C);
+    candidate->TrackResolution = kErrorPT;
+
+    candidate->PositionError.SetXYZT(kErrorD0, kErrorD0, kErrorDZ, kVertexSigmaT / 1000.0);
+
+    candidate->Xd = vertex.X();
+    candidate->Yd = vertex.Y();
+    candidate->Zd = vertex.Z();
+
+    if(candidate->Charge != 0)
+    {
+      covariance.Zero();
+      covariance(0, 0) = kErrorD0 * kErrorD0;
+      covariance(1, 1) = kErrorPhi * kErrorPhi;
+      covariance(2, 2) = candidate->ErrorC * candidate->ErrorC;
+      covariance(3, 3) = kErrorDZ * kErrorDZ;
+      covariance(4, 4) = kErrorCtgTheta * kErrorCtgTheta;
+      candidate->SetTrackCovariance(covariance);
+    }
+
+    outputArray->Add(candidate);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Candidate *DelphesSyntheticGenerator::NewParticle(DelphesFactory *factory, Int_t pid, Int_t status,
+  Double_t pt, Double_t eta, Double_t phi, const TLorentzVector &position)
+{
+  Candidate *candidate;
+  TParticlePDG *pdgParticle;
+  Double_t mass;
+
+  pdgParticle = fPDG->GetParticle(pid);
+  mass = pdgParticle ? pdgParticle->Mass() : 0.0;
+
+  candidate = factory->NewCandidate();
+
+  candidate->PID = pid;
+  candidate->Status = status;
+  candidate->Charge = pdgParticle ? int(pdgParticle->Charge() / 3.0) : 0;
+  candidate->Mass = mass;
+
+  candidate->Momentum.SetPtEtaPhiM(pt, eta, phi, mass);
+  candidate->Position = position;
+
+  candidate->M1 = -1;
+  candidate->M2 = -1;
+  candidate->D1 = -1;
+  candidate->D2 = -1;
+
+  return candidate;
+}
+
+//------------------------------------------------------------------------------
+
+Int_t DelphesSyntheticGenerator::DrawHadron(Bool_t soft)
+{
+  Double_t r = fRandom->Rndm();
+  Int_t sign = fRandom->Rndm() < 0.5 ? 1 : -1;
+
+  // rough particle composition of jets and minimum bias events
+  if(r < 0.60) return sign * 211;
+  if(r < 0.85) return 22;
+  if(r < 0.92) return sign * 321;
+  if(r < 0.95) return 130;
+  if(soft || r < 0.98) return sign * 2212;
+  return sign * 2112;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DelphesSyntheticGenerator_h
+#define DelphesSyntheticGenerator_h
+
+/** \class DelphesSyntheticGenerator
+ *
+ *  Generates reproducible synthetic events without external generator:
+ *  particle guns, collimated jets of hadrons and photons, and minimum bias
+ *  pile-up vertices with parametrised multiplicities.
+ *
+ *  Kinematics are only meant to load the detector simulation realistically,
+ *  not to describe any physics process.
+ *
+ */
+
+#include "Rtypes.h"
+
+class TDatabasePDG;
+class TLorentzVector;
+class TObjArray;
+class TRandom3;
+
+class Candidate;
+class DelphesFactory;
+
+class DelphesSyntheticGenerator
+{
+public:
+  DelphesSyntheticGenerator(UInt_t seed = 1);
+  ~DelphesSyntheticGenerator();
+
+  void SetSeed(UInt_t seed);
+
+  // particle gun: particles per event, pt range and eta acceptance of the
+  // particle gun and of the jets
+  void SetGun(Int_t particles, Double_t ptMin, Double_t ptMax, Double_t etaMax);
+
+  // jets: jets per event, pt range and mean number of constituents
+  void SetJets(Int_t jets, Double_t ptMin, Double_t ptMax, Double_t multiplicity);
+
+  // pile-up: mean number of vertices per event and of particles per vertex
+  void SetPileUp(Double_t vertices, Double_t multiplicity);
+
+  void GenerateEvent(DelphesFactory *factory,
+    TObjArray *allParticleOutputArray, TObjArray *stableParticleOutputArray, TObjArray *partonOutputArray);
+
+  // one minimum bias interaction, stable particles only
+  void GenerateMinBias(DelphesFactory *factory, TObjArray *outputArray,
+    Double_t z, Double_t t, Int_t isPU);
+
+  // stable particles with track parameters and covariance, propagated in
+  // straight lines to a cylinder of given radius and half-length (in mm),
+  // to feed single modules; about one particle in ten comes from the
+  // primary vertex, the others from pile-up vertices
+  void GenerateCandidates(DelphesFactory *factory, TObjArray *outputArray, Int_t size,
+    Double_t radius = 1290.0, Double_t halfLength = 3000.0);
+
+private:
+  Candidate *NewParticle(DelphesFactory *factory, Int_t pid, Int_t status,
+    Double_t pt, Double_t eta, Double_t phi, const TLorentzVector &position);
+
+  Int_t DrawHadron(Bool_t soft);
+
+  Int_t fGunParticles;
+  Double_t fGunPTMin, fGunPTMax, fGunEtaMax;
+
+  Int_t fJets;
+  Double_t fJetPTMin, fJetPTMax, fJetMultiplicity;
+
+  Double_t fPileUpVertices, fPileUpMultiplicity;
+
+  TRandom3 *fRandom; //!
+  TDatabasePDG *fPDG; //!
+};
+
+#endif // DelphesSyntheticGenerator_h
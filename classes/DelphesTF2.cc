@@ -76,3 +76,14 @@ Int_t DelphesTF2::Compile(const char *expression)
 }
 
 //------------------------------------------------------------------------------
+
+void DelphesTF2::GetRandom2(Double_t &xrandom, Double_t &yrandom, TRandom *random)
+{
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+  TF2::GetRandom2(xrandom, yrandom, random);
+#else
+  TF2::GetRandom2(xrandom, yrandom);
+#endif
+}
+
+//------------------------------------------------------------------------------
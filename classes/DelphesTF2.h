@@ -21,6 +21,8 @@
 
 #include "TF2.h"
 
+class TRandom;
+
 class DelphesTF2: public TF2
 {
 public:
@@ -31,6 +33,10 @@ public:
   ~DelphesTF2();
 
   Int_t Compile(const char *expression);
+
+  // random point drawn with the given generator instead of gRandom,
+  // gRandom is still used with ROOT versions before 6.24
+  void GetRandom2(Double_t &xrandom, Double_t &yrandom, TRandom *random);
 };
 
 #endif /* DelphesTF2_h */
@@ -25,12 +25,17 @@
  *
  */
 
+#include "TObjArray.h"
 #include "TObject.h"
 #include "TRef.h"
 #include "TRefArray.h"
 
 #include "TMath.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 //---------------------------------------------------------------------------
 
 class CompBase
@@ -255,4 +260,93 @@ public:
   }
 };
 
+//---------------------------------------------------------------------------
+// Sort keys: extract the quantity used by the corresponding Comp* class
+//---------------------------------------------------------------------------
+
+template <typename T>
+struct KeyE
+{
+  Double_t operator()(const T *t) const { return t->E; }
+};
+
+template <typename T>
+struct KeyPT
+{
+  Double_t operator()(const T *t) const { return t->PT; }
+};
+
+template <typename T>
+struct KeyMomentumPt
+{
+  Double_t operator()(const T *t) const { return t->Momentum.Pt(); }
+};
+
+template <typename T>
+struct KeyET
+{
+  Double_t operator()(const T *t) const { return t->ET; }
+};
+
+template <typename T>
+struct KeySumPT2
+{
+  Double_t operator()(const T *t) const { return t->SumPT2; }
+};
+
+//---------------------------------------------------------------------------
+// Sorts object arrays in decreasing order of a key evaluated once per
+// object. Ties keep their original order. The buffers are kept between
+// calls.
+//---------------------------------------------------------------------------
+
+class KeySorter
+{
+public:
+  template <typename T, typename K>
+  void Sort(TObjArray *array, K key)
+  {
+    Sort<T>(array, key, -1);
+  }
+
+  // top-K sorting: with maxSize >= 0 only the leading maxSize objects
+  // are ordered, the others follow in no particular order
+  template <typename T, typename K>
+  void Sort(TObjArray *array, K key, Int_t maxSize)
+  {
+    Int_t i, size = array->GetEntriesFast();
+    Double_t value;
+
+    if(size < 2) return;
+
+    fKeys.resize(size);
+    fObjects.resize(size);
+    for(i = 0; i < size; ++i)
+    {
+      fObjects[i] = array->UncheckedAt(i);
+      value = key(static_cast<const T *>(fObjects[i]));
+      // NaN keys go to the end
+      fKeys[i] = std::make_pair(value == value ? -value : TMath::Infinity(), i);
+    }
+
+    if(maxSize >= 0 && maxSize < size)
+    {
+      std::partial_sort(fKeys.begin(), fKeys.begin() + maxSize, fKeys.end());
+    }
+    else
+    {
+      std::sort(fKeys.begin(), fKeys.end());
+    }
+
+    for(i = 0; i < size; ++i)
+    {
+      array->AddAt(fObjects[fKeys[i].second], i);
+    }
+  }
+
+private:
+  std::vector<std::pair<Double_t, Int_t> > fKeys;
+  std::vector<TObject *> fObjects;
+};
+
 #endif // SortableObject_h
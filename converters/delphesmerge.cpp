@@ -0,0 +1,150 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "TApplication.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+
+#include "classes/DelphesMerger.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+static bool GetOption(const char *argument, const char *name, const char *&value)
+{
+  size_t length = strlen(name);
+  if(strncmp(argument, "--", 2) != 0 || strncmp(argument + 2, name, length) != 0 || argument[length + 2] != '=') return false;
+  value = argument + length + 3;
+  return true;
+}
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "delphesmerge";
+  stringstream message;
+  TFile *outputFile = 0;
+  DelphesMerger merger;
+  TStopwatch stopWatch;
+  const char *value, *outputName = 0;
+  Int_t i, inputs, threads, compression;
+  Long64_t entries;
+
+  if(argc < 3)
+  {
+    cout << " Usage: " << appName << " [options] output_file input_file(s)" << endl;
+    cout << " output_file - merged output file in ROOT format," << endl;
+    cout << " input_file(s) - Delphes output files in ROOT format, merged in the given order." << endl;
+    cout << " options:" << endl;
+    cout << "  --tree=NAME - name of the tree to merge (default Delphes)," << endl;
+    cout << "  --threads=N - number of files merged concurrently (default number of cores)," << endl;
+    cout << "  --compression=N - compression settings of the entries written again" << endl;
+    cout << "                    (default ROOT settings, copied baskets keep their compression)." << endl;
+    return 1;
+  }
+
+  gROOT->SetBatch();
+
+  int appargc = 1;
+  char *appargv[] = {appName};
+  TApplication app(appName, &appargc, appargv);
+
+  try
+  {
+    threads = thread::hardware_concurrency();
+    compression = -1;
+    inputs = 0;
+
+    for(i = 1; i < argc; ++i)
+    {
+      if(GetOption(argv[i], "tree", value))
+        merger.SetTreeName(value);
+      else if(GetOption(argv[i], "threads", value))
+        threads = atoi(value);
+      else if(GetOption(argv[i], "compression", value))
+        compression = atoi(value);
+      else if(strncmp(argv[i], "--", 2) == 0)
+      {
+        message << "unknown option " << argv[i];
+        throw runtime_error(message.str());
+      }
+      else if(!outputName)
+        outputName = argv[i];
+      else
+      {
+        merger.AddFile(argv[i]);
+        ++inputs;
+      }
+    }
+
+    if(inputs == 0)
+    {
+      throw runtime_error("no input files");
+    }
+
+    outputFile = TFile::Open(outputName, "CREATE");
+
+    if(outputFile == NULL)
+    {
+      message << "can't create output file " << outputName;
+      throw runtime_error(message.str());
+    }
+
+    if(compression >= 0) outputFile->SetCompressionSettings(compression);
+
+    cout << "** Merging " << inputs << " files into " << outputName << endl;
+
+    stopWatch.Start();
+
+    merger.SetNumberOfThreads(threads > 0 ? threads : 1);
+    entries = merger.Merge(outputFile);
+
+    outputFile->Close();
+
+    stopWatch.Stop();
+
+    cout << "** " << entries << " entries, ";
+    cout << merger.GetFastFiles() << " files copied as compressed baskets, ";
+    cout << merger.GetSlowFiles() << " files copied entry by entry, ";
+    cout << stopWatch.RealTime() << " s" << endl;
+
+    cout << "** Exiting..." << endl;
+
+    delete outputFile;
+
+    return 0;
+  }
+  catch(runtime_error &e)
+  {
+    if(outputFile) delete outputFile;
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "classes/DelphesEventIndex.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "event2index";
+  stringstream message;
+  FILE *inputFile = 0;
+  DelphesEventIndex *eventIndex = 0;
+  string indexName;
+  long long length, entry, particles;
+  int i;
+
+  if(argc < 3)
+  {
+    cout << " Usage: " << appName << " input_format"
+         << " input_file(s)" << endl;
+    cout << " input_format - hepmc (HepMC2 or HepMC3 ASCII) or lhef," << endl;
+    cout << " input_file(s) - input file(s), the index of each input file is written" << endl;
+    cout << " next to it with the .idx extension." << endl;
+    return 1;
+  }
+
+  try
+  {
+    if(strcmp(argv[1], "hepmc") == 0)
+    {
+      eventIndex = new DelphesEventIndex(DelphesEventIndex::kHepMC);
+    }
+    else if(strcmp(argv[1], "lhef") == 0)
+    {
+      eventIndex = new DelphesEventIndex(DelphesEventIndex::kLHEF);
+    }
+    else
+    {
+      message << "unknown input format " << argv[1];
+      throw runtime_error(message.str());
+    }
+
+    for(i = 2; i < argc; ++i)
+    {
+      cout << "** Indexing " << argv[i] << endl;
+      inputFile = fopen(argv[i], "r");
+
+      if(inputFile == NULL)
+      {
+        message << "can't open " << argv[i];
+        throw runtime_error(message.str());
+      }
+
+      fseeko(inputFile, 0, SEEK_END);
+      length = ftello(inputFile);
+      fseeko(inputFile, 0, SEEK_SET);
+
+      eventIndex->Build(inputFile);
+
+      fclose(inputFile);
+
+      particles = 0;
+      for(entry = 0; entry < eventIndex->GetEntries(); ++entry)
+      {
+        particles += eventIndex->GetParticles(entry);
+      }
+
+      indexName = DelphesEventIndex::GetIndexName(argv[i]);
+      if(!eventIndex->Write(indexName.c_str(), length))
+      {
+        message << "can't write " << indexName;
+        throw runtime_error(message.str());
+      }
+
+      cout << "** " << eventIndex->GetEntries() << " events, " << particles << " particles" << endl;
+    }
+
+    cout << "** Exiting..." << endl;
+
+    delete eventIndex;
+
+    return 0;
+  }
+  catch(runtime_error &e)
+  {
+    if(eventIndex) delete eventIndex;
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
@@ -291,7 +291,7 @@ all:
 
 executableDeps {converters/*.cpp} {examples/*.cpp} {validation/*.cpp}
 
-executableDeps {readers/DelphesHepMC2.cpp} {readers/DelphesHepMC3.cpp} {readers/DelphesLHEF.cpp} {readers/DelphesSTDHEP.cpp} {readers/DelphesROOT.cpp}
+executableDeps {readers/DelphesHepMC2.cpp} {readers/DelphesHepMC3.cpp} {readers/DelphesLHEF.cpp} {readers/DelphesSTDHEP.cpp} {readers/DelphesROOT.cpp} {readers/DelphesBench.cpp} {readers/DelphesModuleBench.cpp} {readers/DelphesCheckpoint.cpp}
 
 puts {ifeq ($(HAS_CMSSW),true)}
 executableDeps {readers/DelphesCMSFWLite.cpp}
@@ -405,6 +405,23 @@ dist:
 	@tar -czf $(DISTTAR) $(DISTDIR)
 	@rm -rf $(DISTDIR)
 
+bench: DelphesBench$(ExeSuf)
+	@mkdir -p bench
+	@./DelphesBench$(ExeSuf) cards/delphes_card_CMS.tcl bench/CMS.root --events=1000
+	@./DelphesBench$(ExeSuf) cards/delphes_card_IDEA.tcl bench/IDEA.root --events=1000
+	@./DelphesBench$(ExeSuf) cards/delphes_card_ATLAS_PileUp.tcl bench/ATLAS_PileUp.root --events=200 --pileup-file=bench/MinBias.pileup
+	@./DelphesBench$(ExeSuf) cards/CMS_PhaseII/CMS_PhaseII_200PU_v04.tcl bench/CMS_PhaseII_200PU.root --events=50 --pileup-file=bench/MinBias.pileup
+
+microbench: DelphesModuleBench$(ExeSuf)
+	@mkdir -p bench
+	@./DelphesModuleBench$(ExeSuf) cards/delphes_card_CMS.tcl ECal --json=bench/ECal.json
+	@./DelphesModuleBench$(ExeSuf) cards/delphes_card_IDEA.tcl Calorimeter --json=bench/DualReadoutCalorimeter.json
+	@./DelphesModuleBench$(ExeSuf) cards/delphes_card_CMS.tcl PhotonIsolation --json=bench/Isolation.json
+	@./DelphesModuleBench$(ExeSuf) cards/delphes_card_CMS.tcl FastJetFinder --json=bench/FastJetFinder.json
+	@./DelphesModuleBench$(ExeSuf) cards/delphes_card_IDEA.tcl TrackSmearing --json=bench/TrackCovariance.json
+	@./DelphesModuleBench$(ExeSuf) cards/CMS_PhaseII/testVertexing.tcl VertexFinderDA4D --max-size=10000 --max-exponent=2.0 --json=bench/VertexFinderDA4D.json
+	@./DelphesModuleBench$(ExeSuf) cards/CMS_PhaseII/CMS_PhaseII_200PU_v04.tcl RunPUPPIBase --fixed=PVInputArray:200 --json=bench/RunPUPPI.json
+
 ###
 
 .SUFFIXES: .$(SrcSuf) .$(ObjSuf) .$(DllSuf) $(PcmSuf)
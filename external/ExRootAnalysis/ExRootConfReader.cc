@@ -13,6 +13,7 @@
 
 #include "TSystem.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -97,6 +98,98 @@ ExRootConfParam ExRootConfReader::GetParam(const char *name)
 
 //------------------------------------------------------------------------------
 
+void ExRootConfReader::SetParam(const char *name, const char *value)
+{
+  stringstream message;
+
+  if(!Tcl_SetVar2(fTclInterp, const_cast<char *>(name), 0, const_cast<char *>(value), TCL_GLOBAL_ONLY | TCL_LEAVE_ERR_MSG))
+  {
+    message << "can't set parameter '" << name << "'" << endl;
+    message << Tcl_GetStringResult(fTclInterp);
+    throw runtime_error(message.str());
+  }
+}
+
+//------------------------------------------------------------------------------
+
+vector<TString> ExRootConfReader::GetParamNames(const char *moduleName)
+{
+  stringstream message, command;
+  vector<TString> names;
+  Tcl_Obj **objv;
+  int i, objc;
+  TString name;
+
+  command << "info vars ::" << moduleName << "::*";
+  if(Tcl_Eval(fTclInterp, const_cast<char *>(command.str().c_str())) != TCL_OK
+    || Tcl_ListObjGetElements(fTclInterp, Tcl_GetObjResult(fTclInterp), &objc, &objv) != TCL_OK)
+  {
+    message << "can't list parameters of module '" << moduleName << "'" << endl;
+    message << Tcl_GetStringResult(fTclInterp);
+    throw runtime_error(message.str());
+  }
+
+  for(i = 0; i < objc; ++i)
+  {
+    name = Tcl_GetStringFromObj(objv[i], 0);
+    name.Remove(0, name.Last(':') + 1);
+    names.push_back(name);
+  }
+
+  return names;
+}
+
+//------------------------------------------------------------------------------
+
+TString ExRootConfReader::GetModuleConfiguration(const char *moduleName)
+{
+  vector<TString> names, keys;
+  vector<TString>::iterator itNames, itKeys;
+  stringstream command;
+  TString configuration, name;
+  Tcl_Obj **objv;
+  const char *value;
+  int i, objc;
+
+  names = GetParamNames(moduleName);
+  sort(names.begin(), names.end());
+
+  for(itNames = names.begin(); itNames != names.end(); ++itNames)
+  {
+    name = TString("::") + moduleName + "::" + *itNames;
+
+    value = Tcl_GetVar2(fTclInterp, const_cast<char *>(name.Data()), 0, TCL_GLOBAL_ONLY);
+    if(value)
+    {
+      configuration += *itNames + " " + value + "\n";
+      continue;
+    }
+
+    // array variables, element by element
+    command.str("");
+    command << "array names " << name;
+    if(Tcl_Eval(fTclInterp, const_cast<char *>(command.str().c_str())) != TCL_OK
+      || Tcl_ListObjGetElements(fTclInterp, Tcl_GetObjResult(fTclInterp), &objc, &objv) != TCL_OK) continue;
+
+    keys.clear();
+    for(i = 0; i < objc; ++i)
+    {
+      keys.push_back(Tcl_GetStringFromObj(objv[i], 0));
+    }
+    sort(keys.begin(), keys.end());
+
+    for(itKeys = keys.begin(); itKeys != keys.end(); ++itKeys)
+    {
+      value = Tcl_GetVar2(fTclInterp, const_cast<char *>(name.Data()), const_cast<char *>(itKeys->Data()), TCL_GLOBAL_ONLY);
+      configuration += *itNames + "(" + *itKeys + ") " + (value ? value : "") + "\n";
+    }
+  }
+
+  return configuration;
+}
+
+//------------------------------------------------------------------------------
+
 int ExRootConfReader::GetInt(const char *name, int defaultValue, int index)
 {
   ExRootConfParam object = GetParam(name);
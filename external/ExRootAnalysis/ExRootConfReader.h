@@ -13,6 +13,7 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 
 struct Tcl_Obj;
 struct Tcl_Interp;
@@ -56,6 +57,16 @@ public:
   const char *GetString(const char *name, const char *defaultValue, int index = -1);
   ExRootConfParam GetParam(const char *name);
 
+  // override a parameter after the configuration file has been read
+  void SetParam(const char *name, const char *value);
+
+  // names of the parameters set in the block of a module
+  std::vector<TString> GetParamNames(const char *moduleName);
+
+  // all parameters of a module as sorted name and value lines,
+  // equal for modules configured identically
+  TString GetModuleConfiguration(const char *moduleName);
+
   const ExRootTaskMap *GetModules() const { return &fModules; }
 
   void AddModule(const char *className, const char *moduleName);
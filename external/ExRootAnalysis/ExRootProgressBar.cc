@@ -19,7 +19,7 @@
 using namespace std;
 
 ExRootProgressBar::ExRootProgressBar(Long64_t entries, Int_t width) :
-  fEntries(entries), fEventCounter(0), fWidth(width), fTime(0), fHashes(-1), fBar(0)
+  fEntries(entries), fEventCounter(0), fMemoryUsage(-1), fWidth(width), fTime(0), fHashes(-1), fBar(0)
 {
   fBar = new char[width + 1];
   memset(fBar, '-', width);
@@ -52,7 +52,10 @@ void ExRootProgressBar::Update(Long64_t entry, Long64_t eventCounter, Bool_t las
       memset(fBar, '#', hashes);
       memset(fBar + hashes, '-', fWidth - hashes);
       fHashes = hashes;
-      fprintf(stderr, "** [%s] (%.2f%%)\r", fBar, Float_t(entry) / fEntries * 100.0);
+      if(fMemoryUsage >= 0)
+        fprintf(stderr, "** [%s] (%.2f%%) [%.1f MB]\r", fBar, Float_t(entry) / fEntries * 100.0, fMemoryUsage / 1048576.0);
+      else
+        fprintf(stderr, "** [%s] (%.2f%%)\r", fBar, Float_t(entry) / fEntries * 100.0);
     }
   }
   else
@@ -60,7 +63,10 @@ void ExRootProgressBar::Update(Long64_t entry, Long64_t eventCounter, Bool_t las
     if(eventCounter > fEventCounter)
     {
       fEventCounter = eventCounter;
-      fprintf(stderr, "** %lld events processed\r", eventCounter);
+      if(fMemoryUsage >= 0)
+        fprintf(stderr, "** %lld events processed [%.1f MB]\r", eventCounter, fMemoryUsage / 1048576.0);
+      else
+        fprintf(stderr, "** %lld events processed\r", eventCounter);
     }
   }
 
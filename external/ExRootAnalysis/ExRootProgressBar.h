@@ -12,8 +12,11 @@ public:
   void Update(Long64_t entry, Long64_t eventCounter = 0, Bool_t last = kFALSE);
   void Finish();
 
+  // memory shown next to the progress, not shown when negative
+  void SetMemoryUsage(Long64_t bytes) { fMemoryUsage = bytes; }
+
 private:
-  Long64_t fEntries, fEventCounter;
+  Long64_t fEntries, fEventCounter, fMemoryUsage;
   Int_t fWidth;
 
   ULong64_t fTime;
@@ -9,12 +9,15 @@
 
 #include "ExRootAnalysis/ExRootTask.h"
 #include "ExRootAnalysis/ExRootConfReader.h"
+#include "ExRootAnalysis/ExRootTimeline.h"
 
 #include "TClass.h"
 #include "TFolder.h"
+#include "TList.h"
 #include "TROOT.h"
 #include "TString.h"
 
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -26,8 +29,12 @@ static const char *const kFINISH = "2";
 
 using namespace std;
 
+Bool_t ExRootTask::fgTiming = kFALSE;
+
+//------------------------------------------------------------------------------
+
 ExRootTask::ExRootTask() :
-  TTask("", ""), fFolder(0), fConfReader(0)
+  TTask("", ""), fFolder(0), fConfReader(0), fProcessTime(0.0), fProcessCalls(0)
 {
 }
 
@@ -59,6 +66,10 @@ void ExRootTask::Finish()
 
 void ExRootTask::Exec(Option_t *option)
 {
+  ExRootTimeline *timeline;
+  chrono::steady_clock::time_point begin;
+  Double_t start;
+
   if(option == kINIT)
   {
     cout << left;
@@ -68,7 +79,31 @@ void ExRootTask::Exec(Option_t *option)
   }
   else if(option == kPROCESS)
   {
-    Process();
+    timeline = ExRootTimeline::GetTimeline();
+    if(timeline && !timeline->IsActive()) timeline = 0;
+
+    // tasks with subtasks are timed and traced through their subtasks
+    if((fgTiming || timeline) && GetListOfTasks()->GetSize() == 0)
+    {
+      begin = chrono::steady_clock::now();
+      start = timeline ? timeline->Now() : 0.0;
+
+      Process();
+
+      if(timeline)
+      {
+        timeline->AddSpan(GetName(), "module", start, timeline->Now(), timeline->GetEvent(), GetTraceArguments());
+      }
+      if(fgTiming)
+      {
+        fProcessTime += chrono::duration<Double_t>(chrono::steady_clock::now() - begin).count();
+        ++fProcessCalls;
+      }
+    }
+    else
+    {
+      Process();
+    }
   }
   else if(option == kFINISH)
   {
@@ -120,6 +155,23 @@ void ExRootTask::FinishSubTasks()
 
 //------------------------------------------------------------------------------
 
+void ExRootTask::ProcessTaskConcurrently()
+{
+  TIter itTasks(GetListOfTasks());
+  TObject *object;
+
+  if(!IsActive()) return;
+
+  Exec(kPROCESS);
+
+  while((object = itTasks.Next()))
+  {
+    static_cast<ExRootTask *>(object)->ProcessTaskConcurrently();
+  }
+}
+
+//------------------------------------------------------------------------------
+
 void ExRootTask::Add(TTask *task)
 {
   stringstream message;
@@ -34,6 +34,10 @@ public:
   virtual void ProcessSubTasks();
   virtual void FinishSubTasks();
 
+  // runs Process of this task and of its active subtasks like ProcessTask,
+  // without the global TTask state, so that several tasks can run at once
+  void ProcessTaskConcurrently();
+
   void Add(TTask *task);
 
   ExRootTask *NewTask(TClass *cl, const char *name);
@@ -41,6 +45,14 @@ public:
 
   void Exec(Option_t *option);
 
+  // JSON object members added to the timeline span of Process
+  virtual TString GetTraceArguments() const { return ""; }
+
+  // wall time spent in Process, accumulated while timing is enabled
+  static void SetTiming(Bool_t flag) { fgTiming = flag; }
+  Double_t GetProcessTime() const { return fProcessTime; }
+  Long64_t GetProcessCalls() const { return fProcessCalls; }
+
   int GetInt(const char *name, int defaultValue, int index = -1);
   long GetLong(const char *name, long defaultValue, int index = -1);
   double GetDouble(const char *name, double defaultValue, int index = -1);
@@ -60,9 +72,14 @@ protected:
   TObject *GetObject(const char *name, TClass *cl);
 
 private:
+  static Bool_t fgTiming; //!
+
   TFolder *fFolder; //!
   ExRootConfReader *fConfReader; //!
 
+  Double_t fProcessTime; //!
+  Long64_t fProcessCalls; //!
+
   ClassDef(ExRootTask, 1)
 };
 
@@ -0,0 +1,104 @@
+
+/** \class ExRootTimeline
+ *
+ *  Writes spans of sampled events in Chrome trace event format
+ *
+ */
+
+#include "ExRootAnalysis/ExRootTimeline.h"
+
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace std;
+
+ExRootTimeline *ExRootTimeline::fgTimeline = 0;
+
+//------------------------------------------------------------------------------
+
+ExRootTimeline::ExRootTimeline(const char *fileName, Int_t sampling) :
+  fFile(0), fSampling(sampling > 0 ? sampling : 1), fEvent(-1), fSpans(0),
+  fProcess(getpid()), fThreads(0), fStart(chrono::steady_clock::now())
+{
+  stringstream message;
+
+  fFile = fopen(fileName, "w");
+
+  if(fFile == NULL)
+  {
+    message << "can't create timeline file " << fileName;
+    throw runtime_error(message.str());
+  }
+
+  fprintf(fFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+}
+
+//------------------------------------------------------------------------------
+
+ExRootTimeline::~ExRootTimeline()
+{
+  Close();
+  if(fgTimeline == this) fgTimeline = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Double_t ExRootTimeline::Now() const
+{
+  return chrono::duration<Double_t, micro>(chrono::steady_clock::now() - fStart).count();
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTimeline::AddSpan(const char *name, const char *category, Double_t start, Double_t stop,
+  Long64_t event, const char *arguments)
+{
+  Int_t thread = GetThreadNumber();
+
+  lock_guard<mutex> lock(fMutex);
+
+  if(!fFile) return;
+
+  fprintf(fFile, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,",
+    fSpans > 0 ? ",\n" : "", name, category, start, stop - start);
+  fprintf(fFile, "\"pid\":%d,\"tid\":%d,\"args\":{\"event\":%lld%s%s}}",
+    fProcess, thread, event, arguments && arguments[0] ? "," : "", arguments ? arguments : "");
+
+  ++fSpans;
+
+  if(thread >= Int_t(fTraced.size())) fTraced.resize(thread + 1, kFALSE);
+  if(!fTraced[thread])
+  {
+    fTraced[thread] = kTRUE;
+    ++fThreads;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTimeline::Close()
+{
+  lock_guard<mutex> lock(fMutex);
+
+  if(!fFile) return;
+
+  fprintf(fFile, "\n]}\n");
+  fclose(fFile);
+  fFile = 0;
+}
+
+//------------------------------------------------------------------------------
+
+Int_t ExRootTimeline::GetThreadNumber()
+{
+  // small and stable thread identifiers for the trace viewer
+  static atomic<Int_t> counter(0);
+  thread_local Int_t number = counter++;
+  return number;
+}
+
+//------------------------------------------------------------------------------
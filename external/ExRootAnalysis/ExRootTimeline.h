@@ -0,0 +1,67 @@
+#ifndef ExRootTimeline_h
+#define ExRootTimeline_h
+
+/** \class ExRootTimeline
+ *
+ *  Writes spans of sampled events in Chrome trace event format
+ *  (chrome://tracing, Perfetto). One event out of fSampling is traced.
+ *
+ */
+
+#include "Rtypes.h"
+
+#include <stdio.h>
+
+#if !defined(__CINT__) && !defined(__CLING__)
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+class ExRootTimeline
+{
+public:
+  ExRootTimeline(const char *fileName, Int_t sampling = 100);
+  ~ExRootTimeline();
+
+  // timeline used by tasks and tree writers, null when tracing is off
+  static ExRootTimeline *GetTimeline() { return fgTimeline; }
+  static void SetTimeline(ExRootTimeline *timeline) { fgTimeline = timeline; }
+
+  void SetEvent(Long64_t event) { fEvent = event; }
+  Long64_t GetEvent() const { return fEvent; }
+
+  Bool_t IsSampled(Long64_t event) const { return event >= 0 && event % fSampling == 0; }
+  Bool_t IsActive() const { return IsSampled(fEvent); }
+
+  // microseconds since the timeline was opened
+  Double_t Now() const;
+
+  // arguments are JSON object members added after the event number
+  void AddSpan(const char *name, const char *category, Double_t start, Double_t stop,
+    Long64_t event, const char *arguments = 0);
+
+  // spans written so far and threads they were recorded on
+  Long64_t GetNumberOfSpans() const { return fSpans; }
+  Int_t GetNumberOfThreads() const { return fThreads; }
+
+  void Close();
+
+private:
+  static Int_t GetThreadNumber();
+
+  static ExRootTimeline *fgTimeline;
+
+  FILE *fFile;
+  Int_t fSampling;
+  Long64_t fEvent, fSpans;
+  Int_t fProcess, fThreads;
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  std::chrono::steady_clock::time_point fStart;
+  std::mutex fMutex;
+  std::vector<Bool_t> fTraced;
+#endif
+};
+
+#endif /* ExRootTimeline */
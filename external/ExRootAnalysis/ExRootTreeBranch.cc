@@ -10,11 +10,13 @@
 
 #include "ExRootAnalysis/ExRootTreeBranch.h"
 
+#include "TClass.h"
 #include "TClonesArray.h"
 #include "TFile.h"
 #include "TString.h"
 #include "TTree.h"
 
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -24,7 +26,8 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 ExRootTreeBranch::ExRootTreeBranch(const char *name, TClass *cl, TTree *tree) :
-  fSize(0), fCapacity(1), fData(0)
+  fSize(0), fCapacity(1), fPeakCapacity(1), fWindowSize(0), fWorkingSize(0),
+  fWindow(100), fClearCounter(0), fObjectSize(0), fData(0)
 {
   stringstream message;
   //  cl->IgnoreTObjectStreamer();
@@ -34,6 +37,7 @@ ExRootTreeBranch::ExRootTreeBranch(const char *name, TClass *cl, TTree *tree) :
   if(fData)
   {
     fData->SetName(name);
+    fObjectSize = cl->Size();
     fData->ExpandCreateFast(fCapacity);
     fData->Clear();
     if(tree)
@@ -64,16 +68,8 @@ TObject *ExRootTreeBranch::NewEntry()
 
   if(fSize >= fCapacity)
   {
-    if(fCapacity < 10)
-      fCapacity = 10;
-    else if(fCapacity < 30)
-      fCapacity = 30;
-    else if(fCapacity < 100)
-      fCapacity = 100;
-    else if(fCapacity < 250)
-      fCapacity = 250;
-    else
-      fCapacity *= 2;
+    fCapacity = NextCapacity(fCapacity);
+    if(fCapacity > fPeakCapacity) fPeakCapacity = fCapacity;
 
     fData->ExpandCreateFast(fCapacity);
 
@@ -88,8 +84,106 @@ TObject *ExRootTreeBranch::NewEntry()
 
 void ExRootTreeBranch::Clear()
 {
+  if(fSize > fWindowSize) fWindowSize = fSize;
+
+  if(++fClearCounter >= fWindow)
+  {
+    fWorkingSize = fWindowSize;
+    fWindowSize = 0;
+    fClearCounter = 0;
+  }
+
   fSize = 0;
   if(fData) fData->Clear();
 }
 
 //------------------------------------------------------------------------------
+
+Long64_t ExRootTreeBranch::Trim()
+{
+  Int_t capacity, workingSize;
+  Long64_t bytes;
+
+  if(!fData || fSize > 0) return 0;
+
+  // follow the growth sequence of NewEntry
+  workingSize = GetWorkingSize();
+  capacity = 1;
+  while(capacity < workingSize) capacity = NextCapacity(capacity);
+
+  if(capacity >= fCapacity) return 0;
+
+  bytes = GetBytes() - GetBytes(capacity);
+
+  // TClonesArray::Expand deletes the objects beyond the new size
+  fData->Expand(capacity);
+  fCapacity = capacity;
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+
+const char *ExRootTreeBranch::GetName() const
+{
+  return fData ? fData->GetName() : "";
+}
+
+//------------------------------------------------------------------------------
+
+const char *ExRootTreeBranch::GetClassName() const
+{
+  return fData ? fData->GetClass()->GetName() : "";
+}
+
+//------------------------------------------------------------------------------
+
+Int_t ExRootTreeBranch::NextCapacity(Int_t capacity)
+{
+  if(capacity < 10)
+    return 10;
+  else if(capacity < 30)
+    return 30;
+  else if(capacity < 100)
+    return 100;
+  else if(capacity < 250)
+    return 250;
+  else
+    return capacity * 2;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t ExRootTreeBranch::GetBytes(Int_t capacity) const
+{
+  // TClonesArray keeps two pointer arrays of the pool size
+  return capacity * (fObjectSize + 2 * Long64_t(sizeof(TObject *)));
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTreeBranch::PrintMemoryHeader()
+{
+  ios::fmtflags flags = cout.flags();
+
+  cout << "** " << left << setw(24) << "Pool" << " " << setw(20) << "Class" << right;
+  cout << setw(10) << "Working" << setw(10) << "Capacity" << setw(10) << "Peak";
+  cout << setw(12) << "MB" << setw(12) << "Peak MB" << endl;
+  cout.flags(flags);
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTreeBranch::PrintMemory() const
+{
+  ios::fmtflags flags = cout.flags();
+  streamsize precision = cout.precision();
+
+  cout << "** " << left << setw(24) << GetName() << " " << setw(20) << GetClassName() << right;
+  cout << setw(10) << GetWorkingSize() << setw(10) << fCapacity << setw(10) << fPeakCapacity;
+  cout << fixed << setprecision(2) << setw(12) << GetBytes() / 1048576.0 << setw(12) << GetPeakBytes() / 1048576.0 << endl;
+  cout.flags(flags);
+  cout.precision(precision);
+}
+
+//------------------------------------------------------------------------------
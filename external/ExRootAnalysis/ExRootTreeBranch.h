@@ -6,6 +6,10 @@
  *  Class handling object creation.
  *  It is also used for output ROOT tree branches
  *
+ *  The pool keeps track of its allocated and peak capacity and of the
+ *  largest number of objects used per event over the last two windows
+ *  of events (working set), down to which Trim can shrink it.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
@@ -24,8 +28,35 @@ public:
   TObject *NewEntry();
   void Clear();
 
+  // number of events in a working set window
+  void SetWindow(Int_t events) { fWindow = events > 0 ? events : 1; }
+
+  // release pooled objects beyond the working set, only between events
+  Long64_t Trim();
+
+  const char *GetName() const;
+  const char *GetClassName() const;
+
+  Int_t GetCapacity() const { return fCapacity; }
+  Int_t GetPeakCapacity() const { return fPeakCapacity; }
+  Int_t GetWorkingSize() const { return fWorkingSize > fWindowSize ? fWorkingSize : fWindowSize; }
+
+  // approximate heap footprint, objects are counted at their class size
+  Long64_t GetBytes() const { return GetBytes(fCapacity); }
+  Long64_t GetPeakBytes() const { return GetBytes(fPeakCapacity); }
+
+  void PrintMemory() const;
+  static void PrintMemoryHeader();
+
 private:
+  static Int_t NextCapacity(Int_t capacity);
+
+  Long64_t GetBytes(Int_t capacity) const;
+
   Int_t fSize, fCapacity; //!
+  Int_t fPeakCapacity, fWindowSize, fWorkingSize; //!
+  Int_t fWindow, fClearCounter; //!
+  Long64_t fObjectSize; //!
   TClonesArray *fData; //!
 };
 
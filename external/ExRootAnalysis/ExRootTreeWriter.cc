@@ -9,6 +9,7 @@
 
 #include "ExRootAnalysis/ExRootTreeWriter.h"
 #include "ExRootAnalysis/ExRootTreeBranch.h"
+#include "ExRootAnalysis/ExRootTimeline.h"
 
 #include "TParameter.h"
 #include "TClonesArray.h"
@@ -23,7 +24,7 @@
 using namespace std;
 
 ExRootTreeWriter::ExRootTreeWriter(TFile *file, const char *treeName) :
-  fFile(file), fTree(0), fTreeName(treeName)
+  fFile(file), fTree(0), fTreeName(treeName), fWindow(100), fPeakBytes(0)
 {
 }
 
@@ -42,10 +43,19 @@ ExRootTreeWriter::~ExRootTreeWriter()
 
 //------------------------------------------------------------------------------
 
+void ExRootTreeWriter::SetTreeFile(TFile *file)
+{
+  fFile = file;
+  if(fTree) fTree->SetDirectory(file);
+}
+
+//------------------------------------------------------------------------------
+
 ExRootTreeBranch *ExRootTreeWriter::NewBranch(const char *name, TClass *cl)
 {
   if(!fTree) fTree = NewTree();
   ExRootTreeBranch *branch = new ExRootTreeBranch(name, cl, fTree);
+  branch->SetWindow(fWindow);
   fBranches.insert(branch);
   return branch;
 }
@@ -62,7 +72,22 @@ void ExRootTreeWriter::AddInfo(const char *name, Double_t value)
 
 void ExRootTreeWriter::Fill()
 {
-  if(fTree) fTree->Fill();
+  ExRootTimeline *timeline = ExRootTimeline::GetTimeline();
+  Double_t start;
+  Int_t bytes;
+
+  if(!fTree) return;
+
+  if(timeline && timeline->IsActive())
+  {
+    start = timeline->Now();
+    bytes = fTree->Fill();
+    timeline->AddSpan("Fill", "writer", start, timeline->Now(), timeline->GetEvent(), Form("\"bytes\":%d", bytes));
+  }
+  else
+  {
+    fTree->Fill();
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -77,6 +102,9 @@ void ExRootTreeWriter::Write()
 
 void ExRootTreeWriter::Clear()
 {
+  Long64_t bytes = GetBytes();
+  if(bytes > fPeakBytes) fPeakBytes = bytes;
+
   set<ExRootTreeBranch *>::iterator itBranches;
   for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
   {
@@ -86,6 +114,65 @@ void ExRootTreeWriter::Clear()
 
 //------------------------------------------------------------------------------
 
+void ExRootTreeWriter::SetWindow(Int_t events)
+{
+  fWindow = events;
+
+  set<ExRootTreeBranch *>::iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    (*itBranches)->SetWindow(fWindow);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t ExRootTreeWriter::Trim()
+{
+  Long64_t bytes = 0;
+
+  set<ExRootTreeBranch *>::iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    bytes += (*itBranches)->Trim();
+  }
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t ExRootTreeWriter::GetBytes() const
+{
+  Long64_t bytes = 0;
+
+  set<ExRootTreeBranch *>::const_iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    bytes += (*itBranches)->GetBytes();
+  }
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+
+void ExRootTreeWriter::PrintMemory() const
+{
+  ExRootTreeBranch::PrintMemoryHeader();
+
+  set<ExRootTreeBranch *>::const_iterator itBranches;
+  for(itBranches = fBranches.begin(); itBranches != fBranches.end(); ++itBranches)
+  {
+    (*itBranches)->PrintMemory();
+  }
+
+  cout << "** " << GetName() << ": " << GetBytes() / 1048576.0 << " MB allocated, ";
+  cout << fPeakBytes / 1048576.0 << " MB peak" << endl;
+}
+
+//------------------------------------------------------------------------------
+
 TTree *ExRootTreeWriter::NewTree()
 {
   if(!fFile) return 0;
@@ -24,7 +24,8 @@ public:
   ExRootTreeWriter(TFile *file = 0, const char *treeName = "Analysis");
   ~ExRootTreeWriter();
 
-  void SetTreeFile(TFile *file) { fFile = file; }
+  // moves an existing tree to the new file
+  void SetTreeFile(TFile *file);
   void SetTreeName(const char *name) { fTreeName = name; }
 
   TTree* GetTree() { return fTree; }
@@ -37,6 +38,15 @@ public:
   void Fill();
   void Write();
 
+  // memory accounting of the branch buffers
+  void SetWindow(Int_t events);
+  Long64_t Trim();
+
+  Long64_t GetBytes() const;
+  Long64_t GetPeakBytes() const { return fPeakBytes; }
+
+  void PrintMemory() const;
+
 private:
   TTree *NewTree();
 
@@ -45,6 +55,9 @@ private:
 
   TString fTreeName; //!
 
+  Int_t fWindow; //!
+  Long64_t fPeakBytes; //!
+
   std::set<ExRootTreeBranch *> fBranches; //!
 
   ClassDef(ExRootTreeWriter, 1)
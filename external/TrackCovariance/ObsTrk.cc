@@ -12,7 +12,7 @@
 // Constructors
 //
 // x(3) track origin, p(3) track momentum at origin, Q charge, B ma gnetic field in Tesla
-ObsTrk::ObsTrk(TVector3 x, TVector3 p, Double_t Q, SolGridCov *GC, SolGeom *G)
+ObsTrk::ObsTrk(TVector3 x, TVector3 p, Double_t Q, SolGridCov *GC, SolGeom *G, TRandom *rng)
 {
 	fB = G->B();
 	SetB(fB);
@@ -38,7 +38,7 @@ ObsTrk::ObsTrk(TVector3 x, TVector3 p, Double_t Q, SolGridCov *GC, SolGeom *G)
 	fGenParACTS = ParToACTS(fGenPar);
 	fGenParILC = ParToILC(fGenPar);
 	//
-	fObsPar = GenToObsPar(fGenPar);
+	fObsPar = GenToObsPar(fGenPar, rng);
 	fObsParMm = ParToMm(fObsPar);
 	fObsParACTS = ParToACTS(fObsPar);
 	fObsParILC = ParToILC(fObsPar);
@@ -51,7 +51,7 @@ ObsTrk::ObsTrk(TVector3 x, TVector3 p, Double_t Q, SolGridCov *GC, SolGeom *G)
 }
 //
 // x[3] track origin, p[3] track momentum at origin, Q charge, B magnetic field in Tesla
-ObsTrk::ObsTrk(Double_t *x, Double_t *p, Double_t Q, SolGridCov* GC, SolGeom *G)
+ObsTrk::ObsTrk(Double_t *x, Double_t *p, Double_t Q, SolGridCov* GC, SolGeom *G, TRandom *rng)
 {
 	fB = G->B();
 	SetB(fB);
@@ -77,7 +77,7 @@ ObsTrk::ObsTrk(Double_t *x, Double_t *p, Double_t Q, SolGridCov* GC, SolGeom *G)
 	fGenParACTS = ParToACTS(fGenPar);
 	fGenParILC = ParToILC(fGenPar);
 	//
-	fObsPar = GenToObsPar(fGenPar);
+	fObsPar = GenToObsPar(fGenPar, rng);
 	fObsParMm = ParToMm(fObsPar);
 	fObsParACTS = ParToACTS(fObsPar);
 	fObsParILC = ParToILC(fObsPar);
@@ -110,7 +110,7 @@ ObsTrk::~ObsTrk()
 	fCovILC.Clear();
 }
 //
-TVectorD ObsTrk::GenToObsPar(TVectorD gPar)
+TVectorD ObsTrk::GenToObsPar(const TVectorD &gPar, TRandom *rng)
 {
 	//
 	// Check ranges
@@ -125,7 +125,7 @@ TVectorD ObsTrk::GenToObsPar(TVectorD gPar)
 	//if (angd > maxAn) std::cout << "Warning ObsTrk::GenToObsPar: angle " << angd
 	//	<< " is above grid range of " << maxAn << std::endl;
 	//
-	TMatrixDSym Cov(5);
+	TrkSymMat5 Cov;
 	//
 	// Check if track origin is inside beampipe and betwen the first disks
 	//
@@ -133,9 +133,9 @@ TVectorD ObsTrk::GenToObsPar(TVectorD gPar)
 	Double_t ZinPos = fG->GetZminPos();
 	Double_t ZinNeg = fG->GetZminNeg();
 	Bool_t inside = TrkUtil::IsInside(fGenX, Rin, ZinNeg, ZinPos); // Check if in inner box
-	SolTrack* trk = new SolTrack(fGenX, fGenP, fG);
+	SolTrack trk(fGenX, fGenP, fG);
 	Double_t Xfirst, Yfirst, Zfirst;
-	Int_t iLay = trk->FirstHit(Xfirst, Yfirst, Zfirst);
+	Int_t iLay = trk.FirstHit(Xfirst, Yfirst, Zfirst);
 	fXfirst = TVector3(Xfirst, Yfirst, Zfirst);
   //std::cout<<"obs trk: "<<Xfirst<<","<<Yfirst<<","<<Zfirst<<std::endl;
 
@@ -146,23 +146,23 @@ TVectorD ObsTrk::GenToObsPar(TVectorD gPar)
 		// Observed track parameters
 		Double_t pt = fGenP.Pt();
 		Double_t angd = fGenP.Theta() * 180. / TMath::Pi();
-		Cov = fGC->GetCov(pt, angd);				// Track covariance
+		Cov.Set(fGC->GetCov(pt, angd));				// Track covariance
 	}
 	else
 	{
 		//std::cout<<"ObsTrk:: outside: x= "<<fGenX(0)<<", y= "<<fGenX(1)
                 //                         <<", z= "<<fGenX(2)<<std::endl;
 		Bool_t Res = kTRUE; Bool_t MS = kTRUE;
-		trk->CovCalc(Res, MS);					// Calculate covariance matrix
-		Cov = trk->Cov();
+		trk.CovCalc(Res, MS);					// Calculate covariance matrix
+		Cov.Set(trk.Cov());
 	}					// Track covariance
-	delete trk;
 	//
-	fCov = Cov;
+	Cov.Get(fCov);
 	//
 	// Now do Choleski decomposition and random number extraction, with appropriate stabilization
 	//
-	TVectorD oPar = TrkUtil::CovSmear(gPar, Cov);
+	TVectorD oPar(5);
+	TrkUtil::CovSmear(TrkVec5(gPar), Cov, rng).Get(oPar);
 	//
 	return oPar;
 }
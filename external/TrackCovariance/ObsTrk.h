@@ -49,14 +49,15 @@ private:
 	//
 	// Service routines
 	//
-	TVectorD GenToObsPar(TVectorD gPar);
+	TVectorD GenToObsPar(const TVectorD &gPar, TRandom *rng);
 	//
 public:
 	//
 	// Constructors
 	// x(3) track origin, p(3) track momentum at origin, Q charge, B magnetic field in Tesla
-	ObsTrk(TVector3 x, TVector3 p, Double_t Q, SolGridCov *GC, SolGeom *G);	// Initialize and generate smeared 
-	ObsTrk(Double_t *x, Double_t *p, Double_t Q, SolGridCov* GC, SolGeom *G);	// Initialize and generate smeared track
+	// rng random number generator used for the smearing, gRandom if null
+	ObsTrk(TVector3 x, TVector3 p, Double_t Q, SolGridCov *GC, SolGeom *G, TRandom *rng = 0);	// Initialize and generate smeared 
+	ObsTrk(Double_t *x, Double_t *p, Double_t Q, SolGridCov* GC, SolGeom *G, TRandom *rng = 0);	// Initialize and generate smeared track
 	// Destructor
 	~ObsTrk();
 	//
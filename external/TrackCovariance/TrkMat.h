@@ -0,0 +1,205 @@
+//
+#ifndef G__TRKMAT_H
+#define G__TRKMAT_H
+//
+#include <TMath.h>
+#include <TVectorD.h>
+#include <TMatrixDSym.h>
+//
+// Compile-time sized vectors and matrices for track parameter manipulation.
+// Storage is inline, so temporaries never touch the heap and loops over
+// the fixed dimensions can be fully unrolled by the compiler.
+//
+// TrkVec<N>      : N-vector
+// TrkMat<N, M>   : N x M matrix
+// TrkSymMat<N>   : N x N symmetric matrix, packed lower triangle
+//
+template <Int_t N>
+class TrkVec
+{
+private:
+	Double_t fData[N];
+	//
+public:
+	TrkVec() { Zero(); }
+	explicit TrkVec(const TVectorD &v) { Set(v); }
+	//
+	void Zero() { for (Int_t i = 0; i < N; i++) fData[i] = 0.0; }
+	void Set(const TVectorD &v) { for (Int_t i = 0; i < N; i++) fData[i] = v(i); }
+	void Get(TVectorD &v) const { for (Int_t i = 0; i < N; i++) v(i) = fData[i]; }	// v must have at least N rows
+	//
+	Double_t &operator()(Int_t i) { return fData[i]; }
+	Double_t operator()(Int_t i) const { return fData[i]; }
+	//
+	TrkVec<N> &operator+=(const TrkVec<N> &v) { for (Int_t i = 0; i < N; i++) fData[i] += v(i); return *this; }
+	TrkVec<N> &operator-=(const TrkVec<N> &v) { for (Int_t i = 0; i < N; i++) fData[i] -= v(i); return *this; }
+	TrkVec<N> &operator*=(Double_t a) { for (Int_t i = 0; i < N; i++) fData[i] *= a; return *this; }
+	TrkVec<N> operator+(const TrkVec<N> &v) const { TrkVec<N> r = *this; r += v; return r; }
+	TrkVec<N> operator-(const TrkVec<N> &v) const { TrkVec<N> r = *this; r -= v; return r; }
+	Double_t Dot(const TrkVec<N> &v) const
+	{
+		Double_t sum = 0.0;
+		for (Int_t i = 0; i < N; i++) sum += fData[i] * v(i);
+		return sum;
+	}
+};
+//
+template <Int_t N, Int_t M>
+class TrkMat
+{
+private:
+	Double_t fData[N][M];
+	//
+public:
+	TrkMat() { Zero(); }
+	//
+	void Zero() { for (Int_t i = 0; i < N; i++) for (Int_t j = 0; j < M; j++) fData[i][j] = 0.0; }
+	//
+	Double_t &operator()(Int_t i, Int_t j) { return fData[i][j]; }
+	Double_t operator()(Int_t i, Int_t j) const { return fData[i][j]; }
+	//
+	// Matrix times vector
+	TrkVec<N> operator*(const TrkVec<M> &v) const
+	{
+		TrkVec<N> r;
+		for (Int_t i = 0; i < N; i++)
+		{
+			Double_t sum = 0.0;
+			for (Int_t j = 0; j < M; j++) sum += fData[i][j] * v(j);
+			r(i) = sum;
+		}
+		return r;
+	}
+	//
+	// Transposed matrix times vector
+	TrkVec<M> TransposeTimes(const TrkVec<N> &v) const
+	{
+		TrkVec<M> r;
+		for (Int_t j = 0; j < M; j++)
+		{
+			Double_t sum = 0.0;
+			for (Int_t i = 0; i < N; i++) sum += fData[i][j] * v(i);
+			r(j) = sum;
+		}
+		return r;
+	}
+};
+//
+template <Int_t N>
+class TrkSymMat
+{
+private:
+	Double_t fData[N * (N + 1) / 2];	// Packed lower triangle, row by row
+	//
+	static Int_t Index(Int_t i, Int_t j) { return i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i; }
+	//
+public:
+	TrkSymMat() { Zero(); }
+	explicit TrkSymMat(const TMatrixDSym &m) { Set(m); }
+	//
+	void Zero() { for (Int_t i = 0; i < N * (N + 1) / 2; i++) fData[i] = 0.0; }
+	void Set(const TMatrixDSym &m)
+	{
+		for (Int_t i = 0; i < N; i++) for (Int_t j = 0; j <= i; j++) fData[Index(i, j)] = m(i, j);
+	}
+	void Get(TMatrixDSym &m) const	// Fills the upper left N x N block of m
+	{
+		for (Int_t i = 0; i < N; i++) for (Int_t j = 0; j <= i; j++) m(i, j) = m(j, i) = fData[Index(i, j)];
+	}
+	//
+	Double_t &operator()(Int_t i, Int_t j) { return fData[Index(i, j)]; }
+	Double_t operator()(Int_t i, Int_t j) const { return fData[Index(i, j)]; }
+	//
+	TrkSymMat<N> &operator+=(const TrkSymMat<N> &m) { for (Int_t i = 0; i < N * (N + 1) / 2; i++) fData[i] += m.fData[i]; return *this; }
+	TrkSymMat<N> &operator-=(const TrkSymMat<N> &m) { for (Int_t i = 0; i < N * (N + 1) / 2; i++) fData[i] -= m.fData[i]; return *this; }
+	TrkSymMat<N> operator+(const TrkSymMat<N> &m) const { TrkSymMat<N> r = *this; r += m; return r; }
+	TrkSymMat<N> operator-(const TrkSymMat<N> &m) const { TrkSymMat<N> r = *this; r -= m; return r; }
+	//
+	// Matrix times vector
+	TrkVec<N> operator*(const TrkVec<N> &v) const
+	{
+		TrkVec<N> r;
+		for (Int_t i = 0; i < N; i++)
+		{
+			Double_t sum = 0.0;
+			for (Int_t j = 0; j < N; j++) sum += (*this)(i, j) * v(j);
+			r(i) = sum;
+		}
+		return r;
+	}
+	//
+	// this += alpha * v * v^T
+	void Rank1Update(const TrkVec<N> &v, Double_t alpha)
+	{
+		for (Int_t i = 0; i < N; i++) for (Int_t j = 0; j <= i; j++) fData[Index(i, j)] += alpha * v(i) * v(j);
+	}
+	//
+	// Quadratic form v^T * this * v
+	Double_t Similarity(const TrkVec<N> &v) const { return v.Dot((*this) * v); }
+	//
+	// Choleski decomposition this = L * L^T, L lower triangular
+	// Returns kFALSE if the matrix is not positive definite
+	Bool_t Cholesky(TrkMat<N, N> &L) const
+	{
+		L.Zero();
+		for (Int_t j = 0; j < N; j++)
+		{
+			Double_t sum = (*this)(j, j);
+			for (Int_t k = 0; k < j; k++) sum -= L(j, k) * L(j, k);
+			if (sum <= 0.0) return kFALSE;
+			Double_t d = TMath::Sqrt(sum);
+			L(j, j) = d;
+			for (Int_t i = j + 1; i < N; i++)
+			{
+				Double_t s = (*this)(i, j);
+				for (Int_t k = 0; k < j; k++) s -= L(i, k) * L(j, k);
+				L(i, j) = s / d;
+			}
+		}
+		return kTRUE;
+	}
+	//
+	// Similarity transform A * this * A^T
+	template <Int_t M>
+	TrkSymMat<M> Similarity(const TrkMat<M, N> &A) const
+	{
+		TrkMat<M, N> AC;
+		for (Int_t i = 0; i < M; i++)
+		{
+			for (Int_t j = 0; j < N; j++)
+			{
+				Double_t sum = 0.0;
+				for (Int_t k = 0; k < N; k++) sum += A(i, k) * (*this)(k, j);
+				AC(i, j) = sum;
+			}
+		}
+		TrkSymMat<M> r;
+		for (Int_t i = 0; i < M; i++)
+		{
+			for (Int_t j = 0; j <= i; j++)
+			{
+				Double_t sum = 0.0;
+				for (Int_t k = 0; k < N; k++) sum += AC(i, k) * A(j, k);
+				r(i, j) = sum;
+			}
+		}
+		return r;
+	}
+	//
+	// Similarity transform S * this * S with S symmetric
+	TrkSymMat<N> Similarity(const TrkSymMat<N> &S) const
+	{
+		TrkMat<N, N> Sm;
+		for (Int_t i = 0; i < N; i++) for (Int_t j = 0; j < N; j++) Sm(i, j) = S(i, j);
+		return Similarity(Sm);
+	}
+};
+//
+typedef TrkVec<5> TrkVec5;
+typedef TrkMat<5, 5> TrkMat5;
+typedef TrkSymMat<5> TrkSymMat5;
+typedef TrkVec<3> TrkVec3;
+typedef TrkMat<3, 5> TrkMat35;
+typedef TrkSymMat<3> TrkSymMat3;
+//
+#endif
@@ -62,7 +62,7 @@ void TrkUtil::LineDistance(TVector3 x0, TVector3 y0, TVector3 dirx, TVector3 dir
 //
 // Covariance smearing
 //
-TVectorD TrkUtil::CovSmear(TVectorD x, TMatrixDSym C)
+TVectorD TrkUtil::CovSmear(const TVectorD &x, const TMatrixDSym &C, TRandom *rng)
 {
 	//
 	// Check arrays
@@ -75,6 +75,15 @@ TVectorD TrkUtil::CovSmear(TVectorD x, TMatrixDSym C)
 		std::cout << "TrkUtil::CovSmear: vector/matrix mismatch. Aborting." << std::endl;
 		exit(EXIT_FAILURE);
 	}
+	//
+	// Track parameters: use fixed size version
+	//
+	if (Nvec == 5)
+	{
+		TVectorD xOut(5);
+		CovSmear(TrkVec5(x), TrkSymMat5(C), rng).Get(xOut);
+		return xOut;
+	}
 	// Positive diagonal elements
 	for (Int_t i = 0; i < Nvec; i++)
 	{
@@ -107,12 +116,50 @@ TVectorD TrkUtil::CovSmear(TVectorD x, TMatrixDSym C)
 	TMatrixD U = Chl.GetU();			// Get Upper triangular matrix
 	TMatrixD Ut(TMatrixD::kTransposed, U); // Transposed of U (lower triangular)
 	TVectorD r(Nvec);
-	for (Int_t i = 0; i < Nvec; i++)r(i) = gRandom->Gaus(0.0, 1.0);		// Array of normal random numbers
+	if (!rng) rng = gRandom;
+	for (Int_t i = 0; i < Nvec; i++)r(i) = rng->Gaus(0.0, 1.0);		// Array of normal random numbers
 	TVectorD xOut = x + DCv * (Ut * r);	// Observed parameter vector
 	//
 	return xOut;
 }
 //
+// Same as above for 5 track parameters, without heap allocation
+//
+TrkVec5 TrkUtil::CovSmear(const TrkVec5 &x, const TrkSymMat5 &C, TRandom *rng)
+{
+	// Positive diagonal elements
+	TrkVec5 DCv;
+	for (Int_t i = 0; i < 5; i++)
+	{
+		if (C(i, i) <= 0.0)
+		{
+			std::cout << "TrkUtil::CovSmear: covariance matrix has negative diagonal elements. Aborting." << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		DCv(i) = TMath::Sqrt(C(i, i));
+	}
+	//
+	// Normalize diagonal to 1 and do a Choleski decomposition
+	//
+	TrkSymMat5 CvN;
+	for (Int_t i = 0; i < 5; i++)
+		for (Int_t j = 0; j <= i; j++) CvN(i, j) = C(i, j) / (DCv(i) * DCv(j));
+	TrkMat5 L;
+	if (!CvN.Cholesky(L))
+	{
+		std::cout << "TrkUtil::CovSmear: covariance matrix is not positive definite. Aborting." << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	TrkVec5 r;
+	if (!rng) rng = gRandom;
+	for (Int_t i = 0; i < 5; i++)r(i) = rng->Gaus(0.0, 1.0);		// Array of normal random numbers
+	TrkVec5 Lr = L * r;
+	TrkVec5 xOut;
+	for (Int_t i = 0; i < 5; i++) xOut(i) = x(i) + DCv(i) * Lr(i);	// Observed parameter vector
+	//
+	return xOut;
+}
+//
 // Helix parameters from position and momentum
 // static
 TVectorD TrkUtil::XPtoPar(TVector3 x, TVector3 p, Double_t Q, Double_t Bz)
@@ -218,27 +265,30 @@ TVectorD TrkUtil::ParToACTS(TVectorD Par)
 	return pACTS;
 }
 // Covariance conversion to ACTS format
-TMatrixDSym TrkUtil::CovToACTS(TVectorD Par, TMatrixDSym Cov)
+TMatrixDSym TrkUtil::CovToACTS(const TVectorD &Par, const TMatrixDSym &Cov)
+{
+	TMatrixDSym cACTS(6);
+	CovToACTS(TrkVec5(Par), TrkSymMat5(Cov)).Get(cACTS);
+	//
+	return cACTS;
+}
+//
+TrkSymMat<6> TrkUtil::CovToACTS(const TrkVec5 &Par, const TrkSymMat5 &Cov)
 {
-	TMatrixDSym cACTS(6); cACTS.Zero();
 	Double_t b = -cSpeed() * fBz / 2.;
 	//
-	// Fill derivative matrix
-	TMatrixD A(5, 5);	A.Zero();
+	// Fill derivative matrix (ACTS, Delphes)
+	TrkMat<6, 5> A;
 	Double_t ct = Par(4);	// cot(theta)
 	Double_t C = Par(2);		// half curvature
 	A(0, 0) = 1000.;		// D-D	conversion to mm
-	A(1, 2) = 1.0;		// phi0-phi0
-	A(2, 4) = 1.0 / (sqrt(1.0 + ct * ct) * b);	// q/p-C
-	A(3, 1) = 1000.;		// z0-z0 conversion to mm
-	A(4, 3) = -1.0 / (1.0 + ct * ct); // theta - cot(theta)
+	A(2, 1) = 1.0;		// phi0-phi0
+	A(4, 2) = 1.0 / (sqrt(1.0 + ct * ct) * b);	// q/p-C
+	A(1, 3) = 1000.;		// z0-z0 conversion to mm
+	A(3, 4) = -1.0 / (1.0 + ct * ct); // theta - cot(theta)
 	A(4, 4) = -C * ct / (b * pow(1.0 + ct * ct, 3.0 / 2.0)); // q/p-cot(theta)
 	//
-	TMatrixDSym Cv = Cov;
-	TMatrixD At(5, 5);
-	At.Transpose(A);
-	Cv.Similarity(At);
-	TMatrixDSub(cACTS, 0, 4, 0, 4) = Cv;
+	TrkSymMat<6> cACTS = Cov.Similarity(A);
 	cACTS(5, 5) = 0.1;	// Currently undefined: set to arbitrary value to avoid crashes
 	//
 	return cACTS;
@@ -258,24 +308,27 @@ TVectorD TrkUtil::ParToILC(TVectorD Par)
 	return pILC;
 }
 // Covariance conversion to ILC format
-TMatrixDSym TrkUtil::CovToILC(TMatrixDSym Cov)
+TMatrixDSym TrkUtil::CovToILC(const TMatrixDSym &Cov)
 {
-	TMatrixDSym cILC(5); cILC.Zero();
-	//
-	// Fill derivative matrix
-	TMatrixD A(5, 5);	A.Zero();
+	TMatrixDSym cILC(5);
+	CovToILC(TrkSymMat5(Cov)).Get(cILC);
 	//
-	A(0, 0) = 1.0e3;		// D-d0 in mm
-	A(1, 1) = 1.0;			// phi0-phi0
-	A(2, 2) = -2.0e-3;		// w-C
-	A(3, 3) = 1.0e3;		// z0-z0 conversion to mm
-	A(4, 4) = 1.0;			// tan(lambda) - cot(theta)
+	return cILC;
+}
+//
+TrkSymMat5 TrkUtil::CovToILC(const TrkSymMat5 &Cov)
+{
+	// Diagonal derivative matrix
+	const Double_t A[5] = {
+		1.0e3,		// D-d0 in mm
+		1.0,		// phi0-phi0
+		-2.0e-3,	// w-C
+		1.0e3,		// z0-z0 conversion to mm
+		1.0 };		// tan(lambda) - cot(theta)
 	//
-	TMatrixDSym Cv = Cov;
-	TMatrixD At(5, 5);
-	At.Transpose(A);
-	Cv.Similarity(At);
-	cILC = Cv;
+	TrkSymMat5 cILC;
+	for (Int_t i = 0; i < 5; i++)
+		for (Int_t j = 0; j <= i; j++) cILC(i, j) = A[i] * Cov(i, j) * A[j];
 	//
 	return cILC;
 }
@@ -293,24 +346,26 @@ TVectorD TrkUtil::ParToMm(TVectorD Par)				// Parameter conversion
 	//
 	return Pmm;
 }
-TMatrixDSym TrkUtil::CovToMm(TMatrixDSym Cov)		// Covariance conversion
+TMatrixDSym TrkUtil::CovToMm(const TMatrixDSym &Cov)		// Covariance conversion
 {
-	TMatrixDSym Cmm(5); Cmm.Zero();
+	TMatrixDSym Cmm(5);
+	CovToMm(TrkSymMat5(Cov)).Get(Cmm);
 	//
-	// Fill derivative matrix
-	TMatrixD A(5, 5);	A.Zero();
-	//
-	A(0, 0) = 1.0e3;		// D-d0 in mm
-	A(1, 1) = 1.0;			// phi0-phi0
-	A(2, 2) = 1.0e-3;		// C-C
-	A(3, 3) = 1.0e3;		// z0-z0 conversion to mm
-	A(4, 4) = 1.0;			// lambda - cot(theta)
+	return Cmm;
+}
+TrkSymMat5 TrkUtil::CovToMm(const TrkSymMat5 &Cov)		// Covariance conversion
+{
+	// Diagonal derivative matrix
+	const Double_t A[5] = {
+		1.0e3,		// D-d0 in mm
+		1.0,		// phi0-phi0
+		1.0e-3,		// C-C
+		1.0e3,		// z0-z0 conversion to mm
+		1.0 };		// lambda - cot(theta)
 	//
-	TMatrixDSym Cv = Cov;
-	TMatrixD At(5, 5);
-	At.Transpose(A);
-	Cv.Similarity(At);
-	Cmm = Cv;
+	TrkSymMat5 Cmm;
+	for (Int_t i = 0; i < 5; i++)
+		for (Int_t j = 0; j <= i; j++) Cmm(i, j) = A[i] * Cov(i, j) * A[j];
 	//
 	return Cmm;
 }//
@@ -766,7 +821,7 @@ Double_t TrkUtil::TrkLen(TVectorD Par)
 }
 //
 // Return number of ionization clusters
-Bool_t TrkUtil::IonClusters(Double_t& Ncl, Double_t mass, TVectorD Par)
+Bool_t TrkUtil::IonClusters(Double_t& Ncl, Double_t mass, TVectorD Par, TRandom *rng)
 {
 	//
 	// Units are meters/Tesla/GeV
@@ -805,7 +860,7 @@ Bool_t TrkUtil::IonClusters(Double_t& Ncl, Double_t mass, TVectorD Par)
 			bg = p.Mag() / mass;
 			muClu = Nclusters(bg) * tLen;				// Avg. number of clusters
 
-			Ncl = gRandom->PoissonD(muClu);			// Actual number of clusters
+			Ncl = (rng ? rng : gRandom)->PoissonD(muClu);	// Actual number of clusters
 		}
 
 	}
@@ -7,6 +7,7 @@
 #include <TMatrixDSym.h>
 #include <TRandom.h>
 #include <TMath.h>
+#include "TrkMat.h"
 //
 //
 // Class test
@@ -39,12 +40,14 @@ protected:
 	// Conversion to ACTS parametrization
 	//
 	TVectorD ParToACTS(TVectorD Par);		// Parameter conversion
-	TMatrixDSym CovToACTS(TVectorD Par, TMatrixDSym Cov);	// Covariance conversion
+	TMatrixDSym CovToACTS(const TVectorD &Par, const TMatrixDSym &Cov);	// Covariance conversion
+	TrkSymMat<6> CovToACTS(const TrkVec5 &Par, const TrkSymMat5 &Cov);	// Covariance conversion (fixed size)
 	//
 	// Conversion to ILC parametrization
 	//
 	TVectorD ParToILC(TVectorD Par);		// Parameter conversion
-	TMatrixDSym CovToILC(TMatrixDSym Cov);	// Covariance conversion
+	TMatrixDSym CovToILC(const TMatrixDSym &Cov);	// Covariance conversion
+	TrkSymMat5 CovToILC(const TrkSymMat5 &Cov);	// Covariance conversion (fixed size)
 	//
 
 public:
@@ -80,14 +83,16 @@ public:
 	TVectorD derRphi_Z(TVectorD par, Double_t z);		// Derivatives of R-phi at constant z
 	TVectorD derR_Z(TVectorD par, Double_t z);		// Derivatives of R at constant z
 	//
-	// Smear with given covariance matrix
+	// Smear with given covariance matrix (random numbers from rng, gRandom if null)
 	//
-	static TVectorD CovSmear(TVectorD x, TMatrixDSym C);
+	static TVectorD CovSmear(const TVectorD &x, const TMatrixDSym &C, TRandom *rng = 0);
+	static TrkVec5 CovSmear(const TrkVec5 &x, const TrkSymMat5 &C, TRandom *rng = 0);	// Fixed size, no heap allocation
 	//
 	// Conversion from meters to mm
 	//
 	static TVectorD ParToMm(TVectorD Par);			// Parameter conversion
-	static TMatrixDSym CovToMm(TMatrixDSym Cov);		// Covariance conversion
+	static TMatrixDSym CovToMm(const TMatrixDSym &Cov);		// Covariance conversion
+	static TrkSymMat5 CovToMm(const TrkSymMat5 &Cov);		// Covariance conversion (fixed size)
 	//
 	// Inside cylindrical volume
 	//
@@ -105,8 +110,8 @@ public:
 	void SetDchBoundaries(Double_t Rmin, Double_t Rmax, Double_t Zmin, Double_t Zmax);
 	// Gas mixture selection
 	void SetGasMix(Int_t Opt);
-	// Get number of ionization clusters
-	Bool_t IonClusters(Double_t &Ncl, Double_t mass, TVectorD Par);
+	// Get number of ionization clusters (random numbers from rng, gRandom if null)
+	Bool_t IonClusters(Double_t &Ncl, Double_t mass, TVectorD Par, TRandom *rng = 0);
 	Double_t Nclusters(Double_t bgam);	// mean clusters/meter vs beta*gamma
 	static Double_t Nclusters(Double_t bgam, Int_t Opt);	// mean clusters/meter vs beta*gamma
 	Double_t funcNcl(Double_t *xp, Double_t *par);
@@ -6,7 +6,6 @@ Vertex fitting code
 #include <TVector3.h>
 #include <TMatrixD.h>
 #include <TMatrixDSym.h>
-#include <TMatrixDSymEigen.h>
 #include "VertexFit.h"
 //
 // Constructors
@@ -19,128 +18,170 @@ VertexFit::VertexFit()
 	fRstart = -1.0;
 	fVtxDone = kFALSE;
 	fVtxCst = kFALSE;
-	fxCst.ResizeTo(3);
-	fCovCst.ResizeTo(3, 3);
-	fCovCstInv.ResizeTo(3, 3);
-	fXv.ResizeTo(3);
-	fcovXv.ResizeTo(3, 3);
+	fChi2 = 0.0;
 }
 //
 // Build from list of parameters and covariances
 VertexFit::VertexFit(Int_t Ntr, TVectorD** trkPar, TMatrixDSym** trkCov)
 {
-	fNtr = Ntr;
+	fNtr = 0;
 	fRstart = -1.0;
 	fVtxDone = kFALSE;
 	fVtxCst = kFALSE;
-	fxCst.ResizeTo(3);
-	fCovCst.ResizeTo(3, 3);
-	fCovCstInv.ResizeTo(3, 3);
-	fXv.ResizeTo(3);
-	fcovXv.ResizeTo(3, 3);
+	fChi2 = 0.0;
 	//
-	for (Int_t i = 0; i < fNtr; i++)
-	{
-		fPar.push_back(new TVectorD(*trkPar[i]));
-		fParNew.push_back(new TVectorD(*trkPar[i]));
-		fCov.push_back(new TMatrixDSym(*trkCov[i]));
-		fCovNew.push_back(new TMatrixDSym(*trkCov[i]));
-	}
-	fChi2List.ResizeTo(fNtr);
+	fTrk.reserve(Ntr);
+	for (Int_t i = 0; i < Ntr; i++) InitTrk(*trkPar[i], *trkCov[i]);
 	//
 }
 //
 // Build from ObsTrk list of tracks
 VertexFit::VertexFit(Int_t Ntr, ObsTrk** track)
 {
-	fNtr = Ntr;
+	fNtr = 0;
 	fRstart = -1.0;
 	fVtxDone = kFALSE;
 	fVtxCst = kFALSE;
-	fxCst.ResizeTo(3);
-	fCovCst.ResizeTo(3, 3);
-	fCovCstInv.ResizeTo(3, 3);
-	fXv.ResizeTo(3);
-	fcovXv.ResizeTo(3, 3);
+	fChi2 = 0.0;
 	//
-	fChi2List.ResizeTo(fNtr);
-	for (Int_t i = 0; i < fNtr; i++)
-	{
-		fPar.push_back(new TVectorD(track[i]->GetObsPar()));
-		fParNew.push_back(new TVectorD(track[i]->GetObsPar()));
-		fCov.push_back(new TMatrixDSym(track[i]->GetCov()));
-		fCovNew.push_back(new TMatrixDSym(track[i]->GetCov()));
-	}
+	fTrk.reserve(Ntr);
+	for (Int_t i = 0; i < Ntr; i++) InitTrk(track[i]->GetObsPar(), track[i]->GetCov());
 }
 //
 // Destructor
 //
-void VertexFit::ResetWrkArrays()
-{
-	Int_t N = (Int_t)fdi.size();
-	if(N > 0){
-		for (Int_t i = 0; i < N; i++)
-		{
-			if (fx0i[i])  { fx0i[i]->Clear();	delete fx0i[i]; }
-			if (fai[i])   { fai[i]->Clear();	delete fai[i]; }
-			if (fdi[i])   { fdi[i]->Clear();	delete fdi[i]; }
-			if (fAti[i])  { fAti[i]->Clear();	delete fAti[i]; }
-			if (fDi[i])   { fDi[i]->Clear();	delete fDi[i]; }
-			if (fWi[i])   { fWi[i]->Clear();	delete fWi[i]; }
-			if (fWinvi[i]){ fWinvi[i]->Clear();     delete fWinvi[i]; }
-		}
-		fa2i.clear();
-		fx0i.clear();
-		fai.clear();
-		fdi.clear();
-		fAti.clear();
-		fDi.clear();
-		fWi.clear();
-		fWinvi.clear();
-	}
-}
 VertexFit::~VertexFit()
 {	
-	fxCst.Clear();		
-	fCovCst.Clear();
-	fCovCstInv.Clear();
-	fXv.Clear();		
-	fcovXv.Clear();		
-	fChi2List.Clear();
+	fTrk.clear();
+	fNtr = 0;
+}
+//
+// Append a track block
+void VertexFit::InitTrk(const TVectorD &par, const TMatrixDSym &Cov)
+{
+	fTrk.push_back(TrkBlock());
+	TrkBlock &t = fTrk.back();
+	t.par.Set(par);
+	t.parNew.Set(par);
+	t.cov.Set(Cov);
+	t.fi = 0.0;
+	t.chi2 = 0.0;
+	fNtr++;
+}
+//
+// Remove all tracks and constraints. Track blocks keep their capacity,
+// so fitting many vertices with the same object does not allocate.
+void VertexFit::Reset()
+{
+	fTrk.clear();
+	fNtr = 0;
+	fRstart = -1.0;
+	fVtxDone = kFALSE;
+	fVtxCst = kFALSE;
+	fChi2 = 0.0;
+	fXv.Zero();
+	fcovXv.Zero();
+}
+//
+// Regularized inversion of 2D and 3D symmetric matrices
+// (same algorithm as TrkUtil::RegInv, with fixed size matrices)
+//
+TrkSymMat<2> VertexFit::RegInv2(const TrkSymMat<2> &M)
+{
+	Double_t D[2];
+	TrkSymMat<2> R, Rinv, Minv;
 	//
-	for (Int_t i = 0; i < fNtr; i++)
+	// Check for 0's and normalize
+	for (Int_t i = 0; i < 2; i++)
 	{
-		fPar[i]->Clear();		delete fPar[i];
-		fParNew[i]->Clear();	delete fParNew[i];
-		fCov[i]->Clear();		delete fCov[i];
-		fCovNew[i]->Clear();	delete fCovNew[i];
-	}	
-	fPar.clear();
-	fParNew.clear();
-	fCov.clear();
-	fCovNew.clear();		
-	//
-	ResetWrkArrays();
-	ffi.clear();	
-	fNtr = 0;
+		if (M(i, i) != 0.0) D[i] = 1. / TMath::Sqrt(TMath::Abs(M(i, i)));
+		else D[i] = 1.0;
+	}
+	for (Int_t i = 0; i < 2; i++) for (Int_t j = 0; j <= i; j++) R(i, j) = D[i] * M(i, j) * D[j];
+	//
+	Double_t det = R(0, 0) * R(1, 1) - R(0, 1) * R(1, 0);
+	if (det == 0)
+	{
+		std::cout << "VertexFit::RegInv: null determinant for N = 2" << std::endl;
+		return Minv;	// Return null matrix
+	}
+	// invert matrix 
+	Rinv(0, 0) = R(1, 1) / det;
+	Rinv(0, 1) = -R(0, 1) / det;
+	Rinv(1, 1) = R(0, 0) / det;
+	//
+	for (Int_t i = 0; i < 2; i++) for (Int_t j = 0; j <= i; j++) Minv(i, j) = D[i] * Rinv(i, j) * D[j];
+	return Minv;
 }
 //
+TrkSymMat3 VertexFit::RegInv3(const TrkSymMat3 &M)
+{
+	Double_t D[3];
+	TrkSymMat3 R, Rinv, Minv;
+	//
+	// Check for 0's and normalize
+	for (Int_t i = 0; i < 3; i++)
+	{
+		if (M(i, i) != 0.0) D[i] = 1. / TMath::Sqrt(TMath::Abs(M(i, i)));
+		else D[i] = 1.0;
+	}
+	for (Int_t i = 0; i < 3; i++) for (Int_t j = 0; j <= i; j++) R(i, j) = D[i] * M(i, j) * D[j];
+	//
+	// Break up matrix
+	TrkSymMat<2> Q;							// Upper left
+	for (Int_t i = 0; i < 2; i++) for (Int_t j = 0; j <= i; j++) Q(i, j) = R(i, j);
+	TrkVec<2> p;
+	for (Int_t i = 0; i < 2; i++) p(i) = R(2, i);
+	Double_t q = R(2, 2);
+	//
+	// Invert pieces and re-assemble
+	TrkSymMat<2> A;
+	if (TMath::Abs(q) > 1.0e-15)
+	{
+		// Case |q| > 0
+		TrkSymMat<2> Ainv = Q;
+		Ainv.Rank1Update(p, -1.0 / q);
+		A = RegInv2(Ainv);
+		TrkVec<2> b = A * p;
+		b *= -1.0 / q;
+		for (Int_t i = 0; i < 2; i++) Rinv(2, i) = b(i);
+		Rinv(2, 2) = (1.0 - p.Dot(b)) / q;
+	}
+	else
+	{
+		// case q = 0
+		TrkSymMat<2> Qinv = RegInv2(Q);
+		Double_t a = Qinv.Similarity(p);
+		Rinv(2, 2) = -1.0 / a;
+		//
+		TrkVec<2> b = Qinv * p;
+		b *= 1.0 / a;
+		for (Int_t i = 0; i < 2; i++) Rinv(2, i) = b(i);
+		//
+		A = Q;
+		A.Rank1Update(p, -1 / a);
+		A = A.Similarity(Qinv);
+	}
+	for (Int_t i = 0; i < 2; i++) for (Int_t j = 0; j <= i; j++) Rinv(i, j) = A(i, j);
+	//
+	for (Int_t i = 0; i < 3; i++) for (Int_t j = 0; j <= i; j++) Minv(i, j) = D[i] * Rinv(i, j) * D[j];
+	return Minv;
+}
 //
+// Track trajectory and derivatives
 //
-TVectorD VertexFit::Fill_x0(TVectorD par)
+TrkVec3 VertexFit::Fill_x0(const TrkVec5 &par)
 {
 	//
 	// Calculate track 3D position at R = |D| (minimum approach to z-axis)
 	//
-	TVectorD x0(3);
+	TrkVec3 x0;
 	//
 	// Decode input arrays
 	//
 	Double_t D = par(0);
 	Double_t p0 = par(1);
-	Double_t C = par(2);
 	Double_t z0 = par(3);
-	Double_t ct = par(4);
 	//
 	x0(0) = -D * TMath::Sin(p0);
 	x0(1) = D * TMath::Cos(p0);
@@ -149,22 +190,20 @@ TVectorD VertexFit::Fill_x0(TVectorD par)
 	return x0;
 }
 //
-TVectorD VertexFit::Fill_x(TVectorD par, Double_t phi)
+TrkVec3 VertexFit::Fill_x(const TrkVec5 &par, Double_t phi)
 {
 	//
 	// Calculate track 3D position for a given phase, phi
 	//
-	TVectorD x(3);
+	TrkVec3 x;
 	//
 	// Decode input arrays
 	//
-	Double_t D = par(0);
 	Double_t p0 = par(1);
 	Double_t C = par(2);
-	Double_t z0 = par(3);
 	Double_t ct = par(4);
 	//
-	TVectorD x0 = Fill_x0(par);
+	TrkVec3 x0 = Fill_x0(par);
 	x(0) = x0(0) + (TMath::Sin(phi + p0) - TMath::Sin(p0)) / (2 * C);
 	x(1) = x0(1) - (TMath::Cos(phi + p0) - TMath::Cos(p0)) / (2 * C);
 	x(2) = x0(2) + ct * phi / (2 * C);
@@ -172,128 +211,172 @@ TVectorD VertexFit::Fill_x(TVectorD par, Double_t phi)
 	return x;
 }
 //
-void VertexFit::UpdateTrkArrays(Int_t i)
+TrkMat35 VertexFit::Fill_A(const TrkVec5 &par, Double_t s)
 {
 	//
-	// Get track parameters, covariance and phase
-	Double_t fs = ffi[i];			// Get phase
-	TVectorD par = *fParNew[i];
-	TMatrixDSym Cov = *fCov[i];
-	//
-	// Fill all track related work arrays arrays
-	TMatrixD A = derXdPar(par, fs);		// A = dx/da = derivatives wrt track parameters
-	TMatrixDSym Winv = Cov;				
-	Winv.Similarity(A);			// W^-1 = A*C*A'
-
-	TMatrixD At(TMatrixD::kTransposed, A);		// A transposed
-	fAti.push_back(new TMatrixD(At));		// Store A'
-	fWinvi.push_back(new TMatrixDSym(Winv));	// Store W^-1 matrix
-	//
-	TVectorD xs = Fill_x(par, fs);
-	fx0i.push_back(new TVectorD(xs));			// Start helix position
-	// 
-	TVectorD di = A * (par - *fPar[i]);			// x-shift
-	fdi.push_back(new TVectorD(di));			// Store x-shift	
-	//
-	TMatrixDSym W = RegInv(Winv);				// W = (A*C*A')^-1
-	fWi.push_back(new TMatrixDSym(W));			// Store W matrix
-	//
-	TVectorD a = derXds(par, fs);				// a = dx/ds = derivatives wrt phase
-	fai.push_back(new TVectorD(a));				// Store a
-	//
-	Double_t a2 = W.Similarity(a);
-	fa2i.push_back(a2);							// Store a2
-	//
-	// Build D matrix
-	TMatrixDSym B(3);
-	B.Rank1Update(a, -1. / a2);
-	B.Similarity(W);
-	TMatrixDSym Ds = W + B;						// D matrix
-	fDi.push_back(new TMatrixDSym(Ds));			// Store D matrix
+	// Derivatives of track position wrt track parameters (see TrkUtil::derXdPar)
+	//
+	TrkMat35 dxdp;
+	//
+	// unpack parameters
+	Double_t D = par(0);
+	Double_t p0 = par(1);
+	Double_t C = par(2);
+	Double_t ct = par(4);
+	//
+	// dx/dD
+	dxdp(0, 0) = -TMath::Sin(p0);
+	dxdp(1, 0) =  TMath::Cos(p0);
+	// dx/dphi0
+	dxdp(0, 1) = -D * TMath::Cos(p0) + (TMath::Cos(s + p0) - TMath::Cos(p0)) / (2 * C);
+	dxdp(1, 1) = -D * TMath::Sin(p0) + (TMath::Sin(s + p0) - TMath::Sin(p0)) / (2 * C);
+	// dx/dC
+	dxdp(0, 2) = -(TMath::Sin(s + p0) - TMath::Sin(p0)) / (2 * C * C);
+	dxdp(1, 2) =  (TMath::Cos(s + p0) - TMath::Cos(p0)) / (2 * C * C);
+	dxdp(2, 2) = -ct * s / (2 * C * C);
+	// dx/dz0
+	dxdp(2, 3) = 1.;
+	// dx/dCtg
+	dxdp(2, 4) = s / (2 * C);
+	//
+	return dxdp;
 }
 //
-void VertexFit::VtxFitNoSteer()
+TrkVec3 VertexFit::Fill_a(const TrkVec5 &par, Double_t s)
 {
 	//
-	// Initialize
+	// Derivatives of track position wrt phase (see TrkUtil::derXds)
 	//
-	std::vector<TVectorD*> x0i;				// Tracks at ma
-	std::vector<TVectorD*> ni;				// Track derivative wrt phase
-	std::vector<TMatrixDSym*> Ci;				// Position error matrix at fixed phase
-	std::vector<TVectorD*> wi;				// Ci*ni
-	std::vector<Double_t> s_in;				// Starting phase
+	TrkVec3 dxds;
 	//
-	// 
+	// unpack parameters
+	Double_t p0 = par(1);
+	Double_t C = par(2);
+	Double_t ct = par(4);
 	//
-	// Track loop
-	for (Int_t i = 0; i < fNtr; i++)
-	{
-		TVectorD par = *fPar[i];
-		TMatrixDSym Cov = *fCov[i];
-		Double_t s = 0.;
-		// Case when starting radius is provided
-		if(fRstart > TMath::Abs(par(0))){
-			s = 2.*TMath::ASin(par(2)*TMath::Sqrt((fRstart*fRstart-par(0)*par(0))/(1.+2.*par(2)*par(0))));
-		}
-		//
-		x0i.push_back(new TVectorD(Fill_x(par, s)));
-		ni.push_back(new TVectorD(derXds(par, s)));
-		TMatrixD A = derXdPar(par, s);
-		Ci.push_back(new TMatrixDSym(Cov.Similarity(A)));
-		TMatrixDSym Cinv = RegInv(*Ci[i]);
-		wi.push_back(new TVectorD(Cinv * (*ni[i])));
-		s_in.push_back(s);
+	dxds(0) = TMath::Cos(s + p0) / (2 * C);
+	dxds(1) = TMath::Sin(s + p0) / (2 * C);
+	dxds(2) = ct / (2 * C);
+	//
+	return dxds;
+}
+//
+void VertexFit::UpdateTrkArrays(TrkBlock &t)
+{
+	//
+	// Fill all track related work arrays
+	t.A = Fill_A(t.parNew, t.fi);			// A = dx/da = derivatives wrt track parameters
+	t.Winv = t.cov.Similarity(t.A);			// W^-1 = A*C*A'
+	t.x0 = Fill_x(t.parNew, t.fi);			// Start helix position
+	t.d = t.A * (t.parNew - t.par);			// x-shift
+	t.W = RegInv3(t.Winv);				// W = (A*C*A')^-1
+	t.a = Fill_a(t.parNew, t.fi);			// a = dx/ds = derivatives wrt phase
+	t.a2 = t.W.Similarity(t.a);
+	//
+	// Build D matrix: D = W - W*a*a'*W/a2
+	TrkVec3 Wa = t.W * t.a;
+	t.D = t.W;
+	t.D.Rank1Update(Wa, -1. / t.a2);
+}
+//
+// Starting point of the fast vertex finder for one track:
+// sets x0 = track position, Winv = position covariance C, W = C^-1,
+// a = C^-1 * dx/ds and fi = starting phase
+void VertexFit::StartTrk(TrkBlock &t)
+{
+	Double_t s = 0.;
+	// Case when starting radius is provided
+	if(fRstart > TMath::Abs(t.par(0))){
+		s = 2.*TMath::ASin(t.par(2)*TMath::Sqrt((fRstart*fRstart-t.par(0)*t.par(0))/(1.+2.*t.par(2)*t.par(0))));
 	}
-	//std::cout << "Vtx init completed. fNtr = "<<fNtr << std::endl;
+	//
+	t.x0 = Fill_x(t.par, s);
+	t.Winv = t.cov.Similarity(Fill_A(t.par, s));
+	t.W = RegInv3(t.Winv);
+	t.a = t.W * Fill_a(t.par, s);
+	t.fi = s;
+}
+//
+void VertexFit::VtxFitNoSteer()
+{
+	//
+	// Track loop
+	for (Int_t i = 0; i < fNtr; i++) StartTrk(fTrk[i]);
 	//
 	// Get fit vertex
 	//
-	TMatrixDSym D(3); D.Zero();
-	TVectorD Dx(3); Dx.Zero();
+	TrkSymMat3 D;
+	TrkVec3 Dx;
 	for (Int_t i = 0; i < fNtr; i++)
 	{
-		TMatrixDSym Cinv = RegInv(*Ci[i]);
-		TMatrixDSym W(3);
-		W.Rank1Update(*wi[i], 1. / Ci[i]->Similarity(*wi[i]));
-		TMatrixDSym Dd = Cinv - W;
+		TrkBlock &t = fTrk[i];
+		TrkSymMat3 Dd = t.W;
+		Dd.Rank1Update(t.a, -1. / t.Winv.Similarity(t.a));
 		D += Dd;
-		Dx += Dd * (*x0i[i]);
+		Dx += Dd * t.x0;
 	}
 	if(fVtxCst){
 		D  += fCovCstInv;
 		Dx += fCovCstInv*fxCst;
 	}
-	fXv = RegInv(D) * Dx;
-	//std::cout << "Fast vertex (x, y, z) = "<<fXv(0)<<", "<<fXv(1)<<", "<<fXv(2) << std::endl;
+	fXv = RegInv3(D) * Dx;
 	//
 	// Get fit phases
 	//
 	for (Int_t i = 0; i < fNtr; i++){
-		Double_t si = Dot(*wi[i], fXv - (*x0i[i])) / Ci[i]->Similarity(*wi[i]);
-		ffi.push_back(si+s_in[i]);
-		//TVectorD xvi = Fill_x(*fPar[i],si);
-		//std::cout << "Fast vertex "<<i<<": xvi = "<<xvi(0)<<", "<<xvi(1)<<", "<<xvi(2) 
-		//	<<", si = "<<si<< std::endl;
+		TrkBlock &t = fTrk[i];
+		t.fi += t.a.Dot(fXv - t.x0) / t.Winv.Similarity(t.a);
+	}
+}
+//
+void VertexFit::AddToSums(const TrkBlock &t, Double_t sign)
+{
+	TrkSymMat3 DsW1Ds = t.Winv.Similarity(t.D);	// Service matrix to calculate covX
+	TrkVec3 cterm = t.D * (t.x0 - t.d);
+	if (sign < 0.0)
+	{
+		fDW1D -= DsW1Ds;
+		fH -= t.D;
+		fCterm -= cterm;
+	}
+	else
+	{
+		fDW1D += DsW1Ds;
+		fH += t.D;
+		fCterm += cterm;
 	}
+}
+//
+void VertexFit::SolveVertex()
+{
+	// update vertex position
+	TrkSymMat3 H1 = RegInv3(fH);
+	fXv = H1 * fCterm;
 	//
-	// Cleanup
+	// Update vertex covariance
+	fcovXv = fDW1D.Similarity(H1);
+}
+//
+void VertexFit::UpdatePhases()
+{
+	// Update phases and chi^2
+	fChi2 = 0.0;
 	for (Int_t i = 0; i < fNtr; i++)
 	{
-		x0i[i]->Clear();	delete x0i[i];
-		ni[i]->Clear();		delete ni[i];
-		Ci[i]->Clear();		delete Ci[i];
-		wi[i]->Clear();		delete wi[i];
+		TrkBlock &t = fTrk[i];
+		TrkVec3 lambda = t.D * (t.x0 - fXv - t.d);
+		t.chi2 = t.Winv.Similarity(lambda);
+		fChi2 += t.chi2;
+		TrkVec3 b = t.W * (fXv - t.x0 + t.d);
+		t.fi += t.a.Dot(b) / t.a2;
+		t.parNew = t.par - t.cov * t.A.TransposeTimes(lambda);
 	}
-	x0i.clear();;
-	ni.clear();
-	Ci.clear(); 
-	wi.clear();
-	s_in.clear();
+	// Add external constraint to Chi2
+	if (fVtxCst) fChi2 += fCovCstInv.Similarity(fXv - fxCst);
 }
 //
 void  VertexFit::VertexFitter()
 {
-	//std::cout << "VertexFitter: just in" << std::endl;
 	if (fNtr < 2 && !fVtxCst){
 		std::cout << "VertexFit::VertexFitter - Method called with less than 2 tracks - Aborting " << std::endl;
 		std::exit(1);
@@ -301,13 +384,8 @@ void  VertexFit::VertexFitter()
 	//
 	// Vertex fit
 	//
-	// Initial variable definitions
-	TVectorD x(3);
-	TMatrixDSym covX(3);
-	Double_t Chi2 = 0;
-	//
-	VtxFitNoSteer();	// Fast vertex finder on first pass (set ffi and fXv)
-	TVectorD x0 = fXv;
+	VtxFitNoSteer();	// Fast vertex finder on first pass (set phases and fXv)
+	TrkVec3 x0 = fXv;
 	//
 	// Iteration properties
 	//
@@ -319,116 +397,55 @@ void  VertexFit::VertexFitter()
 	// Iteration loop
 	while (epsi > eps && Ntry < TryMax)		// Iterate until found vertex is stable
 	{
-		// Initialize arrays
-		x.Zero();
-		TVectorD cterm(3); TMatrixDSym H(3); TMatrixDSym DW1D(3);
-		covX.Zero();		// Reset vertex covariance
-		cterm.Zero();		// Reset constant term
-		H.Zero();		// Reset H matrix
-		DW1D.Zero();
-		//
-		// Reset work arrays
-		//
-		ResetWrkArrays();
+		// Reset sums
+		fH.Zero();
+		fCterm.Zero();
+		fDW1D.Zero();
 		//
 		// Start loop on tracks
 		//
 		for (Int_t i = 0; i < fNtr; i++)
 		{
-			// Get track helix parameters and their covariance matrix
-			TVectorD par = *fPar[i];
-			TMatrixDSym Cov = *fCov[i];
-			//
-			// Update track related arrays
-			//
-			UpdateTrkArrays(i);
-			TMatrixDSym Ds = *fDi[i];
-			TMatrixDSym Winv = *fWinvi[i];
-			TMatrixDSym DsW1Ds = Winv.Similarity(Ds);	// Service matrix to calculate covX
-			//
-			// Update global arrays
-			DW1D += DsW1Ds;
-			// Update hessian
-			H += Ds;
-			// update constant term
-			TVectorD xs = *fx0i[i] - *fdi[i];
-			//TVectorD xx0 = *fx0i[i];
-			
-			//std::cout << "Iter. " << Ntry << ", trk " << i << ", xs= "
-			//	<< xs(0) << ", " << xs(1) << ", " << xs(2)<<
-			//	", ph0= "<<par(1)<< std::endl;
-			
-			cterm += Ds * xs;
+			UpdateTrkArrays(fTrk[i]);
+			AddToSums(fTrk[i], 1.0);
 		}				// End loop on tracks
 		// Some additions in case of external constraints
 		if (fVtxCst) {
-			H += fCovCstInv;
-			cterm += fCovCstInv * fxCst;
-			DW1D += fCovCstInv;
+			fH += fCovCstInv;
+			fCterm += fCovCstInv * fxCst;
+			fDW1D += fCovCstInv;
 		}
 		//
-		// update vertex position
-		TMatrixDSym H1 = RegInv(H);
-		x = H1 * cterm;
-		//
-		// Update vertex covariance
-		covX = DW1D.Similarity(H1);
-		//
-		// Update phases and chi^2
-		Chi2 = 0.0;
-		for (Int_t i = 0; i < fNtr; i++)
-		{
-			TVectorD lambda = (*fDi[i]) * (*fx0i[i] - x - *fdi[i]);
-			TMatrixDSym Wm1 = *fWinvi[i];
-			fChi2List(i) = Wm1.Similarity(lambda);
-			if(fChi2List(i) < 0.0){
-				//std::cout<<"# "<<i<<", Chi2= "<<fChi2List(i)<<", Wm1:"<<std::endl; Wm1.Print();
-				//std::cout<<"Lambda= "<<std::endl; lambda.Print();
-			}
-			Chi2 += fChi2List(i);
-			TVectorD a = *fai[i];
-			TVectorD b = (*fWi[i]) * (x - *fx0i[i] + *fdi[i]);
-			ffi[i] += Dot(a, b) / fa2i[i];
-			TVectorD newPar = *fPar[i] - ((*fCov[i]) * (*fAti[i])) * lambda;
-			fParNew[i] = new TVectorD(newPar);
-		}
-		// Add external constraint to Chi2
-		if (fVtxCst) Chi2 += fCovCstInv.Similarity(x - fxCst);
+		// update vertex position and covariance, phases and chi^2
+		SolveVertex();
+		UpdatePhases();
 		//
-		TVectorD dx = x - x0;
-		x0 = x;
+		TrkVec3 dx = fXv - x0;
+		x0 = fXv;
 		// update vertex stability
-		TMatrixDSym Hess = RegInv(covX);
-		epsi = Hess.Similarity(dx);
+		epsi = RegInv3(fcovXv).Similarity(dx);
 		Ntry++;
-		//
-		// Store result
-		//
-		fXv = x;			// Vertex position
-		fcovXv = covX;		// Vertex covariance
-		fChi2 = Chi2;		// Vertex fit Chi2
-		//std::cout << "Found vertex " << fXv(0) << ", " << fXv(1) << ", " << fXv(2) << std::endl;
 	}		// end of iteration loop
 	//
 	fVtxDone = kTRUE;		// Set fit completion flag
-	//fRstart = TMath::Sqrt(fXv(0)*fXv(0) + fXv(1)*fXv(1));	// Store fit 
-	//std::cout << "Found vertex " << fXv(0) << ", " << fXv(1) << ", " << fXv(2) 
-	//	<< ", after "<<Ntry<<" iterations"<<std::endl;
-	//
 }
 //
 // Return fit vertex
 TVectorD VertexFit::GetVtx()
 {
 	if (!fVtxDone) VertexFitter();
-	return fXv;
+	TVectorD xv(3);
+	fXv.Get(xv);
+	return xv;
 }
 //
 // Return fit vertex covariance
 TMatrixDSym VertexFit::GetVtxCov()
 {
 	if (!fVtxDone) VertexFitter();
-	return fcovXv;
+	TMatrixDSym covXv(3);
+	fcovXv.Get(covXv);
+	return covXv;
 }
 //
 // Return fit vertex chi2
@@ -442,18 +459,20 @@ Double_t VertexFit::GetVtxChi2()
 TVectorD VertexFit::GetVtxChi2List()
 {
 	if (!fVtxDone) VertexFitter();
-	return fChi2List;
+	TVectorD Chi2List(fNtr);
+	for (Int_t i = 0; i < fNtr; i++) Chi2List(i) = fTrk[i].chi2;
+	return Chi2List;
 }
 //
 // Handle tracks/constraints
 void VertexFit::AddVtxConstraint(TVectorD xv, TMatrixDSym cov)	// Add gaussian vertex constraint
 {
-	//std::cout << "VertexFit::AddVtxConstraint: Not implemented yet" << std::endl;
 	fVtxCst = kTRUE;				// Vertex constraint flag
-	fxCst = xv;						// Constraint value
-	fCovCst = cov;					// Constraint covariance
-	fCovCstInv = cov;
-	fCovCstInv.Invert();				// Its inverse
+	fxCst.Set(xv);					// Constraint value
+	fCovCst.Set(cov);				// Constraint covariance
+	TMatrixDSym covInv = cov;
+	covInv.Invert();
+	fCovCstInv.Set(covInv);				// Its inverse
 	//
 	// Set starting vertex as external constraint
 	fXv = fxCst;
@@ -463,32 +482,78 @@ void VertexFit::AddVtxConstraint(TVectorD xv, TMatrixDSym cov)	// Add gaussian v
 // Adding tracks one by one
 void VertexFit::AddTrk(TVectorD *par, TMatrixDSym *Cov)			// Add track to input list
 {
-	fNtr++;
-	fChi2List.ResizeTo(fNtr);	// Resize chi2 array
-	fPar.push_back(par);			// add new track
-	fCov.push_back(Cov);
-	fParNew.push_back(par);			// add new track
-	fCovNew.push_back(Cov);
-	//
-	// Reset previous vertex temp arrays
-	ResetWrkArrays();
-	ffi.clear();
+	InitTrk(*par, *Cov);			// add new track
 	fVtxDone = kFALSE;			// Reset vertex done flag
 }
 //
 // Removing tracks one by one
 void VertexFit::RemoveTrk(Int_t iTrk)	// Remove iTrk track
 {
+	fTrk.erase(fTrk.begin() + iTrk);		// Remove track
 	fNtr--;
-	fChi2List.Clear();
-	fChi2List.ResizeTo(fNtr);		// Resize chi2 array
-	fPar.erase(fPar.begin() + iTrk);		// Remove track
-	fCov.erase(fCov.begin() + iTrk);
-	fParNew.erase(fParNew.begin() + iTrk);		// Remove track
-	fCovNew.erase(fCovNew.begin() + iTrk);
-	//
-	// Reset previous vertex temp arrays
-	ResetWrkArrays();
-	ffi.clear();
 	fVtxDone = kFALSE;			// Reset vertex done flag
 }
+//
+// Add a track to a completed fit
+void VertexFit::AddTrkIncremental(TVectorD *par, TMatrixDSym *Cov)
+{
+	if (!fVtxDone)
+	{
+		AddTrk(par, Cov);
+		return;
+	}
+	InitTrk(*par, *Cov);
+	TrkBlock &t = fTrk.back();
+	//
+	// Phase of closest approach to the current vertex
+	StartTrk(t);
+	t.fi += t.a.Dot(fXv - t.x0) / t.Winv.Similarity(t.a);
+	//
+	UpdateTrkArrays(t);
+	AddToSums(t, 1.0);
+	SolveVertex();
+	UpdatePhases();
+}
+//
+// Remove a track from a completed fit
+void VertexFit::RemoveTrkIncremental(Int_t iTrk)
+{
+	if (!fVtxDone || (fNtr < 3 && !fVtxCst))
+	{
+		RemoveTrk(iTrk);
+		return;
+	}
+	AddToSums(fTrk[iTrk], -1.0);
+	fTrk.erase(fTrk.begin() + iTrk);
+	fNtr--;
+	SolveVertex();
+	UpdatePhases();
+}
+//
+// Fit many vertices reusing the same work arrays
+void VertexFit::FitVertices(Int_t Nvtx, const Int_t *Ntr, TVectorD **trkPar, TMatrixDSym **trkCov,
+	TVectorD *xv, TMatrixDSym *covXv, Double_t *chi2)
+{
+	VertexFit Vtx;
+	Int_t first = 0;
+	for (Int_t k = 0; k < Nvtx; k++)
+	{
+		Vtx.Reset();
+		for (Int_t i = 0; i < Ntr[k]; i++) Vtx.InitTrk(*trkPar[first + i], *trkCov[first + i]);
+		first += Ntr[k];
+		//
+		xv[k].ResizeTo(3);
+		covXv[k].ResizeTo(3, 3);
+		if (Ntr[k] < 2)
+		{
+			xv[k].Zero();
+			covXv[k].Zero();
+			chi2[k] = -1.0;
+			continue;
+		}
+		Vtx.VertexFitter();
+		Vtx.fXv.Get(xv[k]);
+		Vtx.fcovXv.Get(covXv[k]);
+		chi2[k] = Vtx.fChi2;
+	}
+}
@@ -6,6 +6,7 @@
 #include <TVectorD.h>
 #include <TMatrixDSym.h>
 #include "TrkUtil.h"
+#include "TrkMat.h"
 #include "ObsTrk.h"
 #include <vector>
 #include <iostream>
@@ -19,51 +20,67 @@ class VertexFit: public TrkUtil
 	// Author: F. Bedeschi, INFN-Pisa, Italy
 	// February 10, 2021
 	//
+	// Track data and work arrays are stored in fixed size per-track blocks,
+	// so that a VertexFit object can be reused (Reset()) without heap allocations.
+	//
 private:
+	//
+	// Per-track block
+	struct TrkBlock
+	{
+		TrkVec5 par;			// Input parameters
+		TrkSymMat5 cov;			// Input parameter covariance
+		TrkVec5 parNew;			// Updated parameters
+		Double_t fi;			// Fit phase
+		Double_t chi2;			// Chi2 contribution
+		//
+		// Work arrays
+		TrkVec3 x0;			// Track expansion point
+		TrkVec3 a;			// dx/dphi
+		TrkVec3 d;			// x-shift
+		Double_t a2;			// a'Wa
+		TrkMat35 A;			// dx/dpar
+		TrkSymMat3 D;			// W-WBW
+		TrkSymMat3 W;			// (ACA')^-1
+		TrkSymMat3 Winv;		// ACA'
+	};
 	//
 	// Inputs
 	Int_t fNtr;							// Number of tracks
-	std::vector<TVectorD*> fPar;		// Input parameter array
-	std::vector<TVectorD*> fParNew;		// Updated parameter array
-	std::vector<TMatrixDSym*> fCov;		// Input parameter covariances
-	std::vector<TMatrixDSym*> fCovNew;	// Updated parameter covariances
+	std::vector<TrkBlock> fTrk;			// Track blocks
 	// Constraints
 	Bool_t fVtxCst;					// Vertex constraint flag
-	TVectorD fxCst;					// Constraint value
-	TMatrixDSym fCovCst;			// Constraint 
-	TMatrixDSym fCovCstInv;			// Inverse of constraint covariance
+	TrkVec3 fxCst;					// Constraint value
+	TrkSymMat3 fCovCst;				// Constraint 
+	TrkSymMat3 fCovCstInv;			// Inverse of constraint covariance
 	//
 	// Results
 	Bool_t fVtxDone;			// Flag vertex fit completed
 	Double_t fRstart;			// Starting value of vertex radius (0 = none)
-	TVectorD fXv;				// Found vertex
-	TMatrixDSym fcovXv;			// Vertex covariance
+	TrkVec3 fXv;				// Found vertex
+	TrkSymMat3 fcovXv;			// Vertex covariance
 	Double_t fChi2;				// Vertex fit Chi2
-	TVectorD fChi2List;			// List of Chi2 contributions
 	//
-	// Work arrays
-	std::vector<Double_t> ffi;				// Fit phases
-	std::vector<TVectorD*> fx0i;			// Track expansion points
-	std::vector<TVectorD*> fai;				// dx/dphi
-	std::vector<TVectorD*> fdi;				// x-shift
-	std::vector<Double_t> fa2i;				// a'Wa
-	std::vector<TMatrixD*> fAti;			// A transposed
-	std::vector<TMatrixDSym*> fDi;			// W-WBW
-	std::vector<TMatrixDSym*> fWi;			// (ACA')^-1
-	std::vector<TMatrixDSym*> fWinvi;		// ACA'
+	// Sums over tracks of the last iteration, kept for incremental updates
+	TrkSymMat3 fH;				// Hessian
+	TrkVec3 fCterm;				// Constant term
+	TrkSymMat3 fDW1D;			// Sum of D*W^-1*D
 	//
 	// Service routines
-	void ResetWrkArrays();							// Clear work arrays
-	//Double_t StartRadius();							// Starting vertex radius determination
-	//Double_t FastRv(TVectorD p1, TVectorD p2);		// Fast vertex radius determination
-	//TMatrixDSym RegInv(TMatrixDSym& Smat0);		// Regularized 3D matrix inversion 
-	//TMatrixD Fill_A(TVectorD par, Double_t phi);	// Derivative of track position wrt track parameters
-	//TVectorD Fill_a(TVectorD par, Double_t phi);	// Derivative of track position wrt track phase
-	TVectorD Fill_x0(TVectorD par);					// Track position at dma to z-axis
-	TVectorD Fill_x(TVectorD par, Double_t phi);	// Track position at given phase
-	void UpdateTrkArrays(Int_t i);					// Fill track realted arrays
+	static TrkSymMat<2> RegInv2(const TrkSymMat<2> &M);	// Regularized 2D matrix inversion
+	static TrkSymMat3 RegInv3(const TrkSymMat3 &M);		// Regularized 3D matrix inversion
+	static TrkMat35 Fill_A(const TrkVec5 &par, Double_t phi);	// Derivative of track position wrt track parameters
+	static TrkVec3 Fill_a(const TrkVec5 &par, Double_t phi);	// Derivative of track position wrt track phase
+	static TrkVec3 Fill_x0(const TrkVec5 &par);			// Track position at dma to z-axis
+	static TrkVec3 Fill_x(const TrkVec5 &par, Double_t phi);	// Track position at given phase
+	void StartTrk(TrkBlock &t);					// Fast vertex finder inputs for one track
+	void UpdateTrkArrays(TrkBlock &t);				// Fill track realted arrays
+	void AddToSums(const TrkBlock &t, Double_t sign);	// Add/subtract track to/from fH, fCterm, fDW1D
+	void SolveVertex();							// Vertex and covariance from fH, fCterm, fDW1D
+	void UpdatePhases();							// Update phases, parameters and chi2 at current vertex
 	void VtxFitNoSteer();							// Vertex fitter routine w/o parameter steering
 	void VertexFitter();							// Vertex fitter routine w/  parameter steering
+	void InitTrk(const TVectorD &par, const TMatrixDSym &Cov);	// Append track block
 public:
 	//
 	// Constructors
@@ -82,9 +99,20 @@ public:
 	//
 	// Handle tracks/constraints
 	void AddVtxConstraint(TVectorD xv, TMatrixDSym cov);	// Add gaussian vertex constraint
-	void AddTrk(TVectorD *par, TMatrixDSym *Cov);		// Add track to input list
+	void AddTrk(TVectorD *par, TMatrixDSym *Cov);		// Add track to input list (input is copied)
 	void RemoveTrk(Int_t iTrk);				// Remove iTrk track
 	void SetStartR(Double_t R) { fRstart = R; };		// Set starting radius
+	void Reset();							// Remove all tracks and constraints, keep work arrays
+	//
+	// Incremental updates of a completed fit: the track contribution is added/removed
+	// with the other tracks kept at their current expansion points, no refit is done
+	void AddTrkIncremental(TVectorD *par, TMatrixDSym *Cov);	// Add track and update vertex
+	void RemoveTrkIncremental(Int_t iTrk);			// Remove iTrk track and update vertex
+	//
+	// Batch fit of Nvtx vertices: vertex k uses the next Ntr[k] entries of trkPar and trkCov.
+	// Results are stored in xv[k], covXv[k] and chi2[k] (chi2[k] = -1 if less than 2 tracks)
+	static void FitVertices(Int_t Nvtx, const Int_t *Ntr, TVectorD **trkPar, TMatrixDSym **trkCov,
+		TVectorD *xv, TMatrixDSym *covXv, Double_t *chi2);
 	//
 };
 
@@ -31,6 +31,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "TDatabasePDG.h"
 #include "TFormula.h"
@@ -144,7 +145,7 @@ void BTagging::Process()
     formula = itEfficiencyMap->second;
 
     // apply an efficiency formula
-    jet->BTag |= (gRandom->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
+    jet->BTag |= (GetRandom()->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
 
     // find an efficiency formula for algo flavor definition
     itEfficiencyMap = fEfficiencyMap.find(jet->FlavorAlgo);
@@ -155,7 +156,7 @@ void BTagging::Process()
     formula = itEfficiencyMap->second;
 
     // apply an efficiency formula
-    jet->BTagAlgo |= (gRandom->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
+    jet->BTagAlgo |= (GetRandom()->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
 
     // find an efficiency formula for phys flavor definition
     itEfficiencyMap = fEfficiencyMap.find(jet->FlavorPhys);
@@ -166,7 +167,7 @@ void BTagging::Process()
     formula = itEfficiencyMap->second;
 
     // apply an efficiency formula
-    jet->BTagPhys |= (gRandom->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
+    jet->BTagPhys |= (GetRandom()->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
   }
 }
 
@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -393,7 +394,7 @@ void Calorimeter::Process()
       {
         if(fElectronsFromTrack)
         {
-          fTower->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, track->Position.T()));
+          fTower->AddECalEnergyTimePair(ecalEnergy, track->Position.T());
         }
       }
 
@@ -449,7 +450,7 @@ void Calorimeter::Process()
     {
       if(abs(particle->PID) != 11 || !fElectronsFromTrack)
       {
-        fTower->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, particle->Position.T()));
+        fTower->AddECalEnergyTimePair(ecalEnergy, particle->Position.T());
       }
     }
 
@@ -498,8 +499,8 @@ void Calorimeter::FinalizeTower()
 
   if(fSmearTowerCenter)
   {
-    eta = gRandom->Uniform(fTowerEdges[0], fTowerEdges[1]);
-    phi = gRandom->Uniform(fTowerEdges[2], fTowerEdges[3]);
+    eta = GetRandom()->Uniform(fTowerEdges[0], fTowerEdges[1]);
+    phi = GetRandom()->Uniform(fTowerEdges[2], fTowerEdges[3]);
   }
   else
   {
@@ -514,10 +515,11 @@ void Calorimeter::FinalizeTower()
   sumWeightedTime = 0.0;
   sumWeight = 0.0;
 
-  for(size_t i = 0; i < fTower->ECalEnergyTimePairs.size(); ++i)
+  const vector<pair<Float_t, Float_t> > &timePairs = fTower->GetECalEnergyTimePairs();
+  for(size_t i = 0; i < timePairs.size(); ++i)
   {
-    weight = TMath::Power((fTower->ECalEnergyTimePairs[i].first),2);
-    sumWeightedTime += weight * fTower->ECalEnergyTimePairs[i].second;
+    weight = TMath::Power((timePairs[i].first),2);
+    sumWeightedTime += weight * timePairs[i].second;
     sumWeight += weight;
     fTower->NTimeHits++;
   }
@@ -676,7 +678,7 @@ Double_t Calorimeter::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma * sigma) / (mean * mean))));
     a = TMath::Log(mean) - 0.5 * b * b;
 
-    return TMath::Exp(a + b * gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b * GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
@@ -0,0 +1,106 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class Checkpoint
+ *
+ *  Writes the candidates of the input arrays of each event to a checkpoint
+ *  file, from which DelphesCheckpoint resumes ExecutionPath after this
+ *  module.
+ *
+ */
+
+#include "modules/Checkpoint.h"
+
+#include "classes/DelphesCheckpointWriter.h"
+
+#include "ExRootAnalysis/ExRootConfReader.h"
+
+#include "TObjArray.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+Checkpoint::Checkpoint() :
+  fWriter(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+Checkpoint::~Checkpoint()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void Checkpoint::Init()
+{
+  stringstream message;
+  ExRootConfParam param;
+  Long_t i, size;
+
+  // forked worker processes would share the open checkpoint file
+  if(GetInt("::NumberOfProcesses", 1) > 1)
+  {
+    message << "module '" << GetName() << "' does not support NumberOfProcesses larger than one";
+    throw runtime_error(message.str());
+  }
+
+  fWriter = new DelphesCheckpointWriter(GetString("OutputFile", "checkpoint.root"), GetName());
+
+  // import arrays with output from other modules
+
+  param = GetParam("InputArray");
+  size = param.GetSize();
+  if(size == 0)
+  {
+    message << "module '" << GetName() << "' has no InputArray";
+    throw runtime_error(message.str());
+  }
+
+  for(i = 0; i < size; ++i)
+  {
+    fWriter->AddArray(param[i].GetString(), ImportArray(param[i].GetString()));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Checkpoint::Finish()
+{
+  if(fWriter)
+  {
+    fWriter->Write();
+    delete fWriter;
+    fWriter = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Checkpoint::Process()
+{
+  fWriter->WriteEntry(GetEventNumber(), GetInputNumber());
+}
+
+//------------------------------------------------------------------------------
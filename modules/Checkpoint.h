@@ -0,0 +1,51 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef Checkpoint_h
+#define Checkpoint_h
+
+/** \class Checkpoint
+ *
+ *  Writes the candidates of the input arrays of each event to a checkpoint
+ *  file, from which DelphesCheckpoint resumes ExecutionPath after this
+ *  module, so that downstream modules can be tuned without running the
+ *  upstream ones again.
+ *
+ */
+
+#include "classes/DelphesModule.h"
+
+class DelphesCheckpointWriter;
+
+class Checkpoint: public DelphesModule
+{
+public:
+  Checkpoint();
+  ~Checkpoint();
+
+  void Init();
+  void Process();
+  void Finish();
+
+private:
+  DelphesCheckpointWriter *fWriter; //!
+
+  ClassDef(Checkpoint, 1)
+};
+
+#endif
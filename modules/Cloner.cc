@@ -81,6 +81,9 @@ void Cloner::Process()
 {
   Candidate *candidate;
 
+  // skip the output if no other module reads it
+  if(!fOutputArray->TestBit(kArrayImported)) return;
+
   // loop over all input candidates
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
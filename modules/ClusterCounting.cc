@@ -29,6 +29,7 @@
 
 #include "modules/ClusterCounting.h"
 #include "classes/DelphesClasses.h"
+#include "classes/DelphesRandom.h"
 #include "TrackCovariance/TrkUtil.h"
 
 #include "TLorentzVector.h"
@@ -124,7 +125,7 @@ void ClusterCounting::Process()
     candidate = static_cast<Candidate*>(candidate->Clone());
 
     Ncl = 0.;
-    if (fTrackUtil->IonClusters(Ncl, mass, Par))
+    if (fTrackUtil->IonClusters(Ncl, mass, Par, GetRandom()))
     {
       candidate->Nclusters = Ncl;
       candidate->dNdx = (trackLength > 0.) ? Ncl/trackLength : -1;
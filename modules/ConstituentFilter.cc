@@ -88,7 +88,7 @@ void ConstituentFilter::Init()
   size = param.GetSize();
   for(i = 0; i < size / 2; ++i)
   {
-    array = ImportArray(param[i * 2].GetString());
+    array = UpdateArray(param[i * 2].GetString());
     iterator = array->MakeIterator();
 
     fInputMap[iterator] = ExportArray(param[i * 2 + 1].GetString());
@@ -154,6 +154,9 @@ void ConstituentFilter::Process()
     iterator = itInputMap->first;
     array = itInputMap->second;
 
+    // skip the outputs no other module reads
+    if(!array->TestBit(kArrayImported)) continue;
+
     // loop over all constituents
     iterator->Reset();
     while((constituent = static_cast<Candidate *>(iterator->Next())))
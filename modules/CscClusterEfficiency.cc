@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesCscClusterFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -105,7 +106,7 @@ void CscClusterEfficiency::Process()
     Ehad = candidate->Ehad;
     Eem = candidate->Eem;
     // apply an efficency formula
-    if(gRandom->Uniform() > fFormula->Eval(decayR, decayZ, Ehad, Eem)) continue;
+    if(GetRandom()->Uniform() > fFormula->Eval(decayR, decayZ, Ehad, Eem)) continue;
 
 
     fOutputArray->Add(candidate);
@@ -31,6 +31,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesCscClusterFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -123,7 +124,7 @@ void CscClusterId::Process()
 
     // depending on the decay region (station Number), different eta cut is applied, implemented based on cut_based_id.py in HEPData
     float eta_cut = fEtaFormula->Eval(decayR, decayZ);
-    if(gRandom->Uniform() > NStationEff*(abs(eta)<fEtaCutMax)+(1.0-NStationEff)*(abs(eta)<eta_cut)) continue;
+    if(GetRandom()->Uniform() > NStationEff*(abs(eta)<fEtaCutMax)+(1.0-NStationEff)*(abs(eta)<eta_cut)) continue;
 
     fOutputArray->Add(candidate);
   }
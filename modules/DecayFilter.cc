@@ -36,6 +36,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -123,7 +124,7 @@ void DecayFilter::Process()
 
     // get full trajectory length and generate random decay length
     L = candidate->L * 1.0E-3; // [m]
-    l = gRandom->Exp(bgct);
+    l = GetRandom()->Exp(bgct);
 
     // if random decay happens before end of trajectory, reject track
     if (l < L) continue;
@@ -30,35 +30,93 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesMerger.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootConfReader.h"
 #include "ExRootAnalysis/ExRootFilter.h"
 #include "ExRootAnalysis/ExRootResult.h"
+#include "ExRootAnalysis/ExRootTimeline.h"
 #include "ExRootAnalysis/ExRootTreeWriter.h"
 
 #include "TDatabasePDG.h"
+#include "TFile.h"
 #include "TFolder.h"
 #include "TFormula.h"
+#include "TList.h"
 #include "TLorentzVector.h"
 #include "TMath.h"
 #include "TObjArray.h"
+#include "TProcessID.h"
 #include "TROOT.h"
 #include "TRandom3.h"
 #include "TString.h"
+#include "TTree.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include <stdio.h>
 #include <string.h>
 
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 using namespace std;
 
+//------------------------------------------------------------------------------
+
+// serialises access to the shared random number generator
+// while modules run on several threads
+
+class DelphesLockedRandom: public TRandom
+{
+public:
+  DelphesLockedRandom(TRandom *random) :
+    fRandom(random) {}
+
+  Double_t Rndm()
+  {
+    lock_guard<mutex> lock(fMutex);
+    return fRandom->Rndm();
+  }
+
+  void RndmArray(Int_t n, Float_t *array)
+  {
+    lock_guard<mutex> lock(fMutex);
+    fRandom->RndmArray(n, array);
+  }
+
+  void RndmArray(Int_t n, Double_t *array)
+  {
+    lock_guard<mutex> lock(fMutex);
+    fRandom->RndmArray(n, array);
+  }
+
+private:
+  TRandom *fRandom;
+  mutex fMutex;
+};
+
+//------------------------------------------------------------------------------
+
 Delphes::Delphes(const char *name) :
-  fFactory(0)
+  fFactory(0), fWriter(0), fTimeline(0), fMemoryBudget(0), fTrimCounter(0), fTrimmedBytes(0),
+  fPruneExecutionPath(kFALSE),
+  fParallelExecution(kFALSE), fHasEventFilters(kFALSE), fNumberOfThreads(1),
+  fNumberOfProcesses(1), fProcessNumber(0), fNumberOfModules(-1), fSource(0), fShardFile(0),
+  fRandom(0), fSharedRandom(0),
+  fQueued(0), fRemaining(0), fAbort(false), fRejected(false), fStop(kFALSE)
 {
   TFolder *folder;
 
@@ -79,6 +137,8 @@ Delphes::Delphes(const char *name) :
 
 Delphes::~Delphes()
 {
+  StopWorkers();
+
   TFolder *folder = GetFolder();
   if(folder)
   {
@@ -87,13 +147,197 @@ Delphes::~Delphes()
     delete folder;
   }
   if(fFactory) delete fFactory;
+  if(fTimeline) delete fTimeline;
+}
+
+//------------------------------------------------------------------------------
+
+Long64_t Delphes::GetMemoryUsage() const
+{
+  Long64_t bytes = 0;
+
+  if(fFactory) bytes += fFactory->GetBytes();
+  if(fWriter) bytes += fWriter->GetBytes();
+
+  return bytes;
 }
 
 //------------------------------------------------------------------------------
 
 void Delphes::Clear()
 {
+  Long64_t bytes;
+
   if(fFactory) fFactory->Clear();
+
+  // shrink the pools after outlier events, the tree writer branches
+  // still filled for the current event are left untouched
+  if(fMemoryBudget > 0 && GetMemoryUsage() > fMemoryBudget)
+  {
+    bytes = fFactory->Trim();
+    if(fWriter) bytes += fWriter->Trim();
+
+    if(bytes > 0)
+    {
+      ++fTrimCounter;
+      fTrimmedBytes += bytes;
+#ifdef __GLIBC__
+      // hand the freed pages back to the system
+      malloc_trim(0);
+#endif
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Int_t Delphes::ForkProcesses()
+{
+  stringstream message;
+  TString outputName, shardName;
+  TFile *outputFile;
+  TObject reference;
+  DelphesMerger merger;
+  vector<pid_t> processes;
+  vector<TString> shards;
+  vector<TString>::iterator itShards;
+  pid_t pid;
+  Int_t i, status, failures;
+
+  if(fNumberOfProcesses <= 1) return 0;
+
+  outputFile = fWriter && fWriter->GetTree() ? fWriter->GetTree()->GetCurrentFile() : 0;
+  if(!outputFile)
+  {
+    throw runtime_error("NumberOfProcesses requires a TreeWriter writing to an output file");
+  }
+
+  outputName = outputFile->GetName();
+
+  // threads do not survive fork, the workers restart their own
+  StopWorkers();
+
+  for(i = 0; i < fNumberOfProcesses; ++i)
+  {
+    shardName = outputName;
+    if(shardName.EndsWith(".root")) shardName.Remove(shardName.Length() - 5);
+    shardName += Form("_shard%d.root", i);
+    shards.push_back(shardName);
+  }
+
+  cout << "** Forking " << fNumberOfProcesses << " worker processes" << endl;
+
+  // unwritten buffers would be duplicated in every worker
+  fflush(0);
+
+  for(i = 0; i < fNumberOfProcesses; ++i)
+  {
+    pid = fork();
+    if(pid < 0)
+    {
+      message << "can't fork worker process " << i;
+      throw runtime_error(message.str());
+    }
+
+    if(pid == 0)
+    {
+      fProcessNumber = i;
+
+      // all workers inherit the TProcessID of the parent, exhausting its
+      // object numbers makes ROOT switch to a fresh one in each of them,
+      // so that the shards can be merged without rewriting their references
+      TProcessID::SetObjectCount(16777215);
+      TProcessID::AssignID(&reference);
+
+      // the first worker carries on with the timeline, the others drop it
+      if(i > 0 && fTimeline)
+      {
+        ExRootTimeline::SetTimeline(0);
+        fTimeline = 0;
+      }
+
+      fShardFile = TFile::Open(shards[i], "RECREATE");
+      if(!fShardFile)
+      {
+        cerr << "** ERROR: can't create output file " << shards[i] << endl;
+        _exit(1);
+      }
+
+      fWriter->SetTreeFile(fShardFile);
+
+      if(fParallelExecution) StartWorkers();
+
+      return i;
+    }
+
+    processes.push_back(pid);
+  }
+
+  // the timeline file now belongs to the first worker
+  if(fTimeline)
+  {
+    ExRootTimeline::SetTimeline(0);
+    fTimeline = 0;
+  }
+
+  failures = 0;
+  for(i = 0; i < fNumberOfProcesses; ++i)
+  {
+    while(waitpid(processes[i], &status, 0) < 0)
+    {
+      if(errno != EINTR)
+      {
+        status = -1;
+        break;
+      }
+    }
+    if(status != 0) ++failures;
+  }
+
+  if(failures > 0)
+  {
+    message << failures << " of " << fNumberOfProcesses << " worker processes failed, ";
+    message << "their output is left in " << shards[0] << " to " << shards.back();
+    throw runtime_error(message.str());
+  }
+
+  cout << "** Merging " << fNumberOfProcesses << " output files" << endl;
+
+  // the tree of the parent process stays empty and is not written
+  fWriter->GetTree()->SetDirectory(0);
+
+  for(itShards = shards.begin(); itShards != shards.end(); ++itShards)
+  {
+    merger.AddFile(*itShards);
+  }
+
+  merger.SetTreeName(fWriter->GetTree()->GetName());
+  merger.SetNumberOfThreads(fNumberOfProcesses);
+  merger.Merge(outputFile);
+
+  for(itShards = shards.begin(); itShards != shards.end(); ++itShards)
+  {
+    unlink(*itShards);
+  }
+
+  fProcessNumber = -1;
+
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ExitProcess(Int_t status)
+{
+  if(!fShardFile) return;
+
+  fShardFile->Close();
+
+  // skip the destructors of the objects inherited from the parent process
+  cout.flush();
+  cerr.flush();
+  fflush(0);
+  _exit(status);
 }
 
 //------------------------------------------------------------------------------
@@ -119,11 +363,48 @@ void Delphes::Init()
   ExRootConfReader::ExRootTaskMap::const_iterator itModules;
 
   ExRootConfParam param = confReader->GetParam("::ExecutionPath");
-  Long_t i, size = param.GetSize();
+  Long_t i, first, size = param.GetSize();
+
+  const char *timelineFile;
 
   gRandom->SetSeed(confReader->GetInt("::RandomSeed", 0));
 
-  for(i = 0; i < size; ++i)
+  fPruneExecutionPath = confReader->GetBool("::PruneExecutionPath", false);
+
+  // the outputs of a source instance are consumed by other instances
+  if(fNumberOfModules >= 0)
+  {
+    fPruneExecutionPath = kFALSE;
+    if(fNumberOfModules < size) size = fNumberOfModules;
+  }
+
+  first = fSource ? fSource->fNumberOfModules : 0;
+  if(first < 0) first = 0;
+
+  fMemoryBudget = Long64_t(confReader->GetDouble("::MemoryBudget", 0.0) * 1048576.0);
+  fFactory->SetWindow(confReader->GetInt("::MemoryWindow", 100));
+
+  fWriter = static_cast<ExRootTreeWriter *>(GetFolder()->FindObject("TreeWriter"));
+  if(fWriter) fWriter->SetWindow(confReader->GetInt("::MemoryWindow", 100));
+
+  timelineFile = confReader->GetString("::TimelineFile", "");
+  // instances fed by the same reader share the timeline of the first one
+  if(timelineFile[0] != '\0' && !fTimeline && !ExRootTimeline::GetTimeline())
+  {
+    fTimeline = new ExRootTimeline(timelineFile, confReader->GetInt("::TimelineSampling", 100));
+    ExRootTimeline::SetTimeline(fTimeline);
+  }
+
+  fParallelExecution = confReader->GetBool("::ParallelExecution", false);
+  fNumberOfThreads = confReader->GetInt("::NumberOfThreads", thread::hardware_concurrency());
+  if(fNumberOfThreads < 1) fNumberOfThreads = 1;
+
+  fNumberOfProcesses = confReader->GetInt("::NumberOfProcesses", 1);
+  if(fNumberOfProcesses < 1) fNumberOfProcesses = 1;
+
+  if(fSource) ShareArrays();
+
+  for(i = first; i < size; ++i)
   {
     name = param[i].GetString();
     itModules = modules->find(name);
@@ -158,3 +439,810 @@ void Delphes::Finish()
 }
 
 //------------------------------------------------------------------------------
+
+void Delphes::InitTask()
+{
+  TIter itTasks(GetListOfTasks());
+  TObject *object;
+  TFlowStruct flow;
+  Int_t i, a;
+  vector<Bool_t> updated;
+  vector<Int_t> stack;
+  vector<TSharedArray>::iterator itShared;
+
+  ExRootTask::InitTask();
+
+  fHasEventFilters = kFALSE;
+  while((object = itTasks.Next()))
+  {
+    if(object->InheritsFrom(DelphesModule::Class()) && static_cast<DelphesModule *>(object)->IsEventFilter())
+    {
+      fHasEventFilters = kTRUE;
+    }
+  }
+
+  if(fPruneExecutionPath) PruneModules();
+
+  // modules updating candidates, other than tree writers, get copies of the
+  // shared candidates they can reach, the others read the candidates of the source;
+  // modules without outputs update all the candidates they import
+  if(!fSharedArrays.empty())
+  {
+    AnalyseDataFlow(flow);
+
+    updated.assign(flow.arrays.size(), kFALSE);
+    for(i = 0; i < Int_t(flow.tasks.size()); ++i)
+    {
+      if(flow.barrier[i] || flow.tasks[i]->InheritsFrom("TreeWriter")) continue;
+      stack = flow.outputs[i].empty() ? flow.inputs[i] : flow.writes[i];
+      while(!stack.empty())
+      {
+        a = stack.back();
+        stack.pop_back();
+        if(updated[a]) continue;
+        updated[a] = kTRUE;
+        if(flow.producers[a] >= 0)
+        {
+          stack.insert(stack.end(), flow.inputs[flow.producers[a]].begin(), flow.inputs[flow.producers[a]].end());
+        }
+      }
+    }
+
+    for(itShared = fSharedArrays.begin(); itShared != fSharedArrays.end(); ++itShared)
+    {
+      a = find(flow.arrays.begin(), flow.arrays.end(), itShared->path) - flow.arrays.begin();
+      if(a < Int_t(flow.arrays.size()) && updated[a]) itShared->copy = kTRUE;
+    }
+  }
+
+  // the source fills the arrays only when they are needed,
+  // readers of the card count as readers of the source array
+  for(itShared = fSharedArrays.begin(); itShared != fSharedArrays.end(); ++itShared)
+  {
+    if(!itShared->array->TestBit(kArrayImported)) continue;
+    if(itShared->source->TestBit(kArrayImported) || itShared->array->TestBit(kArrayImportedTwice))
+    {
+      itShared->source->SetBit(kArrayImportedTwice);
+    }
+    itShared->source->SetBit(kArrayImported);
+  }
+
+  if(fParallelExecution)
+  {
+    BuildGraph();
+    StartWorkers();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ProcessTask()
+{
+  TIter itTasks(GetListOfTasks());
+  TObject *object;
+  Double_t start;
+
+  if(fSource) CopySharedArrays();
+
+  // restart the random number streams of all modules for this event
+  while((object = itTasks.Next()))
+  {
+    if(object->InheritsFrom(DelphesModule::Class()))
+    {
+      static_cast<DelphesModule *>(object)->SetEventNumber(GetEventNumber(), GetInputNumber());
+    }
+  }
+
+  if(fTimeline) fTimeline->SetEvent(GetEventNumber());
+
+  if(fTimeline && fTimeline->IsActive())
+  {
+    start = fTimeline->Now();
+    ProcessModules();
+    fTimeline->AddSpan("Event", "event", start, fTimeline->Now(), GetEventNumber(),
+      IsEventAccepted() ? "\"accepted\":true" : "\"accepted\":false");
+  }
+  else
+  {
+    ProcessModules();
+  }
+
+  // readers may set the event number explicitly before each event
+  SetEventNumber(GetEventNumber() + 1, GetInputNumber());
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ProcessModules()
+{
+  Int_t i, size;
+  vector<Int_t>::iterator itRoots;
+  TIter itTasks(GetListOfTasks());
+  ExRootTask *task;
+
+  SetEventAccepted(kTRUE);
+
+  if(fWorkers.empty() && !fHasEventFilters)
+  {
+    ExRootTask::ProcessTask();
+    return;
+  }
+
+  Process();
+
+  if(fWorkers.empty())
+  {
+    // stop at the first filter rejecting the event
+    while((task = static_cast<ExRootTask *>(itTasks.Next())))
+    {
+      if(!task->IsActive()) continue;
+
+      task->ProcessTask();
+
+      if(task->InheritsFrom(DelphesModule::Class()) && !static_cast<DelphesModule *>(task)->IsEventAccepted())
+      {
+        SetEventAccepted(kFALSE);
+        break;
+      }
+    }
+    return;
+  }
+
+  size = fNodes.size();
+  for(i = 0; i < size; ++i)
+  {
+    *fPending[i] = fNodes[i].predecessors;
+  }
+
+  fAbort = false;
+  fRejected = false;
+  fException = exception_ptr();
+  fRemaining = size;
+
+  for(itRoots = fRoots.begin(); itRoots != fRoots.end(); ++itRoots)
+  {
+    PushNode(0, *itRoots);
+  }
+
+  // the calling thread takes part in the processing as worker 0
+  while(fRemaining > 0)
+  {
+    if(RunNext(0)) continue;
+
+    unique_lock<mutex> lock(fMutex);
+    while(fQueued <= 0 && fRemaining > 0) fCondition.wait(lock);
+  }
+
+  if(fException) rethrow_exception(fException);
+
+  if(fRejected) SetEventAccepted(kFALSE);
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::FinishTask()
+{
+  vector<ExRootTask *>::iterator itTasks;
+
+  StopWorkers();
+
+  // pruned modules were initialized, let them release their resources
+  for(itTasks = fPrunedTasks.begin(); itTasks != fPrunedTasks.end(); ++itTasks)
+  {
+    (*itTasks)->SetActive(kTRUE);
+  }
+  fPrunedTasks.clear();
+
+  ExRootTask::FinishTask();
+
+  if(fTimeline)
+  {
+    fTimeline->Close();
+    cout << "** Timeline of " << fTimeline->GetNumberOfSpans() << " spans recorded on ";
+    cout << fTimeline->GetNumberOfThreads() << " threads" << endl;
+  }
+
+  cout << "** Memory usage of the object pools:" << endl;
+  fFactory->PrintMemory();
+  if(fWriter) fWriter->PrintMemory();
+  if(fMemoryBudget > 0)
+  {
+    cout << "** " << fTrimCounter << " pool trims released " << fTrimmedBytes / 1048576.0 << " MB" << endl;
+  }
+
+  if(fWriter && fWriter->GetTree())
+  {
+    fWriter->AddInfo("FactoryPeakBytes", fFactory->GetPeakBytes());
+    fWriter->AddInfo("TreeWriterPeakBytes", fWriter->GetPeakBytes());
+    fWriter->AddInfo("PoolTrims", fTrimCounter);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::AnalyseDataFlow(TFlowStruct &flow)
+{
+  TIter itTasks(GetListOfTasks());
+  TObject *object;
+  DelphesModule *module;
+  Int_t i, a, size;
+  map<string, Int_t> arrays;
+  map<string, Int_t>::iterator itArrays;
+  vector<string>::const_iterator itNames;
+  vector<Int_t>::iterator itInputs;
+  vector<Int_t> stack;
+
+  // collect active modules and the arrays they import and export
+
+  while((object = itTasks.Next()))
+  {
+    if(!static_cast<ExRootTask *>(object)->IsActive()) continue;
+
+    flow.tasks.push_back(static_cast<ExRootTask *>(object));
+    flow.inputs.push_back(vector<Int_t>());
+    flow.outputs.push_back(vector<Int_t>());
+
+    if(!object->InheritsFrom(DelphesModule::Class()))
+    {
+      // unknown data flow, run in ExecutionPath order with respect to everything
+      flow.barrier.push_back(kTRUE);
+      flow.filter.push_back(kFALSE);
+      continue;
+    }
+    flow.barrier.push_back(kFALSE);
+
+    module = static_cast<DelphesModule *>(object);
+
+    flow.filter.push_back(module->IsEventFilter());
+
+    for(itNames = module->GetImportedArrays().begin(); itNames != module->GetImportedArrays().end(); ++itNames)
+    {
+      itArrays = arrays.insert(make_pair(*itNames, Int_t(arrays.size()))).first;
+      flow.inputs.back().push_back(itArrays->second);
+    }
+
+    for(itNames = module->GetExportedArrays().begin(); itNames != module->GetExportedArrays().end(); ++itNames)
+    {
+      itArrays = arrays.insert(make_pair(*itNames, Int_t(arrays.size()))).first;
+      flow.outputs.back().push_back(itArrays->second);
+    }
+
+    sort(flow.inputs.back().begin(), flow.inputs.back().end());
+    flow.inputs.back().erase(unique(flow.inputs.back().begin(), flow.inputs.back().end()), flow.inputs.back().end());
+  }
+
+  flow.arrays.resize(arrays.size());
+  for(itArrays = arrays.begin(); itArrays != arrays.end(); ++itArrays)
+  {
+    flow.arrays[itArrays->second] = itArrays->first;
+  }
+
+  size = flow.tasks.size();
+
+  flow.producers.assign(arrays.size(), -1);
+  for(i = 0; i < size; ++i)
+  {
+    for(itInputs = flow.outputs[i].begin(); itInputs != flow.outputs[i].end(); ++itInputs)
+    {
+      flow.producers[*itInputs] = i;
+    }
+  }
+
+  // modules without outputs (b- and tau-tagging, flavour association, ...)
+  // can only act by updating the candidates they import;
+  // arrays coming from the reader are treated as read-only,
+  // unless a module declares its updates with UpdateArray
+
+  flow.writes.resize(size);
+  for(i = 0; i < size; ++i)
+  {
+    if(flow.outputs[i].empty())
+    {
+      for(itInputs = flow.inputs[i].begin(); itInputs != flow.inputs[i].end(); ++itInputs)
+      {
+        if(flow.producers[*itInputs] >= 0) flow.writes[i].push_back(*itInputs);
+      }
+    }
+
+    if(flow.barrier[i]) continue;
+
+    module = static_cast<DelphesModule *>(flow.tasks[i]);
+    for(itNames = module->GetUpdatedArrays().begin(); itNames != module->GetUpdatedArrays().end(); ++itNames)
+    {
+      flow.writes[i].push_back(arrays[*itNames]);
+    }
+
+    sort(flow.writes[i].begin(), flow.writes[i].end());
+    flow.writes[i].erase(unique(flow.writes[i].begin(), flow.writes[i].end()), flow.writes[i].end());
+  }
+
+  // arrays whose candidates may be reached by each module
+
+  flow.upstream.assign(size, vector<Bool_t>(arrays.size(), kFALSE));
+  for(i = 0; i < size; ++i)
+  {
+    stack = flow.inputs[i];
+    while(!stack.empty())
+    {
+      a = stack.back();
+      stack.pop_back();
+      if(flow.upstream[i][a]) continue;
+      flow.upstream[i][a] = kTRUE;
+      if(flow.producers[a] >= 0)
+      {
+        stack.insert(stack.end(), flow.inputs[flow.producers[a]].begin(), flow.inputs[flow.producers[a]].end());
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::PruneModules()
+{
+  TFlowStruct flow;
+  ExRootConfParam param = GetConfReader()->GetParam("::ExecutionSinks");
+  Long_t n, sinks = param.GetSize();
+  Int_t i, j, size;
+  Bool_t changed;
+  vector<Bool_t> needed;
+  vector<Int_t>::iterator itInputs;
+  TString name;
+
+  AnalyseDataFlow(flow);
+
+  size = flow.tasks.size();
+  needed.assign(size, kFALSE);
+
+  // tree writers, declared sinks, event filters and modules with unknown side effects
+
+  for(i = 0; i < size; ++i)
+  {
+    name = flow.tasks[i]->GetName();
+    for(n = 0; n < sinks; ++n)
+    {
+      if(name == param[n].GetString()) needed[i] = kTRUE;
+    }
+    if(flow.tasks[i]->InheritsFrom("TreeWriter")) needed[i] = kTRUE;
+    if(flow.barrier[i] || flow.filter[i]) needed[i] = kTRUE;
+    if(flow.inputs[i].empty() && flow.outputs[i].empty()) needed[i] = kTRUE;
+  }
+
+  // walk back through the producers of imported arrays and pick up the
+  // modules updating candidates that a needed module can reach
+
+  do
+  {
+    changed = kFALSE;
+    for(i = 0; i < size; ++i)
+    {
+      if(!needed[i]) continue;
+
+      for(itInputs = flow.inputs[i].begin(); itInputs != flow.inputs[i].end(); ++itInputs)
+      {
+        j = flow.producers[*itInputs];
+        if(j >= 0 && !needed[j]) needed[j] = changed = kTRUE;
+      }
+
+      for(j = 0; j < size; ++j)
+      {
+        if(needed[j]) continue;
+        for(itInputs = flow.writes[j].begin(); itInputs != flow.writes[j].end(); ++itInputs)
+        {
+          if(flow.upstream[i][*itInputs])
+          {
+            needed[j] = changed = kTRUE;
+            break;
+          }
+        }
+      }
+    }
+  } while(changed);
+
+  cout << left;
+  for(i = 0; i < size; ++i)
+  {
+    if(needed[i]) continue;
+
+    cout << setw(30) << "** INFO: skipping module";
+    cout << setw(25) << flow.tasks[i]->GetName() << endl;
+
+    flow.tasks[i]->SetActive(kFALSE);
+    fPrunedTasks.push_back(flow.tasks[i]);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::BuildGraph()
+{
+  TFlowStruct flow;
+  Int_t i, j, k, size, depth;
+  vector<Int_t>::iterator itInputs;
+  vector<Int_t> length;
+  Bool_t connect;
+  TNodeStruct node;
+
+  AnalyseDataFlow(flow);
+
+  size = flow.tasks.size();
+
+  fNodes.clear();
+  fRoots.clear();
+
+  for(i = 0; i < size; ++i)
+  {
+    node.task = flow.tasks[i];
+    node.predecessors = 0;
+    fNodes.push_back(node);
+  }
+
+  // dependent modules keep their relative ExecutionPath order,
+  // so the graph is acyclic by construction;
+  // nothing after an event filter starts before the filter has decided
+
+  for(j = 0; j < size; ++j)
+  {
+    for(i = 0; i < j; ++i)
+    {
+      connect = flow.barrier[i] || flow.barrier[j] || flow.filter[i];
+
+      for(itInputs = flow.inputs[j].begin(); !connect && itInputs != flow.inputs[j].end(); ++itInputs)
+      {
+        connect = flow.producers[*itInputs] == i;
+      }
+
+      for(itInputs = flow.inputs[i].begin(); !connect && itInputs != flow.inputs[i].end(); ++itInputs)
+      {
+        connect = flow.producers[*itInputs] == j;
+      }
+
+      for(itInputs = flow.writes[i].begin(); !connect && itInputs != flow.writes[i].end(); ++itInputs)
+      {
+        connect = flow.upstream[j][*itInputs];
+      }
+
+      for(itInputs = flow.writes[j].begin(); !connect && itInputs != flow.writes[j].end(); ++itInputs)
+      {
+        connect = flow.upstream[i][*itInputs];
+      }
+
+      if(connect)
+      {
+        fNodes[i].successors.push_back(j);
+        ++fNodes[j].predecessors;
+      }
+    }
+  }
+
+  // length of the critical path
+
+  depth = 0;
+  length.assign(size, 1);
+  for(i = 0; i < size; ++i)
+  {
+    if(fNodes[i].predecessors == 0) fRoots.push_back(i);
+    for(k = 0; k < Int_t(fNodes[i].successors.size()); ++k)
+    {
+      j = fNodes[i].successors[k];
+      length[j] = max(length[j], length[i] + 1);
+    }
+    depth = max(depth, length[i]);
+  }
+
+  for(i = 0; i < Int_t(fPending.size()); ++i)
+  {
+    delete fPending[i];
+  }
+  fPending.clear();
+  for(i = 0; i < size; ++i)
+  {
+    fPending.push_back(new atomic<Int_t>(0));
+  }
+
+  cout << "** INFO: dependency graph of " << size << " modules, ";
+  cout << "critical path of " << depth << " modules" << endl;
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::ShareArrays()
+{
+  TFolder *sourceFolder, *exportFolder, *moduleFolder;
+  TObject *module, *object;
+  TObjArray *array;
+  TSharedArray shared;
+
+  // candidates of the source and of the cards end up in the same arrays,
+  // their identifiers come from one sequence to be comparable
+  fFactory->ShareCandidateIDs(fSource->GetFactory());
+
+  sourceFolder = static_cast<TFolder *>(fSource->GetFolder()->FindObject("Export"));
+  if(!sourceFolder) return;
+
+  exportFolder = static_cast<TFolder *>(GetFolder()->FindObject("Export"));
+  if(!exportFolder) exportFolder = GetFolder()->AddFolder("Export", "");
+
+  // arrays of the source and of its modules under the same names,
+  // aliases registered with ExportAlias are carried over as they are
+  TIter itModules(sourceFolder->GetListOfFolders());
+  while((module = itModules.Next()))
+  {
+    moduleFolder = exportFolder->AddFolder(module->GetName(), "");
+
+    TIter itArrays(static_cast<TFolder *>(module)->GetListOfFolders());
+    while((object = itArrays.Next()))
+    {
+      if(object->IsA() == TNamed::Class())
+      {
+        moduleFolder->Add(new TNamed(object->GetName(), object->GetTitle()));
+        continue;
+      }
+
+      array = GetFactory()->NewPermanentArray();
+      array->SetName(object->GetName());
+      moduleFolder->Add(array);
+
+      shared.path = string(module->GetName()) + "/" + object->GetName();
+      shared.source = static_cast<TObjArray *>(object);
+      shared.array = array;
+      shared.copy = kFALSE;
+      fSharedArrays.push_back(shared);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::CopySharedArrays()
+{
+  vector<TSharedArray>::iterator itShared;
+  TObject *candidate;
+  Int_t i, size;
+
+  for(itShared = fSharedArrays.begin(); itShared != fSharedArrays.end(); ++itShared)
+  {
+    if(!itShared->array->TestBit(kArrayImported)) continue;
+
+    size = itShared->source->GetEntriesFast();
+    for(i = 0; i < size; ++i)
+    {
+      candidate = itShared->source->UncheckedAt(i);
+      itShared->array->Add(itShared->copy ? candidate->Clone() : candidate);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Int_t Delphes::GetCommonModules(const vector<ExRootConfReader *> &confReaders)
+{
+  vector<ExRootConfReader *>::const_iterator itReaders;
+  ExRootConfReader *first;
+  ExRootConfParam param;
+  ExRootConfReader::ExRootTaskMap::const_iterator itModules;
+  TString name, className, configuration;
+  Int_t i, size;
+
+  if(confReaders.size() < 2) return 0;
+
+  first = confReaders.front();
+
+  // random number streams of the modules depend on the seed
+  for(itReaders = confReaders.begin() + 1; itReaders != confReaders.end(); ++itReaders)
+  {
+    if((*itReaders)->GetInt("::RandomSeed", 0) != first->GetInt("::RandomSeed", 0)) return 0;
+  }
+
+  param = first->GetParam("::ExecutionPath");
+  size = param.GetSize();
+
+  for(i = 0; i < size; ++i)
+  {
+    name = param[i].GetString();
+
+    itModules = first->GetModules()->find(name);
+    if(itModules == first->GetModules()->end()) return i;
+
+    className = itModules->second;
+
+    // each card keeps its own tree writer
+    if(className == "TreeWriter") return i;
+
+    configuration = first->GetModuleConfiguration(name);
+
+    for(itReaders = confReaders.begin() + 1; itReaders != confReaders.end(); ++itReaders)
+    {
+      param = (*itReaders)->GetParam("::ExecutionPath");
+      if(i >= param.GetSize() || name != param[i].GetString()) return i;
+
+      itModules = (*itReaders)->GetModules()->find(name);
+      if(itModules == (*itReaders)->GetModules()->end() || itModules->second != className) return i;
+
+      if((*itReaders)->GetModuleConfiguration(name) != configuration) return i;
+    }
+
+    param = first->GetParam("::ExecutionPath");
+  }
+
+  return size;
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::StartWorkers()
+{
+  Int_t i;
+
+  ROOT::EnableThreadSafety();
+
+  GetFactory()->SetThreadSafe(kTRUE);
+
+  // shared candidates are cloned by the factory of the source
+  if(fSource) fSource->GetFactory()->SetThreadSafe(kTRUE);
+
+  fSharedRandom = gRandom;
+  fRandom = new DelphesLockedRandom(fSharedRandom);
+  gRandom = fRandom;
+
+  fStop = kFALSE;
+  fQueued = 0;
+
+  for(i = 0; i < fNumberOfThreads; ++i)
+  {
+    fWorkers.push_back(new TWorkerStruct);
+  }
+
+  for(i = 1; i < fNumberOfThreads; ++i)
+  {
+    fThreads.push_back(thread(&Delphes::RunWorker, this, i));
+  }
+
+  cout << "** INFO: running modules on " << fNumberOfThreads << " threads" << endl;
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::StopWorkers()
+{
+  vector<thread>::iterator itThreads;
+  vector<TWorkerStruct *>::iterator itWorkers;
+  vector<atomic<Int_t> *>::iterator itPending;
+
+  if(fWorkers.empty()) return;
+
+  {
+    lock_guard<mutex> lock(fMutex);
+    fStop = kTRUE;
+  }
+  fCondition.notify_all();
+
+  for(itThreads = fThreads.begin(); itThreads != fThreads.end(); ++itThreads)
+  {
+    itThreads->join();
+  }
+  fThreads.clear();
+
+  for(itWorkers = fWorkers.begin(); itWorkers != fWorkers.end(); ++itWorkers)
+  {
+    delete *itWorkers;
+  }
+  fWorkers.clear();
+
+  for(itPending = fPending.begin(); itPending != fPending.end(); ++itPending)
+  {
+    delete *itPending;
+  }
+  fPending.clear();
+
+  gRandom = fSharedRandom;
+  delete fRandom;
+  fRandom = 0;
+
+  GetFactory()->SetThreadSafe(kFALSE);
+  if(fSource) fSource->GetFactory()->SetThreadSafe(kFALSE);
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::RunWorker(Int_t worker)
+{
+  while(true)
+  {
+    if(RunNext(worker)) continue;
+
+    unique_lock<mutex> lock(fMutex);
+    while(!fStop && fQueued <= 0) fCondition.wait(lock);
+    if(fStop) return;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Bool_t Delphes::RunNext(Int_t worker)
+{
+  Int_t i, node = -1, size = fWorkers.size();
+  TWorkerStruct *victim;
+
+  // newest node from the own queue, otherwise steal the oldest one
+  for(i = 0; i < size && node < 0; ++i)
+  {
+    victim = fWorkers[(worker + i) % size];
+    lock_guard<mutex> lock(victim->mutex);
+    if(victim->queue.empty()) continue;
+    if(i == 0)
+    {
+      node = victim->queue.back();
+      victim->queue.pop_back();
+    }
+    else
+    {
+      node = victim->queue.front();
+      victim->queue.pop_front();
+    }
+  }
+
+  if(node < 0) return kFALSE;
+
+  --fQueued;
+  RunNode(worker, node);
+
+  return kTRUE;
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::RunNode(Int_t worker, Int_t node)
+{
+  ExRootTask *task = fNodes[node].task;
+  vector<Int_t>::iterator itSuccessors;
+
+  if(!fAbort && !fRejected && task->IsActive())
+  {
+    try
+    {
+      task->ProcessTaskConcurrently();
+
+      if(task->InheritsFrom(DelphesModule::Class()) && !static_cast<DelphesModule *>(task)->IsEventAccepted())
+      {
+        fRejected = true;
+      }
+    }
+    catch(...)
+    {
+      lock_guard<mutex> lock(fMutex);
+      if(!fException) fException = current_exception();
+      fAbort = true;
+    }
+  }
+
+  // successors are still released after a failure or a rejection so that the event drains
+  for(itSuccessors = fNodes[node].successors.begin(); itSuccessors != fNodes[node].successors.end(); ++itSuccessors)
+  {
+    if(--(*fPending[*itSuccessors]) == 0) PushNode(worker, *itSuccessors);
+  }
+
+  if(--fRemaining == 0)
+  {
+    lock_guard<mutex> lock(fMutex);
+    fCondition.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Delphes::PushNode(Int_t worker, Int_t node)
+{
+  {
+    lock_guard<mutex> lock(fWorkers[worker]->mutex);
+    fWorkers[worker]->queue.push_back(node);
+  }
+  ++fQueued;
+
+  {
+    lock_guard<mutex> lock(fMutex);
+  }
+  fCondition.notify_one();
+}
+
+//------------------------------------------------------------------------------
@@ -24,15 +24,62 @@
  *  Main Delphes module.
  *  Controls execution of all other modules.
  *
+ *  With ParallelExecution enabled, the data flow recorded by ImportArray
+ *  and ExportArray is turned into a dependency graph at initialization
+ *  and independent modules of the same event run concurrently on a pool
+ *  of NumberOfThreads work-stealing threads.
+ *
+ *  With PruneExecutionPath enabled, modules whose outputs can not reach
+ *  a TreeWriter or one of the ExecutionSinks are switched off after
+ *  initialization.
+ *
+ *  Modules declared as event filters can reject the current event,
+ *  in which case the modules after them in ExecutionPath are skipped
+ *  and IsEventAccepted returns false.
+ *
+ *  With TimelineFile set, the module, reader and tree writer spans of
+ *  one event out of TimelineSampling are written in Chrome trace format.
+ *
+ *  With MemoryBudget (in MB) set, the object pools of the factory and
+ *  the tree writer are shrunk back to the working set of the last
+ *  MemoryWindow events whenever their size exceeds the budget.
+ *
+ *  With NumberOfProcesses larger than one, ForkProcesses forks the
+ *  initialized modules into worker processes sharing their memory
+ *  copy-on-write. Each worker writes its events to a shard of the
+ *  output file, and the shards are merged once all workers exit.
+ *
+ *  Several cards can process the same input: a source instance runs the
+ *  modules that lead all ExecutionPaths with identical configurations
+ *  (see GetCommonModules), and each card instance set up with SetSource
+ *  starts after them from read-only views of the arrays of the source.
+ *  The candidates of all instances are numbered from one sequence, see
+ *  DelphesFactory::ShareCandidateIDs.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
 
 #include "classes/DelphesModule.h"
 
+#if !defined(__CINT__) && !defined(__CLING__)
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#endif
+
+class TFile;
 class TFolder;
 class TObjArray;
+class TRandom;
 
+class ExRootConfReader;
+class ExRootTimeline;
 class ExRootTreeWriter;
 
 class DelphesFactory;
@@ -47,14 +94,130 @@ public:
 
   DelphesFactory *GetFactory() const { return fFactory; }
 
+  // bytes allocated by the object pools of the factory and the tree writer
+  Long64_t GetMemoryUsage() const;
+
+  // returns the worker number in the forked processes, or -1 in the parent
+  // once the workers are done and their output has been merged
+  Int_t ForkProcesses();
+  // terminates forked workers, does nothing otherwise
+  void ExitProcess(Int_t status);
+
+  Int_t GetNumberOfProcesses() const { return fNumberOfProcesses; }
+  Int_t GetProcessNumber() const { return fProcessNumber; }
+
+  // runs only the first modules of ExecutionPath, for a source instance
+  void SetNumberOfModules(Int_t modules) { fNumberOfModules = modules; }
+  // starts ExecutionPath after the modules run by the source instance,
+  // which must be initialized first and processed first in each event
+  void SetSource(Delphes *source) { fSource = source; }
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  // leading modules of ExecutionPath configured identically in all cards
+  static Int_t GetCommonModules(const std::vector<ExRootConfReader *> &confReaders);
+#endif
+
   void Clear();
 
   virtual void Init();
   virtual void Process();
   virtual void Finish();
 
+  virtual void InitTask();
+  virtual void ProcessTask();
+  virtual void FinishTask();
+
 private:
+  void ProcessModules();
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  struct TFlowStruct
+  {
+    std::vector<ExRootTask *> tasks;
+    std::vector<Bool_t> barrier, filter;
+    std::vector<std::vector<Int_t> > inputs, outputs, writes;
+    std::vector<std::vector<Bool_t> > upstream;
+    std::vector<Int_t> producers;
+    std::vector<std::string> arrays;
+  };
+
+  void AnalyseDataFlow(TFlowStruct &flow);
+#endif
+
+  void PruneModules();
+  void BuildGraph();
+
+  void ShareArrays();
+  void CopySharedArrays();
+
+  void StartWorkers();
+  void StopWorkers();
+
+  void RunWorker(Int_t worker);
+  Bool_t RunNext(Int_t worker);
+  void RunNode(Int_t worker, Int_t node);
+  void PushNode(Int_t worker, Int_t node);
+
   DelphesFactory *fFactory;
+  ExRootTreeWriter *fWriter; //!
+  ExRootTimeline *fTimeline; //!
+
+  Long64_t fMemoryBudget;
+  Long64_t fTrimCounter, fTrimmedBytes; //!
+
+  Bool_t fPruneExecutionPath;
+  Bool_t fParallelExecution;
+  Bool_t fHasEventFilters;
+  Int_t fNumberOfThreads;
+  Int_t fNumberOfProcesses, fProcessNumber;
+  Int_t fNumberOfModules;
+
+  Delphes *fSource; //!
+
+  TFile *fShardFile; //!
+
+  TRandom *fRandom, *fSharedRandom; //!
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  struct TNodeStruct
+  {
+    ExRootTask *task;
+    Int_t predecessors;
+    std::vector<Int_t> successors;
+  };
+
+  struct TWorkerStruct
+  {
+    std::mutex mutex;
+    std::deque<Int_t> queue;
+  };
+
+  struct TSharedArray
+  {
+    std::string path;
+    TObjArray *source, *array;
+    Bool_t copy;
+  };
+
+  std::vector<ExRootTask *> fPrunedTasks; //!
+  std::vector<TSharedArray> fSharedArrays; //!
+
+  std::vector<TNodeStruct> fNodes; //!
+  std::vector<Int_t> fRoots; //!
+
+  std::vector<std::atomic<Int_t> *> fPending; //!
+  std::vector<TWorkerStruct *> fWorkers; //!
+  std::vector<std::thread> fThreads; //!
+
+  std::mutex fMutex; //!
+  std::condition_variable fCondition; //!
+
+  std::atomic<Int_t> fQueued, fRemaining; //!
+  std::atomic<bool> fAbort, fRejected; //!
+  Bool_t fStop; //!
+
+  std::exception_ptr fException; //!
+#endif
 
   ClassDef(Delphes, 1)
 };
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -252,8 +253,8 @@ void DenseTrackFilter::FillTrack()
   phi = candidate->Momentum.Phi();
   m = candidate->Momentum.M();
 
-  eta = gRandom->Gaus(eta, fEtaPhiRes);
-  phi = gRandom->Gaus(phi, fEtaPhiRes);
+  eta = GetRandom()->Gaus(eta, fEtaPhiRes);
+  phi = GetRandom()->Gaus(phi, fEtaPhiRes);
   candidate->Momentum.SetPtEtaPhiM(pt, eta, phi, m);
   candidate->AddCandidate(track);
 
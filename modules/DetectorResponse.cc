@@ -0,0 +1,417 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class DetectorResponse
+ *
+ *  Applies an ordered list of efficiency, smearing and scale steps
+ *  (same parametrization as the Efficiency, MomentumSmearing,
+ *  EnergySmearing, EnergyScale and TimeSmearing modules)
+ *  to the InputArray in a single pass.
+ *
+ *  Random numbers are drawn in batches for all candidates of a step.
+ *  Each surviving candidate is cloned at most once, or modified in place
+ *  if CloneCandidates is false. In-place updates are rejected if other
+ *  modules read the InputArray.
+ *
+ */
+
+#include "modules/DetectorResponse.h"
+
+#include "classes/DelphesClasses.h"
+#include "classes/DelphesFactory.h"
+#include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
+
+#include "ExRootAnalysis/ExRootClassifier.h"
+#include "ExRootAnalysis/ExRootFilter.h"
+#include "ExRootAnalysis/ExRootResult.h"
+
+#include "TLorentzVector.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TRandom3.h"
+#include "TString.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+DetectorResponse::DetectorResponse() :
+  fItInputArray(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+DetectorResponse::~DetectorResponse()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::Init()
+{
+  stringstream message;
+  ExRootConfParam param;
+  DelphesFormula *formula;
+  TString type;
+  EStepType step;
+  Int_t i, size;
+
+  // read ordered list of steps
+
+  param = GetParam("Step");
+  size = param.GetSize();
+
+  fSteps.clear();
+  for(i = 0; i < size / 2; ++i)
+  {
+    type = param[i * 2].GetString();
+
+    if(type == "Efficiency")
+      step = kEfficiency;
+    else if(type == "MomentumSmearing")
+      step = kMomentumSmearing;
+    else if(type == "EnergySmearing")
+      step = kEnergySmearing;
+    else if(type == "EnergyScale")
+      step = kEnergyScale;
+    else if(type == "TimeSmearing")
+      step = kTimeSmearing;
+    else
+    {
+      message << "unknown step type '" << type << "' in module '" << GetName() << "'";
+      throw runtime_error(message.str());
+    }
+
+    formula = new DelphesFormula;
+    formula->Compile(param[i * 2 + 1].GetString());
+
+    fSteps.push_back(make_pair(step, formula));
+  }
+
+  // clone candidates only if the unsmeared ones are used by other modules
+  fCloneCandidates = GetBool("CloneCandidates", true);
+
+  // switch to compute efficiency and momentum smearing based on momentum vector eta, phi
+  fUseMomentumVector = GetBool("UseMomentumVector", false);
+
+  // import input array, declared as updated if the candidates are modified in place
+
+  if(fCloneCandidates)
+  {
+    fInputArray = ImportArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
+  }
+  else
+  {
+    fInputArray = UpdateArray(GetString("InputArray", "ParticlePropagator/stableParticles"));
+  }
+  fItInputArray = fInputArray->MakeIterator();
+
+  // create output array
+
+  fOutputArray = ExportArray(GetString("OutputArray", "stableParticles"));
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::Finish()
+{
+  TStepList::iterator itSteps;
+
+  if(fItInputArray) delete fItInputArray;
+
+  for(itSteps = fSteps.begin(); itSteps != fSteps.end(); ++itSteps)
+  {
+    if(itSteps->second) delete itSteps->second;
+  }
+  fSteps.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::Process()
+{
+  Candidate *candidate;
+  TStepList::iterator itSteps;
+  vector<Candidate *>::iterator itCandidates;
+  Bool_t cloned = kFALSE;
+  stringstream message;
+
+  // all modules are initialised by now, the input candidates
+  // can only be modified in place if no other module reads them
+  if(!fCloneCandidates && fInputArray->TestBit(kArrayImportedTwice))
+  {
+    message << "input array of module '" << GetName() << "' is read by other modules, ";
+    message << "its candidates can't be modified in place (CloneCandidates = false)";
+    throw runtime_error(message.str());
+  }
+
+  fCandidates.clear();
+
+  fItInputArray->Reset();
+  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  {
+    fCandidates.push_back(candidate);
+  }
+
+  for(itSteps = fSteps.begin(); itSteps != fSteps.end() && !fCandidates.empty(); ++itSteps)
+  {
+    // efficiencies only select candidates, everything else modifies them
+    if(itSteps->first != kEfficiency && fCloneCandidates && !cloned)
+    {
+      CloneCandidates();
+      cloned = kTRUE;
+    }
+
+    switch(itSteps->first)
+    {
+      case kEfficiency:
+        ApplyEfficiency(itSteps->second);
+        break;
+      case kMomentumSmearing:
+        ApplyMomentumSmearing(itSteps->second);
+        break;
+      case kEnergySmearing:
+        ApplyEnergySmearing(itSteps->second);
+        break;
+      case kEnergyScale:
+        ApplyEnergyScale(itSteps->second);
+        break;
+      case kTimeSmearing:
+        ApplyTimeSmearing(itSteps->second);
+        break;
+    }
+  }
+
+  for(itCandidates = fCandidates.begin(); itCandidates != fCandidates.end(); ++itCandidates)
+  {
+    fOutputArray->Add(*itCandidates);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::CloneCandidates()
+{
+  Candidate *candidate, *mother;
+  vector<Candidate *>::iterator itCandidates;
+
+  for(itCandidates = fCandidates.begin(); itCandidates != fCandidates.end(); ++itCandidates)
+  {
+    mother = *itCandidates;
+    candidate = static_cast<Candidate *>(mother->Clone());
+    candidate->AddCandidate(mother);
+    *itCandidates = candidate;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::ApplyEfficiency(DelphesFormula *formula)
+{
+  Candidate *candidate;
+  Double_t pt, eta, phi, e;
+  Int_t i, j, size = fCandidates.size();
+
+  FillUniform(size);
+
+  for(i = 0, j = 0; i < size; ++i)
+  {
+    candidate = fCandidates[i];
+
+    const TLorentzVector &candidatePosition = candidate->Position;
+    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    eta = fUseMomentumVector ? candidateMomentum.Eta() : candidatePosition.Eta();
+    phi = fUseMomentumVector ? candidateMomentum.Phi() : candidatePosition.Phi();
+    pt = candidateMomentum.Pt();
+    e = candidateMomentum.E();
+
+    if(fUniform[i] > formula->Eval(pt, eta, phi, e, candidate)) continue;
+
+    fCandidates[j++] = candidate;
+  }
+
+  fCandidates.resize(j);
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::ApplyMomentumSmearing(DelphesFormula *formula)
+{
+  Candidate *candidate;
+  Double_t pt, eta, phi, e, m, res, a, b;
+  Int_t i, size = fCandidates.size();
+
+  FillGaus(size);
+
+  for(i = 0; i < size; ++i)
+  {
+    candidate = fCandidates[i];
+
+    const TLorentzVector &candidatePosition = candidate->Position;
+    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    eta = fUseMomentumVector ? candidateMomentum.Eta() : candidatePosition.Eta();
+    phi = fUseMomentumVector ? candidateMomentum.Phi() : candidatePosition.Phi();
+    pt = candidateMomentum.Pt();
+    e = candidateMomentum.E();
+    m = candidateMomentum.M();
+
+    res = formula->Eval(pt, eta, phi, e, candidate);
+    res = (res > 1.0) ? 1.0 : res;
+
+    // log-normal smearing, see MomentumSmearing::LogNormal
+    if(pt > 0.0)
+    {
+      b = TMath::Sqrt(TMath::Log(1.0 + res * res));
+      a = TMath::Log(pt) - 0.5 * b * b;
+      pt = TMath::Exp(a + b * fGaus[i]);
+    }
+    else
+    {
+      pt = 0.0;
+    }
+
+    eta = candidateMomentum.Eta();
+    phi = candidateMomentum.Phi();
+    candidate->Momentum.SetPtEtaPhiM(pt, eta, phi, m);
+    candidate->TrackResolution = res;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::ApplyEnergySmearing(DelphesFormula *formula)
+{
+  Candidate *candidate;
+  Double_t pt, energy, eta, phi, m, e;
+  Int_t i, j, size = fCandidates.size();
+
+  FillGaus(size);
+
+  for(i = 0, j = 0; i < size; ++i)
+  {
+    candidate = fCandidates[i];
+
+    const TLorentzVector &candidatePosition = candidate->Position;
+    const TLorentzVector &candidateMomentum = candidate->Momentum;
+    pt = candidatePosition.Pt();
+    eta = candidatePosition.Eta();
+    phi = candidatePosition.Phi();
+    energy = e = candidateMomentum.E();
+    m = candidateMomentum.M();
+
+    energy += fGaus[i] * formula->Eval(pt, eta, phi, energy);
+
+    if(energy <= 0.0) continue;
+
+    eta = candidateMomentum.Eta();
+    phi = candidateMomentum.Phi();
+    pt = (energy > m) ? TMath::Sqrt(energy * energy - m * m) / TMath::CosH(eta) : 0;
+    candidate->Momentum.SetPtEtaPhiE(pt, eta, phi, energy);
+    candidate->TrackResolution = formula->Eval(pt, eta, phi, energy) / e;
+
+    fCandidates[j++] = candidate;
+  }
+
+  fCandidates.resize(j);
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::ApplyEnergyScale(DelphesFormula *formula)
+{
+  Candidate *candidate;
+  Double_t scale;
+  Int_t i, size = fCandidates.size();
+
+  for(i = 0; i < size; ++i)
+  {
+    candidate = fCandidates[i];
+
+    const TLorentzVector &momentum = candidate->Momentum;
+
+    scale = formula->Eval(momentum.Pt(), momentum.Eta(), momentum.Phi(), momentum.E());
+
+    if(scale > 0.0) candidate->Momentum *= scale;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::ApplyTimeSmearing(DelphesFormula *formula)
+{
+  Candidate *candidate;
+  Double_t tf, timeResolution;
+  Int_t i, size = fCandidates.size();
+
+  const Double_t c_light = 2.99792458E8;
+
+  FillGaus(size);
+
+  for(i = 0; i < size; ++i)
+  {
+    candidate = fCandidates[i];
+
+    const TLorentzVector &candidateMomentum = candidate->Momentum;
+
+    tf = candidate->Position.T() * 1.0E-3 / c_light;
+
+    timeResolution = formula->Eval(0.0, candidateMomentum.Eta(), 0.0, candidateMomentum.E());
+
+    tf += fGaus[i] * timeResolution;
+
+    candidate->Position.SetT(tf * 1.0E3 * c_light);
+    candidate->ErrorT = timeResolution * 1.0E3 * c_light;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::FillUniform(Int_t size)
+{
+  fUniform.resize(size);
+  if(size > 0) GetRandom()->RndmArray(size, &fUniform[0]);
+}
+
+//------------------------------------------------------------------------------
+
+void DetectorResponse::FillGaus(Int_t size)
+{
+  Int_t i;
+  Double_t r, phi;
+
+  // Box-Muller transform of a batch of uniform random numbers
+  FillUniform(size + size % 2);
+  fGaus.resize(size + size % 2);
+
+  for(i = 0; i < size; i += 2)
+  {
+    r = TMath::Sqrt(-2.0 * TMath::Log(fUniform[i]));
+    phi = TMath::TwoPi() * fUniform[i + 1];
+    fGaus[i] = r * TMath::Cos(phi);
+    fGaus[i + 1] = r * TMath::Sin(phi);
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DetectorResponse_h
+#define DetectorResponse_h
+
+/** \class DetectorResponse
+ *
+ *  Applies an ordered list of efficiency, smearing and scale steps
+ *  (same parametrization as the Efficiency, MomentumSmearing,
+ *  EnergySmearing, EnergyScale and TimeSmearing modules)
+ *  to the InputArray in a single pass.
+ *
+ *  Random numbers are drawn in batches for all candidates of a step.
+ *  Each surviving candidate is cloned at most once, or modified in place
+ *  if CloneCandidates is false. In-place updates are rejected if other
+ *  modules read the InputArray.
+ *
+ */
+
+#include "classes/DelphesModule.h"
+
+#include <utility>
+#include <vector>
+
+class TIterator;
+class TObjArray;
+class Candidate;
+class DelphesFormula;
+
+class DetectorResponse: public DelphesModule
+{
+public:
+  DetectorResponse();
+  ~DetectorResponse();
+
+  void Init();
+  void Process();
+  void Finish();
+
+private:
+  enum EStepType
+  {
+    kEfficiency,
+    kMomentumSmearing,
+    kEnergySmearing,
+    kEnergyScale,
+    kTimeSmearing
+  };
+
+  typedef std::vector<std::pair<EStepType, DelphesFormula *> > TStepList; //!
+
+  void ApplyEfficiency(DelphesFormula *formula);
+  void ApplyMomentumSmearing(DelphesFormula *formula);
+  void ApplyEnergySmearing(DelphesFormula *formula);
+  void ApplyEnergyScale(DelphesFormula *formula);
+  void ApplyTimeSmearing(DelphesFormula *formula);
+
+  void CloneCandidates();
+
+  void FillUniform(Int_t size);
+  void FillGaus(Int_t size);
+
+  TStepList fSteps; //!
+
+  Bool_t fCloneCandidates;
+  Bool_t fUseMomentumVector;
+
+  std::vector<Candidate *> fCandidates; //!
+  std::vector<Double_t> fUniform, fGaus; //!
+
+  TIterator *fItInputArray; //!
+
+  const TObjArray *fInputArray; //!
+
+  TObjArray *fOutputArray; //!
+
+  ClassDef(DetectorResponse, 1)
+};
+
+#endif
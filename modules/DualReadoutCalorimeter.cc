@@ -36,6 +36,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootResult.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -420,7 +421,7 @@ void DualReadoutCalorimeter::Process()
       {
         if(fElectronsFromTrack)
         {
-          fTower->ECalEnergyTimePairs.push_back(make_pair<Float_t, Float_t>(ecalEnergy, track->Position.T()));
+          fTower->AddECalEnergyTimePair(ecalEnergy, track->Position.T());
         }
       }
 
@@ -535,8 +536,8 @@ void DualReadoutCalorimeter::FinalizeTower()
 
   if(fSmearTowerCenter)
   {
-    eta = gRandom->Uniform(fTowerEdges[0], fTowerEdges[1]);
-    phi = gRandom->Uniform(fTowerEdges[2], fTowerEdges[3]);
+    eta = GetRandom()->Uniform(fTowerEdges[0], fTowerEdges[1]);
+    phi = GetRandom()->Uniform(fTowerEdges[2], fTowerEdges[3]);
   }
   else
   {
@@ -657,7 +658,7 @@ Double_t DualReadoutCalorimeter::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma*sigma)/(mean*mean))));
     a = TMath::Log(mean) - 0.5*b*b;
 
-    return TMath::Exp(a + b*gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b*GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
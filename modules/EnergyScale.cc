@@ -97,6 +97,9 @@ void EnergyScale::Process()
   TLorentzVector momentum;
   Double_t scale;
 
+  // skip the output if no other module reads it
+  if(!fOutputArray->TestBit(kArrayImported)) return;
+
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -109,7 +110,7 @@ void EnergySmearing::Process()
     m = candidateMomentum.M();
 
     // apply smearing formula
-    energy = gRandom->Gaus(energy, fFormula->Eval(pt, eta, phi, energy));
+    energy = GetRandom()->Gaus(energy, fFormula->Eval(pt, eta, phi, energy));
 
     if(energy <= 0.0) continue;
 
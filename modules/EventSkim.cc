@@ -0,0 +1,174 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \class EventSkim
+ *
+ *  Rejects events that fail a set of requirements on exported arrays.
+ *  Each requirement asks for a minimum number of candidates above a PT
+ *  threshold and within an |eta| range, a maximum |eta| of zero or less
+ *  disables the |eta| requirement. Applied to ScalarHT/energy or
+ *  MissingET/momentum with such a maximum, it acts as an HT or MET cut.
+ *  When the event is rejected, Delphes skips the remaining modules and
+ *  the event is not written.
+ *
+ */
+
+#include "modules/EventSkim.h"
+
+#include "classes/DelphesClasses.h"
+
+#include "TLorentzVector.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TString.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+EventSkim::EventSkim() :
+  fRequireAll(kTRUE), fProcessed(0), fAccepted(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+EventSkim::~EventSkim()
+{
+}
+
+//------------------------------------------------------------------------------
+
+void EventSkim::Init()
+{
+  stringstream message;
+  ExRootConfParam param;
+  Long_t i, size;
+  TRequirementStruct requirement;
+
+  // requirement format:
+  // {input array} {minimum PT} {maximum |eta|, none if <= 0} {minimum multiplicity}
+
+  param = GetParam("Requirement");
+  size = param.GetSize();
+
+  if(size == 0 || size % 4 != 0)
+  {
+    message << "module '" << GetName();
+    message << "' expects Requirement entries of the form";
+    message << " {input array} {PT min} {|eta| max} {multiplicity min}";
+    throw runtime_error(message.str());
+  }
+
+  fRequirements.clear();
+  for(i = 0; i < size / 4; ++i)
+  {
+    requirement.name = param[i * 4].GetString();
+    requirement.iterator = ImportArray(requirement.name)->MakeIterator();
+    requirement.ptMin = param[i * 4 + 1].GetDouble();
+    requirement.etaMax = param[i * 4 + 2].GetDouble();
+    requirement.countMin = param[i * 4 + 3].GetInt();
+    requirement.passed = 0;
+
+    fRequirements.push_back(requirement);
+  }
+
+  // accept the event when all (true) or any (false) of the requirements are met
+  fRequireAll = GetBool("RequireAll", true);
+
+  fProcessed = 0;
+  fAccepted = 0;
+
+  SetEventFilter(kTRUE);
+}
+
+//------------------------------------------------------------------------------
+
+void EventSkim::Finish()
+{
+  vector<TRequirementStruct>::iterator itRequirements;
+
+  cout << left;
+  cout << setw(30) << "** INFO: skim" << setw(25) << GetName();
+  cout << "accepted " << fAccepted << " of " << fProcessed << " events" << endl;
+
+  for(itRequirements = fRequirements.begin(); itRequirements != fRequirements.end(); ++itRequirements)
+  {
+    cout << setw(30) << "** INFO:   requirement" << setw(25) << itRequirements->name;
+    cout << "passed by " << itRequirements->passed << " events" << endl;
+
+    if(itRequirements->iterator) delete itRequirements->iterator;
+  }
+  fRequirements.clear();
+
+  AddInfo(Form("%s_Processed", GetName()), fProcessed);
+  AddInfo(Form("%s_Accepted", GetName()), fAccepted);
+}
+
+//------------------------------------------------------------------------------
+
+void EventSkim::Process()
+{
+  Candidate *candidate;
+  vector<TRequirementStruct>::iterator itRequirements;
+  Int_t count;
+  Double_t pt;
+  Bool_t pass, accepted = fRequireAll;
+
+  for(itRequirements = fRequirements.begin(); itRequirements != fRequirements.end(); ++itRequirements)
+  {
+    count = 0;
+    itRequirements->iterator->Reset();
+    while((candidate = static_cast<Candidate *>(itRequirements->iterator->Next())))
+    {
+      const TLorentzVector &candidateMomentum = candidate->Momentum;
+
+      pt = candidateMomentum.Pt();
+      if(pt < itRequirements->ptMin) continue;
+
+      // eta is undefined for candidates without transverse momentum
+      if(itRequirements->etaMax > 0.0 && (pt <= 0.0 || TMath::Abs(candidateMomentum.Eta()) > itRequirements->etaMax)) continue;
+
+      if(++count >= itRequirements->countMin) break;
+    }
+
+    pass = count >= itRequirements->countMin;
+    if(pass) ++itRequirements->passed;
+
+    if(fRequireAll)
+    {
+      accepted = accepted && pass;
+    }
+    else
+    {
+      accepted = accepted || pass;
+    }
+  }
+
+  ++fProcessed;
+  if(accepted) ++fAccepted;
+
+  SetEventAccepted(accepted);
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EventSkim_h
+#define EventSkim_h
+
+/** \class EventSkim
+ *
+ *  Rejects events that fail a set of requirements on exported arrays.
+ *  Each requirement asks for a minimum number of candidates above a PT
+ *  threshold and within an |eta| range, a maximum |eta| of zero or less
+ *  disables the |eta| requirement. Applied to ScalarHT/energy or
+ *  MissingET/momentum with such a maximum, it acts as an HT or MET cut.
+ *  When the event is rejected, Delphes skips the remaining modules and
+ *  the event is not written.
+ *
+ */
+
+#include "classes/DelphesModule.h"
+
+#include <vector>
+
+class TIterator;
+
+class EventSkim: public DelphesModule
+{
+public:
+  EventSkim();
+  ~EventSkim();
+
+  void Init();
+  void Process();
+  void Finish();
+
+private:
+#if !defined(__CINT__) && !defined(__CLING__)
+  struct TRequirementStruct
+  {
+    TString name;
+    TIterator *iterator;
+    Double_t ptMin;
+    Double_t etaMax;
+    Int_t countMin;
+    Long64_t passed;
+  };
+
+  std::vector<TRequirementStruct> fRequirements; //!
+#endif
+
+  Bool_t fRequireAll;
+
+  Long64_t fProcessed, fAccepted;
+
+  ClassDef(EventSkim, 1)
+};
+
+#endif
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -118,7 +119,7 @@ void ExampleModule::Process()
     candidateMomentum = candidate->Momentum;
 
     // apply an efficency formula
-    if(gRandom->Uniform() <= fFormula->Eval(candidateMomentum.Pt(), candidatePosition.Eta()))
+    if(GetRandom()->Uniform() <= fFormula->Eval(candidateMomentum.Pt(), candidatePosition.Eta()))
     {
       fOutputArray->Add(candidate);
     }
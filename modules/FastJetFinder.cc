@@ -474,10 +474,14 @@ void FastJetFinder::Process()
     candidate->ChargedEnergyFraction = (momentum.E() > 0 ) ? chargedEnergyFraction/momentum.E() : 0.0;
 
     //for exclusive clustering, access y_n,n+1 as exclusive_ymerge (fNJets);
-    candidate->ExclYmerge23 = excl_ymerge23;
-    candidate->ExclYmerge34 = excl_ymerge34;
-    candidate->ExclYmerge45 = excl_ymerge45;
-    candidate->ExclYmerge56 = excl_ymerge56;
+    if(fExclusiveClustering)
+    {
+      CandidateSubstructure &substructure = candidate->EditSubstructure();
+      substructure.ExclYmerge23 = excl_ymerge23;
+      substructure.ExclYmerge34 = excl_ymerge34;
+      substructure.ExclYmerge45 = excl_ymerge45;
+      substructure.ExclYmerge56 = excl_ymerge56;
+    }
 
     //------------------------------------
     // Trimming
@@ -488,20 +492,22 @@ void FastJetFinder::Process()
 
       fastjet::Filter trimmer(fastjet::JetDefinition(fastjet::kt_algorithm, fRTrim), fastjet::SelectorPtFractionMin(fPtFracTrim));
       fastjet::PseudoJet trimmed_jet = trimmer(*itOutputList);
-      
-      candidate->TrimmedP4[0].SetPtEtaPhiM(trimmed_jet.pt(), trimmed_jet.eta(), trimmed_jet.phi(), trimmed_jet.m());
+
+      CandidateSubstructure &substructure = candidate->EditSubstructure();
+
+      substructure.TrimmedP4[0].SetPtEtaPhiM(trimmed_jet.pt(), trimmed_jet.eta(), trimmed_jet.phi(), trimmed_jet.m());
 
       // four hardest subjets
       subjets.clear();
       subjets = trimmed_jet.pieces();
       subjets = sorted_by_pt(subjets);
 
-      candidate->NSubJetsTrimmed = subjets.size();
+      substructure.NSubJetsTrimmed = subjets.size();
 
       for(size_t i = 0; i < subjets.size() and i < 4; i++)
       {
         if(subjets.at(i).pt() < 0) continue;
-        candidate->TrimmedP4[i + 1].SetPtEtaPhiM(subjets.at(i).pt(), subjets.at(i).eta(), subjets.at(i).phi(), subjets.at(i).m());
+        substructure.TrimmedP4[i + 1].SetPtEtaPhiM(subjets.at(i).pt(), subjets.at(i).eta(), subjets.at(i).phi(), subjets.at(i).m());
       }
     }
 
@@ -515,19 +521,21 @@ void FastJetFinder::Process()
       fastjet::Pruner pruner(fastjet::JetDefinition(fastjet::cambridge_algorithm, fRPrun), fZcutPrun, fRcutPrun);
       fastjet::PseudoJet pruned_jet = pruner(*itOutputList);
 
-      candidate->PrunedP4[0].SetPtEtaPhiM(pruned_jet.pt(), pruned_jet.eta(), pruned_jet.phi(), pruned_jet.m());
+      CandidateSubstructure &substructure = candidate->EditSubstructure();
+
+      substructure.PrunedP4[0].SetPtEtaPhiM(pruned_jet.pt(), pruned_jet.eta(), pruned_jet.phi(), pruned_jet.m());
 
       // four hardest subjet
       subjets.clear();
       subjets = pruned_jet.pieces();
       subjets = sorted_by_pt(subjets);
 
-      candidate->NSubJetsPruned = subjets.size();
+      substructure.NSubJetsPruned = subjets.size();
 
       for(size_t i = 0; i < subjets.size() and i < 4; i++)
       {
         if(subjets.at(i).pt() < 0) continue;
-        candidate->PrunedP4[i + 1].SetPtEtaPhiM(subjets.at(i).pt(), subjets.at(i).eta(), subjets.at(i).phi(), subjets.at(i).m());
+        substructure.PrunedP4[i + 1].SetPtEtaPhiM(subjets.at(i).pt(), subjets.at(i).eta(), subjets.at(i).phi(), subjets.at(i).m());
       }
     }
 
@@ -541,23 +549,25 @@ void FastJetFinder::Process()
       contrib::SoftDrop softDrop(fBetaSoftDrop, fSymmetryCutSoftDrop, fR0SoftDrop);
       fastjet::PseudoJet softdrop_jet = softDrop(*itOutputList);
 
-      candidate->SoftDroppedP4[0].SetPtEtaPhiM(softdrop_jet.pt(), softdrop_jet.eta(), softdrop_jet.phi(), softdrop_jet.m());
+      CandidateSubstructure &substructure = candidate->EditSubstructure();
+
+      substructure.SoftDroppedP4[0].SetPtEtaPhiM(softdrop_jet.pt(), softdrop_jet.eta(), softdrop_jet.phi(), softdrop_jet.m());
 
       // four hardest subjet
 
       subjets.clear();
       subjets = softdrop_jet.pieces();
       subjets = sorted_by_pt(subjets);
-      candidate->NSubJetsSoftDropped = softdrop_jet.pieces().size();
+      substructure.NSubJetsSoftDropped = softdrop_jet.pieces().size();
 
-      candidate->SoftDroppedJet = candidate->SoftDroppedP4[0];
+      substructure.SoftDroppedJet = substructure.SoftDroppedP4[0];
 
       for(size_t i = 0; i < subjets.size() and i < 4; i++)
       {
         if(subjets.at(i).pt() < 0) continue;
-        candidate->SoftDroppedP4[i + 1].SetPtEtaPhiM(subjets.at(i).pt(), subjets.at(i).eta(), subjets.at(i).phi(), subjets.at(i).m());
-        if(i == 0) candidate->SoftDroppedSubJet1 = candidate->SoftDroppedP4[i + 1];
-        if(i == 1) candidate->SoftDroppedSubJet2 = candidate->SoftDroppedP4[i + 1];
+        substructure.SoftDroppedP4[i + 1].SetPtEtaPhiM(subjets.at(i).pt(), subjets.at(i).eta(), subjets.at(i).phi(), subjets.at(i).m());
+        if(i == 0) substructure.SoftDroppedSubJet1 = substructure.SoftDroppedP4[i + 1];
+        if(i == 1) substructure.SoftDroppedSubJet2 = substructure.SoftDroppedP4[i + 1];
       }
     }
 
@@ -572,11 +582,13 @@ void FastJetFinder::Process()
       Nsubjettiness nSub4(4, *fAxesDef, *fMeasureDef);
       Nsubjettiness nSub5(5, *fAxesDef, *fMeasureDef);
 
-      candidate->Tau[0] = nSub1(*itOutputList);
-      candidate->Tau[1] = nSub2(*itOutputList);
-      candidate->Tau[2] = nSub3(*itOutputList);
-      candidate->Tau[3] = nSub4(*itOutputList);
-      candidate->Tau[4] = nSub5(*itOutputList);
+      CandidateSubstructure &substructure = candidate->EditSubstructure();
+
+      substructure.Tau[0] = nSub1(*itOutputList);
+      substructure.Tau[1] = nSub2(*itOutputList);
+      substructure.Tau[2] = nSub3(*itOutputList);
+      substructure.Tau[3] = nSub4(*itOutputList);
+      substructure.Tau[4] = nSub5(*itOutputList);
     }
 
     fOutputArray->Add(candidate);
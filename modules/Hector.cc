@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -138,7 +139,7 @@ void Hector::Process()
 
     theta = TMath::Hypot(TMath::ATan(candidateMomentum.Px() / pz), TMath::ATan(candidateMomentum.Py() / pz));
     distance = (fDistance - 1.0E-3 * candidatePosition.Z()) / TMath::Cos(theta);
-    time = gRandom->Gaus((distance + 1.0E-3 * candidatePosition.T()) / c_light, fSigmaT);
+    time = GetRandom()->Gaus((distance + 1.0E-3 * candidatePosition.T()) / c_light, fSigmaT);
 
     H_BeamParticle particle(candidate->Mass, candidate->Charge);
     //    particle.set4Momentum(candidateMomentum);
@@ -146,8 +147,8 @@ void Hector::Process()
       candidateMomentum.Pz(), candidateMomentum.E());
     particle.setPosition(x, y, tx, ty, z);
 
-    particle.smearAng(fSigmaX, fSigmaY, gRandom);
-    particle.smearE(fSigmaE, gRandom);
+    particle.smearAng(fSigmaX, fSigmaY, GetRandom());
+    particle.smearE(fSigmaE, GetRandom());
 
     particle.computePath(fBeamLine);
 
@@ -120,7 +120,7 @@ void Isolation::Init()
 
   fFilter = new ExRootFilter(fIsolationInputArray);
 
-  fCandidateInputArray = ImportArray(GetString("CandidateInputArray", "Calorimeter/electrons"));
+  fCandidateInputArray = UpdateArray(GetString("CandidateInputArray", "Calorimeter/electrons"));
   fItCandidateInputArray = fCandidateInputArray->MakeIterator();
 
   rhoInputArrayName = GetString("RhoInputArray", "");
@@ -205,7 +205,7 @@ void Isolation::Process()
       }
       else
       {
-        pass = candidateMomentum.DeltaR(isolationMomentum) <= fDeltaRMax && candidate->GetUniqueID() != isolation->GetUniqueID();
+        pass = candidateMomentum.DeltaR(isolationMomentum) <= fDeltaRMax && candidate->GetCandidateID() != isolation->GetCandidateID();
       }
 
       if(pass)
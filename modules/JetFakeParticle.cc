@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -151,7 +152,7 @@ void JetFakeParticle::Process()
     pt = candidateMomentum.Pt();
     e = candidateMomentum.E();
 
-    r = gRandom->Uniform();
+    r = GetRandom()->Uniform();
     total = 0.0;
     fake = 0;
 
@@ -177,7 +178,7 @@ void JetFakeParticle::Process()
           }
           else
           {
-            rs = gRandom->Uniform();
+            rs = GetRandom()->Uniform();
             fake->Charge = (rs < 0.5) ? -1 : 1;
           }
         }
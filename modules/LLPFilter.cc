@@ -98,7 +98,7 @@ void LLPFilter::Init()
   fCharge = GetInt("Charge", 1);
 
   // import input array
-  fInputArray = ImportArray(GetString("InputArray", "Delphes/allParticles"));
+  fInputArray = UpdateArray(GetString("InputArray", "Delphes/allParticles"));
   fItInputArray = fInputArray->MakeIterator();
 
   fParticleInputArray =  ImportArray(GetString("InputArray", "Delphes/allParticles"));
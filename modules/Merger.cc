@@ -20,6 +20,7 @@
  *
  *  Merges multiple input arrays into one output array
  *  and sums transverse momenta of all input objects.
+ *  A single input array is exported as an alias, without copying.
  *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
@@ -84,7 +85,16 @@ void Merger::Init()
 
   // create output arrays
 
-  fOutputArray = ExportArray(GetString("OutputArray", "candidates"));
+  // a single input array is exported as it is, without copying its content
+  fOutputArray = 0;
+  if(size == 1)
+  {
+    ExportAlias(GetString("OutputArray", "candidates"), param[0].GetString());
+  }
+  else
+  {
+    fOutputArray = ExportArray(GetString("OutputArray", "candidates"));
+  }
 
   fMomentumOutputArray = ExportArray(GetString("MomentumOutputArray", "momentum"));
 
@@ -114,9 +124,17 @@ void Merger::Process()
   Double_t sumPT, sumE;
   vector<TIterator *>::iterator itInputList;
   TIterator *iterator;
+  Bool_t fillOutput, fillMomentum, fillEnergy;
 
   DelphesFactory *factory = GetFactory();
 
+  // skip the outputs no other module reads
+  fillOutput = fOutputArray && fOutputArray->TestBit(kArrayImported);
+  fillMomentum = fMomentumOutputArray->TestBit(kArrayImported);
+  fillEnergy = fEnergyOutputArray->TestBit(kArrayImported);
+
+  if(!fillOutput && !fillMomentum && !fillEnergy) return;
+
   momentum.SetPxPyPzE(0.0, 0.0, 0.0, 0.0);
   sumPT = 0;
   sumE = 0;
@@ -136,23 +154,29 @@ void Merger::Process()
       sumPT += candidateMomentum.Pt();
       sumE += candidateMomentum.E();
 
-      fOutputArray->Add(candidate);
+      if(fillOutput) fOutputArray->Add(candidate);
     }
   }
 
-  candidate = factory->NewCandidate();
+  if(fillMomentum)
+  {
+    candidate = factory->NewCandidate();
 
-  candidate->Position.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  candidate->Momentum = momentum;
+    candidate->Position.SetXYZT(0.0, 0.0, 0.0, 0.0);
+    candidate->Momentum = momentum;
 
-  fMomentumOutputArray->Add(candidate);
+    fMomentumOutputArray->Add(candidate);
+  }
 
-  candidate = factory->NewCandidate();
+  if(fillEnergy)
+  {
+    candidate = factory->NewCandidate();
 
-  candidate->Position.SetXYZT(0.0, 0.0, 0.0, 0.0);
-  candidate->Momentum.SetPtEtaPhiE(sumPT, 0.0, 0.0, sumE);
+    candidate->Position.SetXYZT(0.0, 0.0, 0.0, 0.0);
+    candidate->Momentum.SetPtEtaPhiE(sumPT, 0.0, 0.0, sumE);
 
-  fEnergyOutputArray->Add(candidate);
+    fEnergyOutputArray->Add(candidate);
+  }
 }
 
 //------------------------------------------------------------------------------
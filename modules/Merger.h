@@ -23,6 +23,7 @@
  *
  *  Merges multiple input arrays into one output array
  *  and sums transverse momenta of all input objects.
+ *  A single input array is exported as an alias, without copying.
  *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
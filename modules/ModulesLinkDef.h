@@ -33,6 +33,7 @@
 #include "modules/Efficiency.h"
 #include "modules/IdentificationMap.h"
 #include "modules/EnergySmearing.h"
+#include "modules/DetectorResponse.h"
 #include "modules/MomentumSmearing.h"
 #include "modules/TrackSmearing.h"
 #include "modules/TrackCovariance.h"
@@ -81,6 +82,8 @@
 #include "modules/LLPFilter.h"
 #include "modules/CscClusterEfficiency.h"
 #include "modules/CscClusterId.h"
+#include "modules/EventSkim.h"
+#include "modules/Checkpoint.h"
 
 #ifdef __CINT__
 
@@ -96,6 +99,7 @@
 #pragma link C++ class Efficiency+;
 #pragma link C++ class IdentificationMap+;
 #pragma link C++ class EnergySmearing+;
+#pragma link C++ class DetectorResponse+;
 #pragma link C++ class MomentumSmearing+;
 #pragma link C++ class TrackSmearing+;
 #pragma link C++ class TrackCovariance+;
@@ -144,5 +148,7 @@
 #pragma link C++ class LLPFilter+;
 #pragma link C++ class CscClusterEfficiency+;
 #pragma link C++ class CscClusterId+;
+#pragma link C++ class EventSkim+;
+#pragma link C++ class Checkpoint+;
 
 #endif
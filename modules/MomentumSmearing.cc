@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -118,7 +119,7 @@ void MomentumSmearing::Process()
     res = fFormula->Eval(pt, eta, phi, e, candidate);
 
     // apply smearing formula
-    //pt = gRandom->Gaus(pt, fFormula->Eval(pt, eta, phi, e) * pt);
+    //pt = GetRandom()->Gaus(pt, fFormula->Eval(pt, eta, phi, e) * pt);
 
     res = (res > 1.0) ? 1.0 : res;
 
@@ -149,7 +150,7 @@ Double_t MomentumSmearing::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma * sigma) / (mean * mean))));
     a = TMath::Log(mean) - 0.5 * b * b;
 
-    return TMath::Exp(a + b * gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b * GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
@@ -17,6 +17,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -436,12 +437,12 @@ void OldCalorimeter::FinalizeTower()
 
   if(!fTower) return;
 
-  //  ecalEnergy = gRandom->Gaus(fTowerECalEnergy, fECalResolutionFormula->Eval(0.0, fTowerEta, 0.0, fTowerECalEnergy));
+  //  ecalEnergy = GetRandom()->Gaus(fTowerECalEnergy, fECalResolutionFormula->Eval(0.0, fTowerEta, 0.0, fTowerECalEnergy));
   //  if(ecalEnergy < 0.0) ecalEnergy = 0.0;
 
   ecalEnergy = LogNormal(fTowerECalEnergy, fECalResolutionFormula->Eval(0.0, fTowerEta, 0.0, fTowerECalEnergy));
 
-  //  hcalEnergy = gRandom->Gaus(fTowerHCalEnergy, fHCalResolutionFormula->Eval(0.0, fTowerEta, 0.0, fTowerHCalEnergy));
+  //  hcalEnergy = GetRandom()->Gaus(fTowerHCalEnergy, fHCalResolutionFormula->Eval(0.0, fTowerEta, 0.0, fTowerHCalEnergy));
   //  if(hcalEnergy < 0.0) hcalEnergy = 0.0;
 
   hcalEnergy = LogNormal(fTowerHCalEnergy, fHCalResolutionFormula->Eval(0.0, fTowerEta, 0.0, fTowerHCalEnergy));
@@ -451,8 +452,8 @@ void OldCalorimeter::FinalizeTower()
   //  eta = fTowerEta;
   //  phi = fTowerPhi;
 
-  eta = gRandom->Uniform(fTowerEdges[0], fTowerEdges[1]);
-  phi = gRandom->Uniform(fTowerEdges[2], fTowerEdges[3]);
+  eta = GetRandom()->Uniform(fTowerEdges[0], fTowerEdges[1]);
+  phi = GetRandom()->Uniform(fTowerEdges[2], fTowerEdges[3]);
 
   pt = energy / TMath::CosH(eta);
 
@@ -588,7 +589,7 @@ Double_t OldCalorimeter::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma * sigma) / (mean * mean))));
     a = TMath::Log(mean) - 0.5 * b * b;
 
-    return TMath::Exp(a + b * gRandom->Gaus(0, 1));
+    return TMath::Exp(a + b * GetRandom()->Gaus(0, 1));
   }
   else
   {
@@ -46,6 +46,7 @@
 #include "TString.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -87,6 +88,8 @@ void ParticlePropagator::Init()
   fRadiusMax = GetDouble("RadiusMax", fRadius);
   fHalfLengthMax = GetDouble("HalfLengthMax", fHalfLength);
 
+  fBatchMode = GetBool("BatchMode", false);
+
   // import array with output from filter/classifier module
 
   fInputArray = ImportArray(GetString("InputArray", "Delphes/stableParticles"));
@@ -121,8 +124,8 @@ void ParticlePropagator::Finish()
 
 void ParticlePropagator::Process()
 {
-  Candidate *candidate, *mother, *particle;
-  TLorentzVector particlePosition, particleMomentum, beamSpotPosition;
+  Candidate *candidate, *particle;
+  TLorentzVector particlePosition, particleMomentum, beamSpotPosition, exitPosition;
   Double_t px, py, pz, pt, pt2, e, q;
   Double_t x, y, z, t, r;
   Double_t x_c, y_c, r_c, phi_0;
@@ -131,7 +134,7 @@ void ParticlePropagator::Process()
   Double_t tmp;
   Double_t gammam, omega;
   Double_t xd, yd, zd;
-  Double_t l, d0, dz, ctgTheta, alpha;
+  Double_t l, d0, dz, alpha;
   Double_t bsx, bsy, bsz;
   Double_t td, pio, phid, vz;
 
@@ -147,6 +150,12 @@ void ParticlePropagator::Process()
     beamSpotPosition = beamSpotCandidate.Position;
   }
 
+  if(fBatchMode)
+  {
+    ProcessBatch(beamSpotPosition);
+    return;
+  }
+
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
@@ -192,17 +201,7 @@ void ParticlePropagator::Process()
 
     if(TMath::Hypot(x, y) > fRadius || TMath::Abs(z) > fHalfLength)
     {
-      mother = candidate;
-      candidate = static_cast<Candidate *>(candidate->Clone());
-
-      candidate->InitialPosition = particlePosition;
-      candidate->Position = particlePosition;
-      candidate->L = 0.0;
-
-      candidate->Momentum = particleMomentum;
-      candidate->AddCandidate(mother);
-
-      fOutputArray->Add(candidate);
+      ExportParticle(candidate, particle, particlePosition, particleMomentum, 0.0, kFALSE);
     }
     else if(TMath::Abs(q) < 1.0E-9 || TMath::Abs(fBz) < 1.0E-9)
     {
@@ -220,36 +219,8 @@ void ParticlePropagator::Process()
 
       l = TMath::Sqrt((x_t - x) * (x_t - x) + (y_t - y) * (y_t - y) + (z_t - z) * (z_t - z));
 
-      mother = candidate;
-      candidate = static_cast<Candidate *>(candidate->Clone());
-
-      candidate->InitialPosition = particlePosition;
-      candidate->Position.SetXYZT(x_t * 1.0E3, y_t * 1.0E3, z_t * 1.0E3, particlePosition.T() + t * e * 1.0E3);
-      candidate->L = l * 1.0E3;
-
-      candidate->Momentum = particleMomentum;
-      candidate->AddCandidate(mother);
-
-      fOutputArray->Add(candidate);
-
-      if(TMath::Abs(q) > 1.0E-9)
-      {
-        switch(TMath::Abs(candidate->PID))
-        {
-        case 11:
-          fElectronOutputArray->Add(candidate);
-          break;
-        case 13:
-          fMuonOutputArray->Add(candidate);
-          break;
-        default:
-          fChargedHadronOutputArray->Add(candidate);
-        }
-      }
-      else
-      {
-        fNeutralOutputArray->Add(candidate);
-      }
+      exitPosition.SetXYZT(x_t * 1.0E3, y_t * 1.0E3, z_t * 1.0E3, particlePosition.T() + t * e * 1.0E3);
+      ExportParticle(candidate, particle, exitPosition, particleMomentum, l * 1.0E3, kTRUE);
     }
     else
     {
@@ -298,7 +269,6 @@ void ParticlePropagator::Process()
       // calculate additional track parameters (correct for beamspot position)
       d0 = ((xd - bsx) * py - (yd - bsy) * px) / pt;
       dz = zd - bsz;
-      ctgTheta = 1.0 / TMath::Tan(particleMomentum.Theta());
 
       // 3. time evaluation t = TMath::Min(t_r, t_z)
       //    t_r : time to exit from the sides
@@ -331,47 +301,350 @@ void ParticlePropagator::Process()
       if(r_t > 0.0)
       {
         // store these variables before cloning
-        if(particle == candidate)
-        {
-          particle->D0 = d0 * 1.0E3;
-          particle->DZ = dz * 1.0E3;
-          particle->P = particleMomentum.P();
-          particle->PT = pt;
-          particle->CtgTheta = ctgTheta;
-          particle->Phi = particleMomentum.Phi();
-        }
-
-        mother = candidate;
-        candidate = static_cast<Candidate *>(candidate->Clone());
-
-        candidate->InitialPosition = particlePosition;
-        candidate->Position.SetXYZT(x_t * 1.0E3, y_t * 1.0E3, z_t * 1.0E3, particlePosition.T() + t * c_light * 1.0E3);
+        if(particle == candidate) SetTrackParameters(particle, particleMomentum, pt, d0, dz);
 
-        candidate->Momentum = particleMomentum;
-
-        candidate->L = l * 1.0E3;
+        exitPosition.SetXYZT(x_t * 1.0E3, y_t * 1.0E3, z_t * 1.0E3, particlePosition.T() + t * c_light * 1.0E3);
+        candidate = ExportParticle(candidate, particle, exitPosition, particleMomentum, l * 1.0E3, kTRUE);
 
         candidate->Xd = xd * 1.0E3;
         candidate->Yd = yd * 1.0E3;
         candidate->Zd = zd * 1.0E3;
-
-        candidate->AddCandidate(mother);
-
-        fOutputArray->Add(candidate);
-        switch(TMath::Abs(candidate->PID))
-        {
-        case 11:
-          fElectronOutputArray->Add(candidate);
-          break;
-        case 13:
-          fMuonOutputArray->Add(candidate);
-          break;
-        default:
-          fChargedHadronOutputArray->Add(candidate);
-        }
       }
     }
   }
 }
 
 //------------------------------------------------------------------------------
+
+Candidate *ParticlePropagator::ExportParticle(Candidate *candidate, Candidate *particle,
+  const TLorentzVector &position, const TLorentzVector &momentum, Double_t l, Bool_t propagated)
+{
+  Candidate *mother = candidate;
+
+  candidate = static_cast<Candidate *>(candidate->Clone());
+
+  candidate->InitialPosition = particle->Position;
+  candidate->Position = position;
+  candidate->L = l;
+
+  candidate->Momentum = momentum;
+  candidate->AddCandidate(mother);
+
+  fOutputArray->Add(candidate);
+
+  // particles produced outside the cylinder are not sorted by type
+  if(!propagated) return candidate;
+
+  if(TMath::Abs(particle->Charge) > 1.0E-9)
+  {
+    switch(TMath::Abs(candidate->PID))
+    {
+    case 11:
+      fElectronOutputArray->Add(candidate);
+      break;
+    case 13:
+      fMuonOutputArray->Add(candidate);
+      break;
+    default:
+      fChargedHadronOutputArray->Add(candidate);
+    }
+  }
+  else
+  {
+    fNeutralOutputArray->Add(candidate);
+  }
+
+  return candidate;
+}
+
+//------------------------------------------------------------------------------
+
+void ParticlePropagator::SetTrackParameters(Candidate *particle, const TLorentzVector &momentum,
+  Double_t pt, Double_t d0, Double_t dz)
+{
+  particle->D0 = d0 * 1.0E3;
+  particle->DZ = dz * 1.0E3;
+  particle->P = momentum.P();
+  particle->PT = pt;
+  particle->CtgTheta = 1.0 / TMath::Tan(momentum.Theta());
+  particle->Phi = momentum.Phi();
+}
+
+//------------------------------------------------------------------------------
+
+void ParticlePropagator::TBufferStruct::Clear()
+{
+  x.clear();
+  y.clear();
+  z.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  pt.clear();
+  pt2.clear();
+  e.clear();
+  q.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void ParticlePropagator::TBufferStruct::Resize(size_t size)
+{
+  t.resize(size);
+  xt.resize(size);
+  yt.resize(size);
+  zt.resize(size);
+  rt.resize(size);
+  l.resize(size);
+  xd.resize(size);
+  yd.resize(size);
+  zd.resize(size);
+  phid.resize(size);
+  d0.resize(size);
+  dz.resize(size);
+}
+
+//------------------------------------------------------------------------------
+
+void ParticlePropagator::PropagateStraight()
+{
+  TBufferStruct &b = fStraightBuffer;
+  const Int_t size = b.x.size();
+  const Double_t *x = b.x.data(), *y = b.y.data(), *z = b.z.data();
+  const Double_t *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+  const Double_t *pt2 = b.pt2.data();
+  Double_t *t = b.t.data(), *xt = b.xt.data(), *yt = b.yt.data(), *zt = b.zt.data();
+  Double_t *l = b.l.data();
+  Double_t tmp, t_r, t_z;
+  Int_t i;
+
+  // same equations as in the scalar path, without branches in the loop body
+  for(i = 0; i < size; ++i)
+  {
+    // solve pt2*t^2 + 2*(px*x + py*y)*t - (fRadius2 - x*x - y*y) = 0
+    tmp = px[i] * y[i] - py[i] * x[i];
+    t_r = (std::sqrt(pt2[i] * fRadius2 - tmp * tmp) - px[i] * x[i] - py[i] * y[i]) / pt2[i];
+
+    t_z = ((pz[i] >= 0.0 ? fHalfLength : -fHalfLength) - z[i]) / pz[i];
+
+    t[i] = std::min(t_r, t_z);
+
+    xt[i] = x[i] + px[i] * t[i];
+    yt[i] = y[i] + py[i] * t[i];
+    zt[i] = z[i] + pz[i] * t[i];
+
+    l[i] = std::sqrt((xt[i] - x[i]) * (xt[i] - x[i]) + (yt[i] - y[i]) * (yt[i] - y[i]) + (zt[i] - z[i]) * (zt[i] - z[i]));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void ParticlePropagator::PropagateHelix(Double_t bsx, Double_t bsy, Double_t bsz)
+{
+  TBufferStruct &b = fHelixBuffer;
+  const Int_t size = b.x.size();
+  const Double_t *x = b.x.data(), *y = b.y.data(), *z = b.z.data();
+  const Double_t *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+  const Double_t *pt = b.pt.data(), *e = b.e.data(), *q = b.q.data();
+  Double_t *t = b.t.data(), *xt = b.xt.data(), *yt = b.yt.data(), *zt = b.zt.data();
+  Double_t *rt = b.rt.data(), *l = b.l.data();
+  Double_t *xd = b.xd.data(), *yd = b.yd.data(), *zd = b.zd.data();
+  Double_t *phid = b.phid.data(), *d0 = b.d0.data(), *dz = b.dz.data();
+  Double_t gammam, omega, r, phi_0, x_c, y_c, r_c, td, pio, vz;
+  Double_t sind, cosd, t_r, t_z, alpha, phi_t;
+  Int_t i;
+
+  const Double_t c_light = 2.99792458E8;
+
+  // same equations as in the scalar path, see ParticlePropagator::Process
+  for(i = 0; i < size; ++i)
+  {
+    gammam = e[i] * 1.0E9 / (c_light * c_light);
+    omega = q[i] * fBz / gammam;
+    r = pt[i] / (q[i] * fBz) * 1.0E9 / c_light;
+
+    phi_0 = std::atan2(py[i], px[i]);
+
+    // sin(phi_0) and cos(phi_0) from the momentum, without trigonometric calls
+    x_c = x[i] + r * py[i] / pt[i];
+    y_c = y[i] - r * px[i] / pt[i];
+    r_c = std::sqrt(x_c * x_c + y_c * y_c);
+
+    // time of closest approach, folded into [-pio/2, pio/2]
+    // like the while loop of the scalar path
+    td = (phi_0 + std::atan2(x_c, y_c)) / omega;
+    pio = std::abs(TMath::Pi() / omega);
+    td -= std::copysign(std::ceil(std::abs(td) / pio - 0.5), td) * pio;
+
+    vz = pz[i] * c_light / e[i];
+
+    phid[i] = phi_0 - omega * td;
+    sind = std::sin(phid[i]);
+    cosd = std::cos(phid[i]);
+    xd[i] = x_c - r * sind;
+    yd[i] = y_c + r * cosd;
+    zd[i] = z[i] + vz * td;
+
+    // momentum direction at closest approach is (cosd, sind)
+    d0[i] = (xd[i] - bsx) * sind - (yd[i] - bsy) * cosd;
+    dz[i] = zd[i] - bsz;
+
+    t_z = (vz == 0.0) ? 1.0E99 : ((pz[i] >= 0.0 ? fHalfLength : -fHalfLength) - z[i]) / vz;
+
+    // alpha is only used when the helix crosses the cylinder sides
+    alpha = std::acos((r * r + r_c * r_c - fRadius2) / (2 * std::abs(r) * r_c));
+    t_r = td + std::abs(alpha / omega);
+
+    t[i] = (r_c + std::abs(r) < fRadius) ? t_z : std::min(t_r, t_z);
+
+    phi_t = phi_0 - omega * t[i];
+    xt[i] = x_c - r * std::sin(phi_t);
+    yt[i] = y_c + r * std::cos(phi_t);
+    zt[i] = z[i] + vz * t[i];
+    rt[i] = std::sqrt(xt[i] * xt[i] + yt[i] * yt[i]);
+
+    l[i] = t[i] * std::sqrt(vz * vz + r * omega * r * omega);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void ParticlePropagator::ProcessBatch(const TLorentzVector &beamSpotPosition)
+{
+  Candidate *candidate, *particle;
+  TLorentzVector particlePosition, particleMomentum, exitPosition;
+  TBufferStruct *buffer;
+  TEntryStruct entry;
+  Double_t x, y, z, q, pt2;
+  Int_t i;
+  vector<TEntryStruct>::const_iterator itEntries;
+
+  const Double_t c_light = 2.99792458E8;
+
+  fEntries.clear();
+  fStraightBuffer.Clear();
+  fHelixBuffer.Clear();
+
+  // 1. gather positions and momenta
+
+  fItInputArray->Reset();
+  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  {
+    if(candidate->GetCandidates()->GetEntriesFast() == 0)
+    {
+      particle = candidate;
+    }
+    else
+    {
+      particle = static_cast<Candidate *>(candidate->GetCandidates()->At(0));
+    }
+
+    const TLorentzVector &position = particle->Position;
+    const TLorentzVector &momentum = particle->Momentum;
+
+    x = position.X() * 1.0E-3;
+    y = position.Y() * 1.0E-3;
+    z = position.Z() * 1.0E-3;
+
+    q = particle->Charge;
+
+    if(TMath::Hypot(x, y) > fRadiusMax || TMath::Abs(z) > fHalfLengthMax)
+    {
+      continue;
+    }
+
+    pt2 = momentum.Perp2();
+
+    if(pt2 < 1.0E-9)
+    {
+      continue;
+    }
+
+    entry.candidate = candidate;
+    entry.particle = particle;
+    entry.index = -1;
+
+    if(TMath::Hypot(x, y) > fRadius || TMath::Abs(z) > fHalfLength)
+    {
+      entry.type = 0;
+      fEntries.push_back(entry);
+      continue;
+    }
+
+    if(TMath::Abs(q) < 1.0E-9 || TMath::Abs(fBz) < 1.0E-9)
+    {
+      entry.type = 1;
+      buffer = &fStraightBuffer;
+    }
+    else
+    {
+      entry.type = 2;
+      buffer = &fHelixBuffer;
+    }
+
+    entry.index = buffer->x.size();
+    fEntries.push_back(entry);
+
+    buffer->x.push_back(x);
+    buffer->y.push_back(y);
+    buffer->z.push_back(z);
+    buffer->px.push_back(momentum.Px());
+    buffer->py.push_back(momentum.Py());
+    buffer->pz.push_back(momentum.Pz());
+    buffer->pt.push_back(momentum.Pt());
+    buffer->pt2.push_back(pt2);
+    buffer->e.push_back(momentum.E());
+    buffer->q.push_back(q);
+  }
+
+  // 2. compute exit points
+
+  fStraightBuffer.Resize(fStraightBuffer.x.size());
+  fHelixBuffer.Resize(fHelixBuffer.x.size());
+
+  PropagateStraight();
+  PropagateHelix(beamSpotPosition.X() * 1.0E-3, beamSpotPosition.Y() * 1.0E-3, beamSpotPosition.Z() * 1.0E-3);
+
+  // 3. scatter results back in the input order
+
+  for(itEntries = fEntries.begin(); itEntries != fEntries.end(); ++itEntries)
+  {
+    candidate = itEntries->candidate;
+    particle = itEntries->particle;
+    i = itEntries->index;
+
+    particlePosition = particle->Position;
+    particleMomentum = particle->Momentum;
+
+    if(itEntries->type == 0)
+    {
+      ExportParticle(candidate, particle, particlePosition, particleMomentum, 0.0, kFALSE);
+    }
+    else if(itEntries->type == 1)
+    {
+      const TBufferStruct &b = fStraightBuffer;
+
+      exitPosition.SetXYZT(b.xt[i] * 1.0E3, b.yt[i] * 1.0E3, b.zt[i] * 1.0E3, particlePosition.T() + b.t[i] * b.e[i] * 1.0E3);
+      ExportParticle(candidate, particle, exitPosition, particleMomentum, b.l[i] * 1.0E3, kTRUE);
+    }
+    else
+    {
+      const TBufferStruct &b = fHelixBuffer;
+
+      if(b.rt[i] <= 0.0) continue;
+
+      particleMomentum.SetPtEtaPhiE(b.pt[i], particleMomentum.Eta(), b.phid[i], particleMomentum.E());
+
+      if(particle == candidate) SetTrackParameters(particle, particleMomentum, b.pt[i], b.d0[i], b.dz[i]);
+
+      exitPosition.SetXYZT(b.xt[i] * 1.0E3, b.yt[i] * 1.0E3, b.zt[i] * 1.0E3, particlePosition.T() + b.t[i] * c_light * 1.0E3);
+      candidate = ExportParticle(candidate, particle, exitPosition, particleMomentum, b.l[i] * 1.0E3, kTRUE);
+
+      candidate->Xd = b.xd[i] * 1.0E3;
+      candidate->Yd = b.yd[i] * 1.0E3;
+      candidate->Zd = b.zd[i] * 1.0E3;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -26,13 +26,21 @@
  *  its half-length, centered at (0,0,0) and with its axis
  *  oriented along the z-axis.
  *
+ *  With BatchMode enabled, the particles of an event are first gathered
+ *  into structure-of-arrays buffers, the straight-line and helix exit
+ *  points are computed in branch-free loops over these buffers and the
+ *  results are scattered back in the original input order.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
 
 #include "classes/DelphesModule.h"
 
+#include <vector>
+
 class TClonesArray;
+class Candidate;
 class TIterator;
 class TLorentzVector;
 
@@ -47,9 +55,49 @@ public:
   void Finish();
 
 private:
+  void ProcessBatch(const TLorentzVector &beamSpotPosition);
+
+  // clones the candidate at its exit point and adds it to the output arrays
+  Candidate *ExportParticle(Candidate *candidate, Candidate *particle,
+    const TLorentzVector &position, const TLorentzVector &momentum, Double_t l, Bool_t propagated);
+
+  // closest approach parameters stored on the particle before cloning
+  void SetTrackParameters(Candidate *particle, const TLorentzVector &momentum,
+    Double_t pt, Double_t d0, Double_t dz);
+
+  void PropagateStraight();
+  void PropagateHelix(Double_t bsx, Double_t bsy, Double_t bsz);
+
   Double_t fRadius, fRadius2, fRadiusMax, fHalfLength, fHalfLengthMax;
   Double_t fBz;
 
+  Bool_t fBatchMode;
+
+#if !defined(__CINT__) && !defined(__CLING__)
+  struct TBufferStruct
+  {
+    void Clear();
+    void Resize(size_t size);
+
+    std::vector<Double_t> x, y, z, px, py, pz, pt, pt2, e, q;
+    std::vector<Double_t> t, xt, yt, zt, rt, l;
+    std::vector<Double_t> xd, yd, zd, phid, d0, dz;
+  };
+
+  struct TEntryStruct
+  {
+    Candidate *candidate;
+    Candidate *particle;
+    Int_t type;
+    Int_t index;
+  };
+
+  TBufferStruct fStraightBuffer; //!
+  TBufferStruct fHelixBuffer; //!
+
+  std::vector<TEntryStruct> fEntries; //!
+#endif
+
   TIterator *fItInputArray; //!
 
   const TObjArray *fInputArray; //!
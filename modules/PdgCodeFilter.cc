@@ -119,6 +119,9 @@ void PdgCodeFilter::Process()
   Bool_t pass;
   Double_t pt;
 
+  // skip the output if no other module reads it
+  if(!fOutputArray->TestBit(kArrayImported)) return;
+
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
@@ -30,11 +30,13 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesCylindricalFormula.h"
 #include "classes/DelphesFactory.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
 #include "ExRootAnalysis/ExRootResult.h"
 
+#include "RVersion.h"
 #include "TDatabasePDG.h"
 #include "TF1.h"
 #include "TFormula.h"
@@ -83,6 +85,20 @@ void PhotonConversions::Init()
 
   fConversionMap->Compile(GetString("ConversionMap", "0.0"));
 
+  fUseConversionTable = GetBool("UseConversionTable", false);
+  fTableEtaBins = GetInt("TableEtaBins", 100);
+  fTablePhiBins = GetInt("TablePhiBins", 1);
+  fTableRadiusBins = GetInt("TableRadiusBins", 20);
+
+  if(fUseConversionTable)
+  {
+    if(fTableEtaBins < 1 || fTablePhiBins < 1 || fTableRadiusBins < 1)
+    {
+      throw runtime_error("conversion table must have at least one bin in eta, phi and radius");
+    }
+    BuildConversionTable();
+  }
+
   // import array with output from filter/classifier module
 
   fInputArray = ImportArray(GetString("InputArray", "Delphes/stableParticles"));
@@ -106,18 +122,19 @@ void PhotonConversions::Finish()
 
 void PhotonConversions::Process()
 {
-  Candidate *candidate, *ep, *em;
+  Candidate *candidate;
   TLorentzVector candidatePosition, candidateMomentum;
   TVector3 pos_i;
-  Double_t px, py, pz, pt, pt2, e, eta, phi;
+  Double_t px, py, pz, pt2, e, eta, phi;
   Double_t x, y, z, t;
   Double_t x_t, y_t, z_t, r_t;
   Double_t x_i, y_i, z_i, r_i, phi_i;
   Double_t dt, t1, t2, t3, t4;
   Double_t tmp, discr, discr2;
-  Int_t nsteps, i;
-  Double_t rate, p_conv, x1, x2;
+  Int_t nsteps, i, cell;
+  Double_t rate, p_conv, u, fraction;
   Bool_t converted;
+  const Double_t *cdf;
 
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
@@ -141,7 +158,6 @@ void PhotonConversions::Process()
       px = candidateMomentum.Px();
       py = candidateMomentum.Py();
       pz = candidateMomentum.Pz();
-      pt = candidateMomentum.Pt();
       pt2 = candidateMomentum.Perp2();
       eta = candidateMomentum.Eta();
       phi = candidateMomentum.Phi();
@@ -191,58 +207,213 @@ void PhotonConversions::Process()
 
       converted = false;
 
-      for(i = 0; i < nsteps; ++i)
+      if(fUseConversionTable)
       {
-        x_i += px * dt;
-        y_i += py * dt;
-        z_i += pz * dt;
-        pos_i.SetXYZ(x_i, y_i, z_i);
+        // draw the conversion step from the tabulated cumulative probability
+        cell = FindTableCell(eta, phi, TMath::Hypot(x, y));
+        if(cell >= 0 && fTableSteps[cell] > 0)
+        {
+          cdf = &fTableCDF[fTableOffset[cell]];
+          u = GetRandom()->Uniform();
+          if(u < cdf[fTableSteps[cell] - 1])
+          {
+            converted = true;
 
-        // convert photon position into cylindrical coordinates, cylindrical r,phi,z !!
+            i = upper_bound(cdf, cdf + fTableSteps[cell], u) - cdf;
+            fraction = Double_t(i + 1) / fTableSteps[cell];
 
-        r_i = TMath::Sqrt(x_i * x_i + y_i * y_i);
-        phi_i = pos_i.Phi();
+            x_i = x + px * t * fraction;
+            y_i = y + py * t * fraction;
+            z_i = z + pz * t * fraction;
 
-        // read conversion rate/meter from card
-        rate = fConversionMap->Eval(r_i, phi_i, z_i);
+            ConvertPhoton(candidate, x_i, y_i, z_i, candidatePosition.T() + t * e * 1.0E3);
+          }
+        }
+      }
+      else
+      {
+        for(i = 0; i < nsteps; ++i)
+        {
+          x_i += px * dt;
+          y_i += py * dt;
+          z_i += pz * dt;
+          pos_i.SetXYZ(x_i, y_i, z_i);
 
-        // convert into conversion probability
-        p_conv = 1 - TMath::Exp(-7.0 / 9.0 * fStep * rate);
+          // convert photon position into cylindrical coordinates, cylindrical r,phi,z !!
 
-        // case conversion occurs
-        if(gRandom->Uniform() < p_conv)
-        {
-          converted = true;
+          r_i = TMath::Sqrt(x_i * x_i + y_i * y_i);
+          phi_i = pos_i.Phi();
+
+          // read conversion rate/meter from card
+          rate = fConversionMap->Eval(r_i, phi_i, z_i);
+
+          // convert into conversion probability
+          p_conv = 1 - TMath::Exp(-7.0 / 9.0 * fStep * rate);
+
+          // case conversion occurs
+          if(GetRandom()->Uniform() < p_conv)
+          {
+            converted = true;
+
+            ConvertPhoton(candidate, x_i, y_i, z_i, candidatePosition.T() + nsteps * dt * e * 1.0E3);
+
+            break;
+          }
+        }
+      }
+      if(!converted) fOutputArray->Add(candidate);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PhotonConversions::ConvertPhoton(Candidate *candidate, Double_t x, Double_t y, Double_t z, Double_t t)
+{
+  Candidate *ep, *em;
+  Double_t pt, eta, phi, e, x1, x2;
+
+  const TLorentzVector &candidateMomentum = candidate->Momentum;
+
+  pt = candidateMomentum.Pt();
+  eta = candidateMomentum.Eta();
+  phi = candidateMomentum.Phi();
+  e = candidateMomentum.E();
+
+  // generate x1 and x2, the fraction of the photon energy taken resp. by e+ and e-
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 24, 0)
+  x1 = fDecayXsec->GetRandom(GetRandom());
+#else
+  x1 = fDecayXsec->GetRandom();
+#endif
+  x2 = 1 - x1;
+
+  ep = static_cast<Candidate *>(candidate->Clone());
+  em = static_cast<Candidate *>(candidate->Clone());
+
+  ep->Position.SetXYZT(x * 1.0E3, y * 1.0E3, z * 1.0E3, t);
+  em->Position.SetXYZT(x * 1.0E3, y * 1.0E3, z * 1.0E3, t);
+
+  ep->Momentum.SetPtEtaPhiE(x1 * pt, eta, phi, x1 * e);
+  em->Momentum.SetPtEtaPhiE(x2 * pt, eta, phi, x2 * e);
 
-          // generate x1 and x2, the fraction of the photon energy taken resp. by e+ and e-
-          x1 = fDecayXsec->GetRandom();
-          x2 = 1 - x1;
+  ep->PID = -11;
+  em->PID = 11;
 
-          ep = static_cast<Candidate *>(candidate->Clone());
-          em = static_cast<Candidate *>(candidate->Clone());
+  ep->Charge = 1.0;
+  em->Charge = -1.0;
 
-          ep->Position.SetXYZT(x_i * 1.0E3, y_i * 1.0E3, z_i * 1.0E3, candidatePosition.T() + nsteps * dt * e * 1.0E3);
-          em->Position.SetXYZT(x_i * 1.0E3, y_i * 1.0E3, z_i * 1.0E3, candidatePosition.T() + nsteps * dt * e * 1.0E3);
+  ep->IsFromConversion = 1;
+  em->IsFromConversion = 1;
 
-          ep->Momentum.SetPtEtaPhiE(x1 * pt, eta, phi, x1 * e);
-          em->Momentum.SetPtEtaPhiE(x2 * pt, eta, phi, x2 * e);
+  fOutputArray->Add(em);
+  fOutputArray->Add(ep);
+}
+
+//------------------------------------------------------------------------------
+
+Int_t PhotonConversions::FindTableCell(Double_t eta, Double_t phi, Double_t r) const
+{
+  Int_t iEta, iPhi, iRadius;
 
-          ep->PID = -11;
-          em->PID = 11;
+  iEta = Int_t((eta - fEtaMin) / (fEtaMax - fEtaMin) * fTableEtaBins);
+  iPhi = Int_t((phi + TMath::Pi()) / (2.0 * TMath::Pi()) * fTablePhiBins);
+  iRadius = Int_t(r / fRadius * fTableRadiusBins);
 
-          ep->Charge = 1.0;
-          em->Charge = -1.0;
+  if(iEta < 0 || iPhi < 0 || iRadius < 0) return -1;
 
-          ep->IsFromConversion = 1;
-          em->IsFromConversion = 1;
+  // upper edges belong to the last bin
+  if(iEta >= fTableEtaBins) iEta = fTableEtaBins - 1;
+  if(iPhi >= fTablePhiBins) iPhi = fTablePhiBins - 1;
+  if(iRadius >= fTableRadiusBins) iRadius = fTableRadiusBins - 1;
+
+  return (iEta * fTablePhiBins + iPhi) * fTableRadiusBins + iRadius;
+}
+
+//------------------------------------------------------------------------------
+
+void PhotonConversions::BuildConversionTable()
+{
+  Int_t iEta, iPhi, iRadius, nsteps, step, i;
+  Double_t eta, phi, r0;
+  Double_t px, py, pz, pt2;
+  Double_t x, y, z, t, t1, t2, t3, t4;
+  Double_t x_t, y_t, z_t, r_t;
+  Double_t x_i, y_i, z_i, r_i, dt;
+  Double_t tmp, discr2, survival;
+
+  fTableOffset.assign(fTableEtaBins * fTablePhiBins * fTableRadiusBins, 0);
+  fTableSteps.assign(fTableEtaBins * fTablePhiBins * fTableRadiusBins, 0);
+  fTableCDF.clear();
+
+  for(iEta = 0; iEta < fTableEtaBins; ++iEta)
+  {
+    eta = fEtaMin + (iEta + 0.5) * (fEtaMax - fEtaMin) / fTableEtaBins;
+    for(iPhi = 0; iPhi < fTablePhiBins; ++iPhi)
+    {
+      phi = -TMath::Pi() + (iPhi + 0.5) * 2.0 * TMath::Pi() / fTablePhiBins;
+      for(iRadius = 0; iRadius < fTableRadiusBins; ++iRadius)
+      {
+        r0 = (iRadius + 0.5) * fRadius / fTableRadiusBins;
 
-          fOutputArray->Add(em);
-          fOutputArray->Add(ep);
+        // straight path pointing away from the origin,
+        // starting at radius r0 on the line of flight
+        px = TMath::Cos(phi);
+        py = TMath::Sin(phi);
+        pz = TMath::SinH(eta);
+        pt2 = 1.0;
 
-          break;
+        x = r0 * px;
+        y = r0 * py;
+        z = r0 * pz;
+
+        i = (iEta * fTablePhiBins + iPhi) * fTableRadiusBins + iRadius;
+        fTableOffset[i] = fTableCDF.size();
+
+        if(TMath::Abs(z) > fHalfLength) continue;
+
+        // same exit point and step definition as in Process
+        tmp = px * y - py * x;
+        discr2 = pt2 * fRadius2 - tmp * tmp;
+        if(discr2 < 0.0) continue;
+
+        tmp = px * x + py * y;
+        t1 = (-tmp + TMath::Sqrt(discr2)) / pt2;
+        t2 = (-tmp - TMath::Sqrt(discr2)) / pt2;
+        t = (t1 < 0.0) ? t2 : t1;
+
+        z_t = z + pz * t;
+        if(TMath::Abs(z_t) > fHalfLength)
+        {
+          t3 = (+fHalfLength - z) / pz;
+          t4 = (-fHalfLength - z) / pz;
+          t = (t3 < 0.0) ? t4 : t3;
+        }
+
+        x_t = x + px * t;
+        y_t = y + py * t;
+        z_t = z + pz * t;
+
+        r_t = TMath::Sqrt(x_t * x_t + y_t * y_t + z_t * z_t);
+
+        nsteps = Int_t(r_t / fStep);
+        fTableSteps[i] = nsteps;
+
+        dt = t / nsteps;
+        survival = 1.0;
+
+        for(step = 0; step < nsteps; ++step)
+        {
+          x_i = x + px * dt * (step + 1);
+          y_i = y + py * dt * (step + 1);
+          z_i = z + pz * dt * (step + 1);
+
+          r_i = TMath::Sqrt(x_i * x_i + y_i * y_i);
+
+          survival *= TMath::Exp(-7.0 / 9.0 * fStep * fConversionMap->Eval(r_i, TMath::ATan2(y_i, x_i), z_i));
+          fTableCDF.push_back(1.0 - survival);
         }
       }
-      if(!converted) fOutputArray->Add(candidate);
     }
   }
 }
@@ -23,16 +23,24 @@
  *
  *  Converts photons into e+ e- pairs according to material ditribution in the detector.
  *
+ *  With UseConversionTable enabled, the cumulative conversion probability
+ *  along straight paths is tabulated at initialization in bins of eta,
+ *  phi and start radius, and the conversion step of each photon is drawn
+ *  from the inverse of this distribution instead of being sampled step by step.
+ *
  *  \author M. Selvaggi - UCL, Louvain-la-Neuve
  *
  */
 
 #include "classes/DelphesModule.h"
 
+#include <vector>
+
 class TClonesArray;
 class TIterator;
 class DelphesCylindricalFormula;
 class TF1;
+class Candidate;
 
 class PhotonConversions: public DelphesModule
 {
@@ -45,6 +53,11 @@ public:
   void Finish();
 
 private:
+  void BuildConversionTable();
+  void ConvertPhoton(Candidate *candidate, Double_t x, Double_t y, Double_t z, Double_t t);
+
+  Int_t FindTableCell(Double_t eta, Double_t phi, Double_t r) const;
+
   Double_t fRadius, fRadius2, fHalfLength;
   Double_t fEtaMin, fEtaMax;
 
@@ -60,6 +73,13 @@ private:
 
   Double_t fStep;
 
+  Bool_t fUseConversionTable;
+  Int_t fTableEtaBins, fTablePhiBins, fTableRadiusBins;
+
+  std::vector<Int_t> fTableOffset; //!
+  std::vector<Int_t> fTableSteps; //!
+  std::vector<Double_t> fTableCDF; //!
+
   ClassDef(PhotonConversions, 1)
 };
 
@@ -31,6 +31,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -141,7 +142,7 @@ void PhotonID::Process()
     {
       //cout<<"                    Fake!"<<endl;
 
-      if(gRandom->Uniform() > fFakeFormula->Eval(pt, eta, phi, e)) continue;
+      if(GetRandom()->Uniform() > fFakeFormula->Eval(pt, eta, phi, e)) continue;
       //cout<<"                    passed"<<endl;
       candidate->Status = 3;
       fOutputArray->Add(candidate);
@@ -158,7 +159,7 @@ void PhotonID::Process()
       if(isolated)
       {
         //cout<<"                       isolated!:   "<<relIso<<endl;
-        if(gRandom->Uniform() > fPromptFormula->Eval(pt, eta, phi, e)) continue;
+        if(GetRandom()->Uniform() > fPromptFormula->Eval(pt, eta, phi, e)) continue;
         //cout<<"                       passed"<<endl;
         candidate->Status = 1;
         fOutputArray->Add(candidate);
@@ -168,7 +169,7 @@ void PhotonID::Process()
       else
       {
         //cout<<"                       non-isolated!:   "<<relIso<<endl;
-        if(gRandom->Uniform() > fNonPromptFormula->Eval(pt, eta, phi, e)) continue;
+        if(GetRandom()->Uniform() > fNonPromptFormula->Eval(pt, eta, phi, e)) continue;
         //cout<<"                       passed"<<endl;
         candidate->Status = 2;
         fOutputArray->Add(candidate);
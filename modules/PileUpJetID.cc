@@ -12,6 +12,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -66,7 +67,7 @@ void PileUpJetID::Init()
 
   // import input array(s)
 
-  fJetInputArray = ImportArray(GetString("JetInputArray", "FastJetFinder/jets"));
+  fJetInputArray = UpdateArray(GetString("JetInputArray", "FastJetFinder/jets"));
   fItJetInputArray = fJetInputArray->MakeIterator();
 
   fTrackInputArray = ImportArray(GetString("TrackInputArray", "ParticlePropagator/tracks"));
@@ -170,22 +171,23 @@ void PileUpJetID::Process()
         }
         float tow_sumT = 0;
         float tow_sumW = 0;
-        for(int i = 0; i < constituent->ECalEnergyTimePairs.size(); i++)
+        const vector<pair<Float_t, Float_t> > &timePairs = constituent->GetECalEnergyTimePairs();
+        for(int i = 0; i < timePairs.size(); i++)
         {
-          float w = TMath::Sqrt(constituent->ECalEnergyTimePairs[i].first);
+          float w = TMath::Sqrt(timePairs[i].first);
           if(fAverageEachTower)
           {
-            tow_sumT += w * constituent->ECalEnergyTimePairs[i].second;
+            tow_sumT += w * timePairs[i].second;
             tow_sumW += w;
           }
           else
           {
-            sumT0 += w * constituent->ECalEnergyTimePairs[i].second;
-            sumT1 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.001);
-            sumT10 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.010);
-            sumT20 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.020);
-            sumT30 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.030);
-            sumT40 += w * gRandom->Gaus(constituent->ECalEnergyTimePairs[i].second, 0.040);
+            sumT0 += w * timePairs[i].second;
+            sumT1 += w * GetRandom()->Gaus(timePairs[i].second, 0.001);
+            sumT10 += w * GetRandom()->Gaus(timePairs[i].second, 0.010);
+            sumT20 += w * GetRandom()->Gaus(timePairs[i].second, 0.020);
+            sumT30 += w * GetRandom()->Gaus(timePairs[i].second, 0.030);
+            sumT40 += w * GetRandom()->Gaus(timePairs[i].second, 0.040);
             sumWeightsForT += w;
             candidate->NTimeHits++;
           }
@@ -193,11 +195,11 @@ void PileUpJetID::Process()
         if(fAverageEachTower && tow_sumW > 0.)
         {
           sumT0 += tow_sumT;
-          sumT1 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.001);
-          sumT10 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0010);
-          sumT20 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0020);
-          sumT30 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0030);
-          sumT40 += tow_sumW * gRandom->Gaus(tow_sumT / tow_sumW, 0.0040);
+          sumT1 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.001);
+          sumT10 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0010);
+          sumT20 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0020);
+          sumT30 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0030);
+          sumT40 += tow_sumW * GetRandom()->Gaus(tow_sumT / tow_sumW, 0.0040);
           sumWeightsForT += tow_sumW;
           candidate->NTimeHits++;
         }
@@ -29,6 +29,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesPileUpReader.h"
+#include "classes/DelphesRandom.h"
 #include "classes/DelphesTF2.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
@@ -128,7 +129,7 @@ void PileUpMerger::Process()
 
   // --- Deal with primary vertex first  ------
 
-  fFunction->GetRandom2(dz, dt);
+  fFunction->GetRandom2(dz, dt, GetRandom());
 
   dz0 = -1.0e6;
   dt0 = -1.0e6;
@@ -197,16 +198,16 @@ void PileUpMerger::Process()
   switch(fPileUpDistribution)
   {
   case 0:
-    numberOfEvents = gRandom->Poisson(fMeanPileUp);
+    numberOfEvents = GetRandom()->Poisson(fMeanPileUp);
     break;
   case 1:
-    numberOfEvents = gRandom->Integer(2 * fMeanPileUp + 1);
+    numberOfEvents = GetRandom()->Integer(2 * fMeanPileUp + 1);
     break;
   case 2:
     numberOfEvents = fMeanPileUp;
     break;
   default:
-    numberOfEvents = gRandom->Poisson(fMeanPileUp);
+    numberOfEvents = GetRandom()->Poisson(fMeanPileUp);
     break;
   }
 
@@ -216,19 +217,19 @@ void PileUpMerger::Process()
   {
     do
     {
-      entry = TMath::Nint(gRandom->Rndm() * allEntries);
+      entry = TMath::Nint(GetRandom()->Rndm() * allEntries);
     } while(entry >= allEntries);
 
     fReader->ReadEntry(entry);
 
     // --- Pile-up vertex smearing
 
-    fFunction->GetRandom2(dz, dt);
+    fFunction->GetRandom2(dz, dt, GetRandom());
 
     dt *= c_light * 1.0E3; // necessary in order to make t in mm/c
     dz *= 1.0E3; // necessary in order to make z in mm
 
-    dphi = gRandom->Uniform(-TMath::Pi(), TMath::Pi());
+    dphi = GetRandom()->Uniform(-TMath::Pi(), TMath::Pi());
 
     vx = 0.0;
     vy = 0.0;
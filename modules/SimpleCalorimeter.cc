@@ -30,6 +30,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -438,8 +439,8 @@ void SimpleCalorimeter::FinalizeTower()
 
   if(fSmearTowerCenter)
   {
-    eta = gRandom->Uniform(fTowerEdges[0], fTowerEdges[1]);
-    phi = gRandom->Uniform(fTowerEdges[2], fTowerEdges[3]);
+    eta = GetRandom()->Uniform(fTowerEdges[0], fTowerEdges[1]);
+    phi = GetRandom()->Uniform(fTowerEdges[2], fTowerEdges[3]);
   }
   else
   {
@@ -541,7 +542,7 @@ Double_t SimpleCalorimeter::LogNormal(Double_t mean, Double_t sigma)
     b = TMath::Sqrt(TMath::Log((1.0 + (sigma * sigma) / (mean * mean))));
     a = TMath::Log(mean) - 0.5 * b * b;
 
-    return TMath::Exp(a + b * gRandom->Gaus(0.0, 1.0));
+    return TMath::Exp(a + b * GetRandom()->Gaus(0.0, 1.0));
   }
   else
   {
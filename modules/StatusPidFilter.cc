@@ -190,6 +190,9 @@ void StatusPidFilter::Process()
   Int_t status, pdgCode;
   Bool_t pass;
 
+  // skip the output if no other module reads it
+  if(!fOutputArray->TestBit(kArrayImported)) return;
+
   fItInputArray->Reset();
   while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
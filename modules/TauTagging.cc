@@ -31,6 +31,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "TDatabasePDG.h"
 #include "TFormula.h"
@@ -208,7 +209,7 @@ void TauTagging::Process()
 
     const TLorentzVector &jetMomentum = jet->Momentum;
     pdgCode = 0;
-    charge = gRandom->Uniform() > 0.5 ? 1 : -1;
+    charge = GetRandom()->Uniform() > 0.5 ? 1 : -1;
     eta = jetMomentum.Eta();
     phi = jetMomentum.Phi();
     pt = jetMomentum.Pt();
@@ -280,7 +281,7 @@ void TauTagging::Process()
 
     // apply an efficency formula
     eff = formula->Eval(pt, eta, phi, e);
-    jet->TauTag |= (gRandom->Uniform() <= eff) << fBitNumber;
+    jet->TauTag |= (GetRandom()->Uniform() <= eff) << fBitNumber;
     jet->TauWeight = eff;
 
     // set tau charge
@@ -18,6 +18,7 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -287,7 +288,7 @@ void TrackCountingTauTagging::Process()
     // apply an efficency formula
 
     // apply an efficency formula
-    jet->TauTag |= (gRandom->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
+    jet->TauTag |= (GetRandom()->Uniform() <= formula->Eval(pt, eta, phi, e)) << fBitNumber;
 
     // set tau charge
     jet->Charge = charge;
@@ -34,6 +34,7 @@
 #include "modules/TrackCovariance.h"
 
 #include "classes/DelphesClasses.h"
+#include "classes/DelphesRandom.h"
 
 #include "TrackCovariance/SolGeom.h"
 #include "TrackCovariance/SolGridCov.h"
@@ -129,7 +130,7 @@ void TrackCovariance::Process()
 
     mass = candidateMomentum.M();
 
-    ObsTrk track(candidatePosition.Vect(), candidateMomentum.Vect(), candidate->Charge, fCovariance, fGeometry);
+    ObsTrk track(candidatePosition.Vect(), candidateMomentum.Vect(), candidate->Charge, fCovariance, fGeometry, GetRandom());
 
 
     mother    = candidate;
@@ -141,7 +142,7 @@ void TrackCovariance::Process()
     candidate->InitialPosition.SetXYZT(track.GetObsX().X()*1e03,track.GetObsX().Y()*1e03,track.GetObsX().Z()*1e03,candidatePosition.T()*1e03);
 
     // save full covariance 5x5 matrix internally (D0, phi, Curvature, dz, ctg(theta))
-    candidate->TrackCovariance = track.GetCov();
+    candidate->SetTrackCovariance(track.GetCov());
 
     pt = candidate->Momentum.Pt();
     p  = candidate->Momentum.P();
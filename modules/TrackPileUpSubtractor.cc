@@ -88,7 +88,7 @@ void TrackPileUpSubtractor::Init()
   size = param.GetSize();
   for(i = 0; i < size / 2; ++i)
   {
-    array = ImportArray(param[i * 2].GetString());
+    array = UpdateArray(param[i * 2].GetString());
     iterator = array->MakeIterator();
 
     fInputMap[iterator] = ExportArray(param[i * 2 + 1].GetString());
@@ -11,6 +11,8 @@
 #include "classes/DelphesClasses.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesFormula.h"
+#include "classes/DelphesLookupTable.h"
+#include "classes/DelphesRandom.h"
 
 #include "ExRootAnalysis/ExRootClassifier.h"
 #include "ExRootAnalysis/ExRootFilter.h"
@@ -36,7 +38,9 @@ using namespace std;
 //------------------------------------------------------------------------------
 
 TrackSmearing::TrackSmearing() :
-  fD0Formula(0), fDZFormula(0), fPFormula(0), fCtgThetaFormula(0), fPhiFormula(0), fItInputArray(0)
+  fD0Formula(0), fD0Table(0), fDZFormula(0), fDZTable(0), fPFormula(0), fPTable(0),
+  fCtgThetaFormula(0), fCtgThetaTable(0), fPhiFormula(0), fPhiTable(0),
+  fReferenceTable(0), fItInputArray(0)
 {
   fD0Formula = new DelphesFormula;
   fDZFormula = new DelphesFormula;
@@ -122,6 +126,29 @@ void TrackSmearing::Init()
   }
 
   fApplyToPileUp = GetBool("ApplyToPileUp", true);
+  fInterpolateResolution = GetBool("InterpolateResolution", false);
+
+  // convert resolution histograms into flat lookup tables
+
+  if(!fUseD0Formula) fD0Table = LoadTable(fD0ResolutionFile, fD0ResolutionHist);
+  if(!fUseDZFormula) fDZTable = LoadTable(fDZResolutionFile, fDZResolutionHist);
+  if(!fUsePFormula) fPTable = LoadTable(fPResolutionFile, fPResolutionHist);
+  if(!fUseCtgThetaFormula) fCtgThetaTable = LoadTable(fCtgThetaResolutionFile, fCtgThetaResolutionHist);
+  if(!fUsePhiFormula) fPhiTable = LoadTable(fPhiResolutionFile, fPhiResolutionHist);
+
+  DelphesLookupTable *tables[5] = {fD0Table, fDZTable, fPTable, fCtgThetaTable, fPhiTable};
+
+  fReferenceTable = 0;
+  fSameBinning = !fInterpolateResolution;
+  for(Int_t i = 0; i < 5; ++i)
+  {
+    if(!tables[i]) continue;
+    tables[i]->SetInterpolate(fInterpolateResolution);
+    if(!fReferenceTable)
+      fReferenceTable = tables[i];
+    else if(!tables[i]->HasSameBinning(*fReferenceTable))
+      fSameBinning = false;
+  }
 
   // import input array
 
@@ -148,26 +175,85 @@ void TrackSmearing::Init()
 void TrackSmearing::Finish()
 {
   if(fItInputArray) delete fItInputArray;
+  if(fD0Table) delete fD0Table;
+  if(fDZTable) delete fDZTable;
+  if(fPTable) delete fPTable;
+  if(fCtgThetaTable) delete fCtgThetaTable;
+  if(fPhiTable) delete fPhiTable;
+}
+
+//------------------------------------------------------------------------------
+
+DelphesLookupTable *TrackSmearing::LoadTable(const string &fileName, const string &histName)
+{
+  stringstream message;
+  DelphesLookupTable *table;
+  TProfile2D *hist;
+
+  TFile *file = TFile::Open(fileName.c_str());
+  if(!file || file->IsZombie())
+  {
+    message << "can't open resolution file '" << fileName;
+    message << "' in module '" << GetName() << "'";
+    throw runtime_error(message.str());
+  }
+
+  hist = static_cast<TProfile2D *>(file->Get(histName.c_str()));
+  if(!hist)
+  {
+    message << "can't find resolution histogram '" << histName;
+    message << "' in file '" << fileName << "'";
+    throw runtime_error(message.str());
+  }
+
+  table = new DelphesLookupTable(hist);
+
+  file->Close();
+  delete file;
+
+  return table;
+}
+
+//------------------------------------------------------------------------------
+
+void TrackSmearing::ComputeErrors(Bool_t useFormula, DelphesFormula *formula, const DelphesLookupTable *table, vector<Double_t> &errors)
+{
+  Candidate *candidate;
+  Int_t i, size = fCandidates.size();
+
+  errors.resize(size);
+
+  if(useFormula)
+  {
+    for(i = 0; i < size; ++i)
+    {
+      candidate = fCandidates[i];
+      errors[i] = formula->Eval(fPT[i], candidate->Momentum.Eta(), candidate->Phi, candidate->Momentum.E(), candidate);
+    }
+  }
+  else if(fSameBinning)
+  {
+    for(i = 0; i < size; ++i) errors[i] = table->GetBinContent(fBins[i]);
+  }
+  else
+  {
+    table->Eval(size, fPT.data(), fAbsEta.data(), errors.data());
+  }
 }
 
 //------------------------------------------------------------------------------
 
 void TrackSmearing::Process()
 {
-  Int_t iCandidate = 0;
+  Int_t iCandidate = 0, i, size;
   TLorentzVector beamSpotPosition;
   Candidate *candidate, *mother;
-  Double_t pt, eta, e, m, d0, d0Error, trueD0, dz, dzError, trueDZ, p, pError, trueP, ctgTheta, ctgThetaError, trueCtgTheta, phi, phiError, truePhi;
+  Double_t pt, m, d0, d0Error, trueD0, dz, dzError, trueDZ, p, pError, trueP, ctgTheta, ctgThetaError, trueCtgTheta, phi, phiError, truePhi;
   Double_t x, y, z, t, px, py, pz, theta;
   Double_t q, r;
   Double_t x_c, y_c, r_c, phi_0;
   Double_t rcu, rc2, xd, yd, zd;
   const Double_t c_light = 2.99792458E8;
-  TProfile2D *d0ErrorHist = NULL,
-             *dzErrorHist = NULL,
-             *pErrorHist = NULL,
-             *ctgThetaErrorHist = NULL,
-             *phiErrorHist = NULL;
 
   if(!fBeamSpotInputArray || fBeamSpotInputArray->GetSize() == 0)
     beamSpotPosition.SetXYZT(0.0, 0.0, 0.0, 0.0);
@@ -177,52 +263,41 @@ void TrackSmearing::Process()
     beamSpotPosition = beamSpotCandidate.Position;
   }
 
-  if(!fUseD0Formula)
-  {
-    TFile *fin = TFile::Open(fD0ResolutionFile.c_str());
-    d0ErrorHist = (TProfile2D *)fin->Get(fD0ResolutionHist.c_str());
-    d0ErrorHist->SetDirectory(0);
-    fin->Close();
-  }
-  if(!fUseDZFormula)
-  {
-    TFile *fin = TFile::Open(fDZResolutionFile.c_str());
-    dzErrorHist = (TProfile2D *)fin->Get(fDZResolutionHist.c_str());
-    dzErrorHist->SetDirectory(0);
-    fin->Close();
-  }
-  if(!fUsePFormula)
-  {
-    TFile *fin = TFile::Open(fPResolutionFile.c_str());
-    pErrorHist = (TProfile2D *)fin->Get(fPResolutionHist.c_str());
-    pErrorHist->SetDirectory(0);
-    fin->Close();
-  }
-  if(!fUseCtgThetaFormula)
+  // gather all tracks and compute the five resolutions in one pass
+
+  fCandidates.clear();
+  fPT.clear();
+  fAbsEta.clear();
+
+  fItInputArray->Reset();
+  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
   {
-    TFile *fin = TFile::Open(fCtgThetaResolutionFile.c_str());
-    ctgThetaErrorHist = (TProfile2D *)fin->Get(fCtgThetaResolutionHist.c_str());
-    ctgThetaErrorHist->SetDirectory(0);
-    fin->Close();
+    fCandidates.push_back(candidate);
+    fPT.push_back(candidate->Momentum.Pt());
+    fAbsEta.push_back(TMath::Abs(candidate->Momentum.Eta()));
   }
-  if(!fUsePhiFormula)
+
+  size = fCandidates.size();
+
+  if(fSameBinning && fReferenceTable)
   {
-    TFile *fin = TFile::Open(fPhiResolutionFile.c_str());
-    phiErrorHist = (TProfile2D *)fin->Get(fPhiResolutionHist.c_str());
-    phiErrorHist->SetDirectory(0);
-    fin->Close();
+    fBins.resize(size);
+    for(i = 0; i < size; ++i) fBins[i] = fReferenceTable->FindBin(fPT[i], fAbsEta[i]);
   }
 
-  fItInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  ComputeErrors(fUseD0Formula, fD0Formula, fD0Table, fD0Errors);
+  ComputeErrors(fUseDZFormula, fDZFormula, fDZTable, fDZErrors);
+  ComputeErrors(fUsePFormula, fPFormula, fPTable, fPErrors);
+  ComputeErrors(fUseCtgThetaFormula, fCtgThetaFormula, fCtgThetaTable, fCtgThetaErrors);
+  ComputeErrors(fUsePhiFormula, fPhiFormula, fPhiTable, fPhiErrors);
+
+  for(i = 0; i < size; ++i)
   {
+    candidate = fCandidates[i];
 
     const TLorentzVector &momentum = candidate->Momentum;
     const TLorentzVector &position = candidate->InitialPosition;
 
-    pt = momentum.Pt();
-    eta = momentum.Eta();
-    e = momentum.E();
     m = momentum.M();
 
     d0 = trueD0 = candidate->D0;
@@ -232,88 +307,35 @@ void TrackSmearing::Process()
     ctgTheta = trueCtgTheta = candidate->CtgTheta;
     phi = truePhi = candidate->Phi;
 
-    if(fUseD0Formula)
-      d0Error = fD0Formula->Eval(pt, eta, phi, e, candidate);
-    else
-    {
-      Int_t xbin, ybin;
-
-      xbin = pt < d0ErrorHist->GetXaxis()->GetXmax() ? d0ErrorHist->GetXaxis()->FindBin(pt) : d0ErrorHist->GetXaxis()->GetBinCenter(d0ErrorHist->GetXaxis()->GetNbins());
-      ybin = d0ErrorHist->GetYaxis()->FindBin(TMath::Abs(eta));
-      d0Error = d0ErrorHist->GetBinContent(xbin, ybin);
-      if(!d0Error)
-        d0Error = -1.0;
-    }
-    if(d0Error < 0.0)
-      continue;
-
-    if(fUseDZFormula)
-      dzError = fDZFormula->Eval(pt, eta, phi, e, candidate);
-    else
-    {
-      Int_t xbin, ybin;
-
-      xbin = pt < dzErrorHist->GetXaxis()->GetXmax() ? dzErrorHist->GetXaxis()->FindBin(pt) : dzErrorHist->GetXaxis()->GetBinCenter(dzErrorHist->GetXaxis()->GetNbins());
-      ybin = dzErrorHist->GetYaxis()->FindBin(TMath::Abs(eta));
-      dzError = dzErrorHist->GetBinContent(xbin, ybin);
-      if(!dzError)
-        dzError = -1.0;
-    }
-    if(dzError < 0.0)
-      continue;
-
-    if(fUsePFormula)
-      pError = fPFormula->Eval(pt, eta, phi, e, candidate) * p;
-    else
-    {
-      Int_t xbin, ybin;
+    // empty histogram bins mean that no resolution is available
 
-      xbin = pt < pErrorHist->GetXaxis()->GetXmax() ? pErrorHist->GetXaxis()->FindBin(pt) : pErrorHist->GetXaxis()->GetBinCenter(pErrorHist->GetXaxis()->GetNbins());
-      ybin = pErrorHist->GetYaxis()->FindBin(TMath::Abs(eta));
-      pError = pErrorHist->GetBinContent(xbin, ybin) * p;
-      if(!pError)
-        pError = -1.0;
-    }
-    if(pError < 0.0)
-      continue;
+    d0Error = fD0Errors[i];
+    if(!fUseD0Formula && !d0Error) d0Error = -1.0;
+    if(d0Error < 0.0) continue;
 
-    if(fUseCtgThetaFormula)
-      ctgThetaError = fCtgThetaFormula->Eval(pt, eta, phi, e, candidate);
-    else
-    {
-      Int_t xbin, ybin;
+    dzError = fDZErrors[i];
+    if(!fUseDZFormula && !dzError) dzError = -1.0;
+    if(dzError < 0.0) continue;
 
-      xbin = pt < ctgThetaErrorHist->GetXaxis()->GetXmax() ? ctgThetaErrorHist->GetXaxis()->FindBin(pt) : ctgThetaErrorHist->GetXaxis()->GetBinCenter(ctgThetaErrorHist->GetXaxis()->GetNbins());
-      ybin = ctgThetaErrorHist->GetYaxis()->FindBin(TMath::Abs(eta));
-      ctgThetaError = ctgThetaErrorHist->GetBinContent(xbin, ybin);
-      if(!ctgThetaError)
-        ctgThetaError = -1.0;
-    }
-    if(ctgThetaError < 0.0)
-      continue;
+    pError = fPErrors[i] * p;
+    if(!fUsePFormula && !pError) pError = -1.0;
+    if(pError < 0.0) continue;
 
-    if(fUsePhiFormula)
-      phiError = fPhiFormula->Eval(pt, eta, phi, e, candidate);
-    else
-    {
-      Int_t xbin, ybin;
+    ctgThetaError = fCtgThetaErrors[i];
+    if(!fUseCtgThetaFormula && !ctgThetaError) ctgThetaError = -1.0;
+    if(ctgThetaError < 0.0) continue;
 
-      xbin = pt < phiErrorHist->GetXaxis()->GetXmax() ? phiErrorHist->GetXaxis()->FindBin(pt) : phiErrorHist->GetXaxis()->GetBinCenter(phiErrorHist->GetXaxis()->GetNbins());
-      ybin = phiErrorHist->GetYaxis()->FindBin(TMath::Abs(eta));
-      phiError = phiErrorHist->GetBinContent(xbin, ybin);
-      if(!phiError)
-        phiError = -1.0;
-    }
-    if(phiError < 0.0)
-      continue;
+    phiError = fPhiErrors[i];
+    if(!fUsePhiFormula && !phiError) phiError = -1.0;
+    if(phiError < 0.0) continue;
 
     if(fApplyToPileUp || !candidate->IsPU)
     {
-      d0 = gRandom->Gaus(d0, d0Error);
-      dz = gRandom->Gaus(dz, dzError);
-      p = gRandom->Gaus(p, pError);
-      ctgTheta = gRandom->Gaus(ctgTheta, ctgThetaError);
-      phi = gRandom->Gaus(phi, phiError);
+      d0 = GetRandom()->Gaus(d0, d0Error);
+      dz = GetRandom()->Gaus(dz, dzError);
+      p = GetRandom()->Gaus(p, pError);
+      ctgTheta = GetRandom()->Gaus(ctgTheta, ctgThetaError);
+      phi = GetRandom()->Gaus(phi, phiError);
     }
 
     if(p < 0.0) continue;
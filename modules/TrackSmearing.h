@@ -13,9 +13,14 @@
 
 #include "classes/DelphesModule.h"
 
+#include <string>
+#include <vector>
+
 class TIterator;
 class TObjArray;
+class Candidate;
 class DelphesFormula;
+class DelphesLookupTable;
 
 class TrackSmearing: public DelphesModule
 {
@@ -30,34 +35,53 @@ public:
 private:
   Double_t ptError(const Double_t, const Double_t, const Double_t, const Double_t);
 
+  DelphesLookupTable *LoadTable(const std::string &fileName, const std::string &histName);
+
+  void ComputeErrors(Bool_t useFormula, DelphesFormula *formula, const DelphesLookupTable *table, std::vector<Double_t> &errors);
+
   Double_t fBz;
 
   DelphesFormula *fD0Formula; //!
   std::string fD0ResolutionFile;
   std::string fD0ResolutionHist;
   Bool_t fUseD0Formula;
+  DelphesLookupTable *fD0Table; //!
 
   DelphesFormula *fDZFormula; //!
   std::string fDZResolutionFile;
   std::string fDZResolutionHist;
   Bool_t fUseDZFormula;
+  DelphesLookupTable *fDZTable; //!
 
   DelphesFormula *fPFormula; //!
   std::string fPResolutionFile;
   std::string fPResolutionHist;
   Bool_t fUsePFormula;
+  DelphesLookupTable *fPTable; //!
 
   DelphesFormula *fCtgThetaFormula; //!
   std::string fCtgThetaResolutionFile;
   std::string fCtgThetaResolutionHist;
   Bool_t fUseCtgThetaFormula;
+  DelphesLookupTable *fCtgThetaTable; //!
 
   DelphesFormula *fPhiFormula; //!
   std::string fPhiResolutionFile;
   std::string fPhiResolutionHist;
   Bool_t fUsePhiFormula;
+  DelphesLookupTable *fPhiTable; //!
 
   Bool_t fApplyToPileUp;
+  Bool_t fInterpolateResolution;
+
+  // histogram lookup tables sharing the same binning are evaluated once per track
+  const DelphesLookupTable *fReferenceTable; //!
+  Bool_t fSameBinning;
+
+  std::vector<Candidate *> fCandidates; //!
+  std::vector<Double_t> fPT, fAbsEta; //!
+  std::vector<Int_t> fBins; //!
+  std::vector<Double_t> fD0Errors, fDZErrors, fPErrors, fCtgThetaErrors, fPhiErrors; //!
 
   TIterator *fItInputArray; //!
 
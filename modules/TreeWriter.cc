@@ -40,6 +40,7 @@
 #include "TLorentzVector.h"
 #include "TMath.h"
 #include "TObjArray.h"
+#include "TProcessID.h"
 #include "TROOT.h"
 #include "TRandom3.h"
 #include "TString.h"
@@ -54,7 +55,8 @@ using namespace std;
 
 //------------------------------------------------------------------------------
 
-TreeWriter::TreeWriter()
+TreeWriter::TreeWriter() :
+  fPruneParticles(kFALSE)
 {
 }
 
@@ -84,6 +86,7 @@ void TreeWriter::Init()
   fClassMap[Weight::Class()] = &TreeWriter::ProcessWeight;
   fClassMap[HectorHit::Class()] = &TreeWriter::ProcessHectorHit;
 
+  stringstream message;
   TBranchMap::iterator itBranchMap;
   map<TClass *, TProcessMethod>::iterator itClassMap;
 
@@ -92,7 +95,7 @@ void TreeWriter::Init()
 
   ExRootConfParam param = GetParam("Branch");
   Long_t i, size;
-  TString branchName, branchClassName, branchInputArray;
+  TString branchName, branchClassName, branchInputArray, particleInputArray;
   TClass *branchClass;
   TObjArray *array;
   ExRootTreeBranch *branch;
@@ -122,6 +125,12 @@ void TreeWriter::Init()
     array = ImportArray(branchInputArray);
     branch = NewBranch(branchName, branchClass);
 
+    // M1, M2, D1 and D2 are positions in the array of all particles
+    if(itClassMap->second == &TreeWriter::ProcessParticles && GetImportedArrays().back() != "Delphes/allParticles")
+    {
+      particleInputArray = branchInputArray;
+    }
+
     fBranchMap.insert(make_pair(branch, make_pair(itClassMap->second, array)));
   }
 
@@ -137,6 +146,32 @@ void TreeWriter::Init()
 
     AddInfo(infoName, infoValue);
   }
+
+  // generator particle pruning
+
+  fPruneParticles = GetBool("PruneParticles", false);
+
+  if(fPruneParticles && particleInputArray.Length() > 0)
+  {
+    message << "module '" << GetName() << "' can't prune the particles of '";
+    message << particleInputArray << "', PruneParticles requires GenParticle branches";
+    message << " filled from Delphes/allParticles";
+    throw runtime_error(message.str());
+  }
+
+  param = GetParam("KeepParticles");
+  TParticleRule rule;
+
+  fParticleRules.clear();
+  size = param.GetSize();
+  for(i = 0; i < size / 3; ++i)
+  {
+    rule.status = param[i * 3].GetInt();
+    rule.pid = TMath::Abs(param[i * 3 + 1].GetInt());
+    rule.minPT = param[i * 3 + 2].GetDouble();
+
+    fParticleRules.push_back(rule);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -195,26 +230,141 @@ void TreeWriter::FillParticles(Candidate *candidate, TRefArray *array)
 
 //------------------------------------------------------------------------------
 
+void TreeWriter::MarkCandidates(Candidate *candidate)
+{
+  Candidate *constituent;
+  vector<Bool_t> *marks;
+  UInt_t id;
+
+  marks = &fMarkedCandidates[candidate->GetFactory()];
+  id = candidate->GetCandidateID();
+  if(id >= marks->size()) marks->resize(id + 1, kFALSE);
+  if((*marks)[id]) return;
+  (*marks)[id] = kTRUE;
+
+  if(candidate->GetNumberOfCandidates() == 0) return;
+
+  TIter itConstituents(candidate->GetCandidates());
+  while((constituent = static_cast<Candidate *>(itConstituents.Next())))
+  {
+    MarkCandidates(constituent);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void TreeWriter::SelectParticles(TObjArray *array)
+{
+  TBranchMap::iterator itBranchMap;
+  map<const DelphesFactory *, vector<Bool_t> >::iterator itMarks;
+  vector<TParticleRule>::const_iterator itRules;
+  vector<Int_t> stack;
+  vector<Bool_t> *marks;
+  Candidate *candidate;
+  Int_t i, size, mother, counter;
+  UInt_t id;
+
+  // constituents of the candidates of the other branches, which include
+  // all the particles referenced through Particle or Particles
+
+  for(itMarks = fMarkedCandidates.begin(); itMarks != fMarkedCandidates.end(); ++itMarks)
+  {
+    itMarks->second.assign(itMarks->second.size(), kFALSE);
+  }
+  for(itBranchMap = fBranchMap.begin(); itBranchMap != fBranchMap.end(); ++itBranchMap)
+  {
+    if(itBranchMap->second.first == &TreeWriter::ProcessParticles) continue;
+
+    TIter itArray(itBranchMap->second.second);
+    while((candidate = static_cast<Candidate *>(itArray.Next())))
+    {
+      MarkCandidates(candidate);
+    }
+  }
+
+  // -1 dropped, 0 kept, 1 kept together with its ancestors
+
+  size = array->GetEntriesFast();
+  fParticleIndices.assign(size, -1);
+  for(i = 0; i < size; ++i)
+  {
+    candidate = static_cast<Candidate *>(array->At(i));
+
+    marks = &fMarkedCandidates[candidate->GetFactory()];
+    id = candidate->GetCandidateID();
+    if(id < marks->size() && (*marks)[id]) fParticleIndices[i] = 0;
+
+    for(itRules = fParticleRules.begin(); itRules != fParticleRules.end(); ++itRules)
+    {
+      if(itRules->status != 0 && candidate->Status != itRules->status) continue;
+      if(itRules->pid != 0 && TMath::Abs(candidate->PID) != itRules->pid) continue;
+      if(candidate->Momentum.Pt() < itRules->minPT) continue;
+
+      fParticleIndices[i] = 1;
+      stack.push_back(i);
+      break;
+    }
+  }
+
+  // ancestry chains of the particles selected by the rules
+
+  while(!stack.empty())
+  {
+    candidate = static_cast<Candidate *>(array->At(stack.back()));
+    stack.pop_back();
+
+    for(mother = candidate->M1, i = 0; i < 2; mother = candidate->M2, ++i)
+    {
+      if(mother < 0 || mother >= size || fParticleIndices[mother] == 1) continue;
+      fParticleIndices[mother] = 1;
+      stack.push_back(mother);
+    }
+  }
+
+  counter = 0;
+  for(i = 0; i < size; ++i)
+  {
+    if(fParticleIndices[i] >= 0) fParticleIndices[i] = counter++;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+Int_t TreeWriter::GetParticleIndex(Int_t index) const
+{
+  if(index < 0 || index >= Int_t(fParticleIndices.size())) return -1;
+  return fParticleIndices[index];
+}
+
+//------------------------------------------------------------------------------
+
 void TreeWriter::ProcessParticles(ExRootTreeBranch *branch, TObjArray *array)
 {
   TIter iterator(array);
   Candidate *candidate = 0;
   GenParticle *entry = 0;
   Double_t pt, signPz, cosTheta, eta, rapidity;
+  Int_t index, first, last;
 
   const Double_t c_light = 2.99792458E8;
 
+  if(fPruneParticles) SelectParticles(array);
+
   // loop over all particles
+  index = -1;
   iterator.Reset();
   while((candidate = static_cast<Candidate *>(iterator.Next())))
   {
+    ++index;
+    if(fPruneParticles && fParticleIndices[index] < 0) continue;
+
     const TLorentzVector &momentum = candidate->Momentum;
     const TLorentzVector &position = candidate->Position;
 
     entry = static_cast<GenParticle *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     pt = momentum.Pt();
     cosTheta = TMath::Abs(momentum.CosTheta());
@@ -252,6 +402,23 @@ void TreeWriter::ProcessParticles(ExRootTreeBranch *branch, TObjArray *array)
     entry->Z = position.Z();
     entry->T = position.T() * 1.0E-3 / c_light;
 
+    if(fPruneParticles)
+    {
+      entry->M1 = GetParticleIndex(candidate->M1);
+      entry->M2 = GetParticleIndex(candidate->M2);
+
+      // daughters keep their order, the written ones of D1..D2 stay contiguous
+      first = candidate->D1;
+      last = candidate->D2 >= first ? candidate->D2 : first;
+      entry->D1 = -1;
+      entry->D2 = -1;
+      for(; first >= 0 && first <= last && first < Int_t(fParticleIndices.size()); ++first)
+      {
+        if(fParticleIndices[first] < 0) continue;
+        if(entry->D1 < 0) entry->D1 = fParticleIndices[first];
+        entry->D2 = fParticleIndices[first];
+      }
+    }
   }
 }
 
@@ -268,10 +435,7 @@ void TreeWriter::ProcessVertices(ExRootTreeBranch *branch, TObjArray *array)
   Double_t x, y, z, t, xError, yError, zError, tError, sigma, sumPT2, btvSumPT2, genDeltaZ, genSumPT2;
   UInt_t index, ndf;
 
-  CompBase *compare = Candidate::fgCompare;
-  Candidate::fgCompare = CompSumPT2<Candidate>::Instance();
-  array->Sort();
-  Candidate::fgCompare = compare;
+  fSorter.Sort<Candidate>(array, KeySumPT2<Candidate>());
 
   // loop over all vertices
   iterator.Reset();
@@ -351,7 +515,7 @@ void TreeWriter::ProcessTracks(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<Track *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->PID = candidate->PID;
 
@@ -383,16 +547,17 @@ void TreeWriter::ProcessTracks(ExRootTreeBranch *branch, TObjArray *array)
     entry->ErrorCtgTheta = candidate->ErrorCtgTheta;
 
     // add some offdiagonal covariance matrix elements
-    entry->ErrorD0Phi          = candidate->TrackCovariance(0,1)*1.e3;
-    entry->ErrorD0C            = candidate->TrackCovariance(0,2);
-    entry->ErrorD0DZ           = candidate->TrackCovariance(0,3)*1.e6;
-    entry->ErrorD0CtgTheta     = candidate->TrackCovariance(0,4)*1.e3;
-    entry->ErrorPhiC           = candidate->TrackCovariance(1,2)*1.e-3;
-    entry->ErrorPhiDZ          = candidate->TrackCovariance(1,3)*1.e3;
-    entry->ErrorPhiCtgTheta    = candidate->TrackCovariance(1,4);
-    entry->ErrorCDZ            = candidate->TrackCovariance(2,3);
-    entry->ErrorCCtgTheta      = candidate->TrackCovariance(2,4)*1.e-3;
-    entry->ErrorDZCtgTheta     = candidate->TrackCovariance(3,4)*1.e3;
+    const TMatrixDSym &covariance = candidate->GetTrackCovariance();
+    entry->ErrorD0Phi          = covariance(0,1)*1.e3;
+    entry->ErrorD0C            = covariance(0,2);
+    entry->ErrorD0DZ           = covariance(0,3)*1.e6;
+    entry->ErrorD0CtgTheta     = covariance(0,4)*1.e3;
+    entry->ErrorPhiC           = covariance(1,2)*1.e-3;
+    entry->ErrorPhiDZ          = covariance(1,3)*1.e3;
+    entry->ErrorPhiCtgTheta    = covariance(1,4);
+    entry->ErrorCDZ            = covariance(2,3);
+    entry->ErrorCCtgTheta      = covariance(2,4)*1.e-3;
+    entry->ErrorDZCtgTheta     = covariance(3,4)*1.e3;
 
     entry->Xd = candidate->Xd;
     entry->Yd = candidate->Yd;
@@ -465,7 +630,7 @@ void TreeWriter::ProcessTowers(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<Tower *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->Eta = eta;
     entry->Phi = momentum.Phi();
@@ -512,7 +677,7 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     entry = static_cast<ParticleFlowCandidate *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->PID = candidate->PID;
 
@@ -547,16 +712,17 @@ void TreeWriter::ProcessParticleFlowCandidates(ExRootTreeBranch *branch, TObjArr
     entry->ErrorCtgTheta = candidate->ErrorCtgTheta;
 
     // add some offdiagonal covariance matrix elements
-    entry->ErrorD0Phi          = candidate->TrackCovariance(0,1);
-    entry->ErrorD0C            = candidate->TrackCovariance(0,2);
-    entry->ErrorD0DZ           = candidate->TrackCovariance(0,3);
-    entry->ErrorD0CtgTheta     = candidate->TrackCovariance(0,4);
-    entry->ErrorPhiC           = candidate->TrackCovariance(1,2);
-    entry->ErrorPhiDZ          = candidate->TrackCovariance(1,3);
-    entry->ErrorPhiCtgTheta    = candidate->TrackCovariance(1,4);
-    entry->ErrorCDZ            = candidate->TrackCovariance(2,3);
-    entry->ErrorCCtgTheta      = candidate->TrackCovariance(2,4);
-    entry->ErrorDZCtgTheta     = candidate->TrackCovariance(3,4);
+    const TMatrixDSym &covariance = candidate->GetTrackCovariance();
+    entry->ErrorD0Phi          = covariance(0,1);
+    entry->ErrorD0C            = covariance(0,2);
+    entry->ErrorD0DZ           = covariance(0,3);
+    entry->ErrorD0CtgTheta     = covariance(0,4);
+    entry->ErrorPhiC           = covariance(1,2);
+    entry->ErrorPhiDZ          = covariance(1,3);
+    entry->ErrorPhiCtgTheta    = covariance(1,4);
+    entry->ErrorCDZ            = covariance(2,3);
+    entry->ErrorCCtgTheta      = covariance(2,4);
+    entry->ErrorDZCtgTheta     = covariance(3,4);
 
     entry->Xd = candidate->Xd;
     entry->Yd = candidate->Yd;
@@ -622,7 +788,7 @@ void TreeWriter::ProcessPhotons(ExRootTreeBranch *branch, TObjArray *array)
   Double_t pt, signPz, cosTheta, eta, rapidity;
   const Double_t c_light = 2.99792458E8;
 
-  array->Sort();
+  fSorter.Sort<Candidate>(array, KeyMomentumPt<Candidate>());
 
   // loop over all photons
   iterator.Reset();
@@ -674,7 +840,7 @@ void TreeWriter::ProcessElectrons(ExRootTreeBranch *branch, TObjArray *array)
   Double_t pt, signPz, cosTheta, eta, rapidity;
   const Double_t c_light = 2.99792458E8;
 
-  array->Sort();
+  fSorter.Sort<Candidate>(array, KeyMomentumPt<Candidate>());
 
   // loop over all electrons
   iterator.Reset();
@@ -730,7 +896,7 @@ void TreeWriter::ProcessMuons(ExRootTreeBranch *branch, TObjArray *array)
 
   const Double_t c_light = 2.99792458E8;
 
-  array->Sort();
+  fSorter.Sort<Candidate>(array, KeyMomentumPt<Candidate>());
 
   // loop over all muons
   iterator.Reset();
@@ -748,7 +914,7 @@ void TreeWriter::ProcessMuons(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<Muon *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->Eta = eta;
     entry->Phi = momentum.Phi();
@@ -789,7 +955,7 @@ void TreeWriter::ProcessJets(ExRootTreeBranch *branch, TObjArray *array)
   const Double_t c_light = 2.99792458E8;
   Int_t i;
 
-  array->Sort();
+  fSorter.Sort<Candidate>(array, KeyMomentumPt<Candidate>());
 
   // loop over all jets
   iterator.Reset();
@@ -862,28 +1028,30 @@ void TreeWriter::ProcessJets(ExRootTreeBranch *branch, TObjArray *array)
 
     //--- Sub-structure variables ----
 
-    entry->NSubJetsTrimmed = candidate->NSubJetsTrimmed;
-    entry->NSubJetsPruned = candidate->NSubJetsPruned;
-    entry->NSubJetsSoftDropped = candidate->NSubJetsSoftDropped;
+    const CandidateSubstructure &substructure = candidate->GetSubstructure();
+
+    entry->NSubJetsTrimmed = substructure.NSubJetsTrimmed;
+    entry->NSubJetsPruned = substructure.NSubJetsPruned;
+    entry->NSubJetsSoftDropped = substructure.NSubJetsSoftDropped;
 
-    entry->SoftDroppedJet = candidate->SoftDroppedJet;
-    entry->SoftDroppedSubJet1 = candidate->SoftDroppedSubJet1;
-    entry->SoftDroppedSubJet2 = candidate->SoftDroppedSubJet2;
+    entry->SoftDroppedJet = substructure.SoftDroppedJet;
+    entry->SoftDroppedSubJet1 = substructure.SoftDroppedSubJet1;
+    entry->SoftDroppedSubJet2 = substructure.SoftDroppedSubJet2;
 
     for(i = 0; i < 5; i++)
     {
       entry->FracPt[i] = candidate->FracPt[i];
-      entry->Tau[i] = candidate->Tau[i];
-      entry->TrimmedP4[i] = candidate->TrimmedP4[i];
-      entry->PrunedP4[i] = candidate->PrunedP4[i];
-      entry->SoftDroppedP4[i] = candidate->SoftDroppedP4[i];
+      entry->Tau[i] = substructure.Tau[i];
+      entry->TrimmedP4[i] = substructure.TrimmedP4[i];
+      entry->PrunedP4[i] = substructure.PrunedP4[i];
+      entry->SoftDroppedP4[i] = substructure.SoftDroppedP4[i];
     }
 
     //--- exclusive clustering variables ---
-    entry->ExclYmerge23 = candidate->ExclYmerge23;
-    entry->ExclYmerge34 = candidate->ExclYmerge34;
-    entry->ExclYmerge45 = candidate->ExclYmerge45;
-    entry->ExclYmerge56 = candidate->ExclYmerge56;
+    entry->ExclYmerge23 = substructure.ExclYmerge23;
+    entry->ExclYmerge34 = substructure.ExclYmerge34;
+    entry->ExclYmerge45 = substructure.ExclYmerge45;
+    entry->ExclYmerge56 = substructure.ExclYmerge56;
 
     FillParticles(candidate, &entry->Particles);
   }
@@ -919,7 +1087,7 @@ void TreeWriter::ProcessCscCluster(ExRootTreeBranch *branch, TObjArray *array)
 
   const Double_t c_light = 2.99792458E8; // in unit of m/s
 
-  array->Sort();
+  fSorter.Sort<Candidate>(array, KeyMomentumPt<Candidate>());
 
 
   // loop over all clusters
@@ -937,7 +1105,7 @@ void TreeWriter::ProcessCscCluster(ExRootTreeBranch *branch, TObjArray *array)
     entry = static_cast<CscCluster *>(branch->NewEntry());
 
     entry->SetBit(kIsReferenced);
-    entry->SetUniqueID(candidate->GetUniqueID());
+    entry->SetUniqueID(TProcessID::AssignID(candidate));
 
     entry->Eta = eta;
     entry->Phi = momentum.Phi();
@@ -23,13 +23,22 @@
  *
  *  Fills ROOT tree branches.
  *
+ *  With PruneParticles enabled, the GenParticle branches only keep the
+ *  particles reachable from the candidates of the other branches, the
+ *  particles matching one of the KeepParticles rules (status, |PID| and
+ *  minimum pT, 0 matches any status or PID) and the ancestors of the
+ *  latter. M1, M2, D1 and D2 are re-indexed to the written particles,
+ *  so the pruned branches have to be filled from Delphes/allParticles.
+ *
  *  \author P. Demin - UCL, Louvain-la-Neuve
  *
  */
 
 #include "classes/DelphesModule.h"
+#include "classes/SortableObject.h"
 
 #include <map>
+#include <vector>
 
 class TClass;
 class TObjArray;
@@ -51,6 +60,10 @@ public:
 private:
   void FillParticles(Candidate *candidate, TRefArray *array);
 
+  void MarkCandidates(Candidate *candidate);
+  void SelectParticles(TObjArray *array);
+  Int_t GetParticleIndex(Int_t index) const;
+
   void ProcessParticles(ExRootTreeBranch *branch, TObjArray *array);
   void ProcessVertices(ExRootTreeBranch *branch, TObjArray *array);
   void ProcessTracks(ExRootTreeBranch *branch, TObjArray *array);
@@ -77,8 +90,27 @@ private:
   TBranchMap fBranchMap; //!
 
   std::map<TClass *, TProcessMethod> fClassMap; //!
+
+  KeySorter fSorter; //!
+
+  struct TParticleRule
+  {
+    Int_t status, pid;
+    Double_t minPT;
+  };
+
+  std::vector<TParticleRule> fParticleRules; //!
+
+  // candidates written to the other branches and all their constituents,
+  // indexed by candidate identifier, which is only unique within a factory
+  std::map<const DelphesFactory *, std::vector<Bool_t> > fMarkedCandidates; //!
+
+  // position of each input particle in the pruned branch, or -1
+  std::vector<Int_t> fParticleIndices; //!
 #endif
 
+  Bool_t fPruneParticles; //!
+
   ClassDef(TreeWriter, 2)
 };
 
@@ -65,7 +65,7 @@ UniqueObjectFinder::~UniqueObjectFinder()
 
 void UniqueObjectFinder::Init()
 {
-  // use GetUniqueID algorithm to find unique objects (faster than the default Overlaps method)
+  // use candidate identifiers to find unique objects (faster than the default Overlaps method)
   fUseUniqueID = GetBool("UseUniqueID", false);
 
   // import arrays with output from other modules
@@ -149,7 +149,7 @@ Bool_t UniqueObjectFinder::Unique(Candidate *candidate, vector<pair<TIterator *,
     {
       if(fUseUniqueID)
       {
-        if(candidate->GetUniqueID() == previousCandidate->GetUniqueID())
+        if(candidate->GetCandidateID() == previousCandidate->GetCandidateID())
         {
           return kFALSE;
         }
@@ -66,7 +66,7 @@ void VertexFinder::Init()
   fMinNDF = GetInt("MinNDF", 4);
   fGrowSeeds = GetInt("GrowSeeds", 1);
 
-  fInputArray = ImportArray(GetString("InputArray", "TrackSmearing/tracks"));
+  fInputArray = UpdateArray(GetString("InputArray", "TrackSmearing/tracks"));
   fItInputArray = fInputArray->MakeIterator();
 
   fOutputArray = ExportArray(GetString("OutputArray", "tracks"));
@@ -147,7 +147,7 @@ void VertexFinder::Process()
   {
     if(candidate->Momentum.Pt() < fMinPT || fabs(candidate->Momentum.Eta()) > fMaxEta)
       continue;
-    candidate->ClusterIndex = trackIDToInt.at(candidate->GetUniqueID()).at("clusterIndex");
+    candidate->ClusterIndex = trackIDToInt.at(candidate->GetCandidateID()).at("clusterIndex");
     fOutputArray->Add(candidate);
   }
 
@@ -193,20 +193,20 @@ void VertexFinder::createSeeds()
     if(candidate->Momentum.Pt() < fMinPT || fabs(candidate->Momentum.Eta()) > fMaxEta)
       continue;
 
-    trackIDToDouble[candidate->GetUniqueID()]["pt"] = candidate->Momentum.Pt();
-    trackIDToDouble[candidate->GetUniqueID()]["ept"] = candidate->ErrorPT ? candidate->ErrorPT : 1.0e-15;
+    trackIDToDouble[candidate->GetCandidateID()]["pt"] = candidate->Momentum.Pt();
+    trackIDToDouble[candidate->GetCandidateID()]["ept"] = candidate->ErrorPT ? candidate->ErrorPT : 1.0e-15;
     ;
-    trackIDToDouble[candidate->GetUniqueID()]["eta"] = candidate->Momentum.Eta();
+    trackIDToDouble[candidate->GetCandidateID()]["eta"] = candidate->Momentum.Eta();
 
-    trackIDToDouble[candidate->GetUniqueID()]["z"] = candidate->DZ;
-    trackIDToDouble[candidate->GetUniqueID()]["ez"] = candidate->ErrorDZ ? candidate->ErrorDZ : 1.0e-15;
+    trackIDToDouble[candidate->GetCandidateID()]["z"] = candidate->DZ;
+    trackIDToDouble[candidate->GetCandidateID()]["ez"] = candidate->ErrorDZ ? candidate->ErrorDZ : 1.0e-15;
 
-    trackIDToInt[candidate->GetUniqueID()]["clusterIndex"] = -1;
-    trackIDToInt[candidate->GetUniqueID()]["interactionIndex"] = candidate->IsPU;
+    trackIDToInt[candidate->GetCandidateID()]["clusterIndex"] = -1;
+    trackIDToInt[candidate->GetCandidateID()]["interactionIndex"] = candidate->IsPU;
 
-    trackIDToBool[candidate->GetUniqueID()]["claimed"] = false;
+    trackIDToBool[candidate->GetCandidateID()]["claimed"] = false;
 
-    trackPT.push_back(make_pair(candidate->GetUniqueID(), candidate->Momentum.Pt()));
+    trackPT.push_back(make_pair(candidate->GetCandidateID(), candidate->Momentum.Pt()));
   }
 
   // Sort tracks by pt and leave only the SeedMinPT highest pt ones in the
@@ -96,12 +96,16 @@ VertexFinderDA4D::VertexFinderDA4D() :
   fUseTc(0), fBetaMax(0), fBetaStop(0), fCoolingFactor(0),
   fMaxIterations(0), fDzCutOff(0), fD0CutOff(0), fDtCutOff(0)
 {
+  fTrackArray = new TObjArray;
+  fItTrackArray = fTrackArray->MakeIterator();
 }
 
 //------------------------------------------------------------------------------
 
 VertexFinderDA4D::~VertexFinderDA4D()
 {
+  if(fTrackArray) delete fTrackArray;
+  if(fItTrackArray) delete fItTrackArray;
 }
 
 //------------------------------------------------------------------------------
@@ -128,8 +132,7 @@ void VertexFinderDA4D::Init()
   fDzCutOff /= 10.0; // Adaptive Fitter uses 3.0 but that appears to be a bit tight here sometimes
   fD0CutOff /= 10.0;
 
-  fInputArray = ImportArray(GetString("InputArray", "TrackSmearing/tracks"));
-  fItInputArray = fInputArray->MakeIterator();
+  fInputArray = UpdateArray(GetString("InputArray", "TrackSmearing/tracks"));
 
   fOutputArray = ExportArray(GetString("OutputArray", "tracks"));
   fVertexOutputArray = ExportArray(GetString("VertexOutputArray", "vertices"));
@@ -139,7 +142,6 @@ void VertexFinderDA4D::Init()
 
 void VertexFinderDA4D::Finish()
 {
-  if(fItInputArray) delete fItInputArray;
 }
 
 //------------------------------------------------------------------------------
@@ -152,16 +154,18 @@ void VertexFinderDA4D::Process()
   TIterator *ItClusterArray;
   Int_t ivtx = 0;
 
-  fInputArray->Sort();
+  fTrackArray->Clear();
+  fTrackArray->AddAll(fInputArray);
+  fTrackArray->Sort();
 
   TLorentzVector pos, mom;
   if(fVerbose)
   {
     cout << " start processing vertices ..." << endl;
-    cout << " Found " << fInputArray->GetEntriesFast() << " input tracks" << endl;
+    cout << " Found " << fTrackArray->GetEntriesFast() << " input tracks" << endl;
     //loop over input tracks
-    fItInputArray->Reset();
-    while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+    fItTrackArray->Reset();
+    while((candidate = static_cast<Candidate *>(fItTrackArray->Next())))
     {
       pos = candidate->InitialPosition;
       mom = candidate->Momentum;
@@ -171,11 +175,11 @@ void VertexFinderDA4D::Process()
   }
 
   // clusterize tracks in Z
-  clusterize(*fInputArray, *ClusterArray);
+  clusterize(*fTrackArray, *ClusterArray);
 
   if(fVerbose)
   {
-    std::cout << " clustering returned  " << ClusterArray->GetEntriesFast() << " clusters  from " << fInputArray->GetEntriesFast() << " selected tracks" << std::endl;
+    std::cout << " clustering returned  " << ClusterArray->GetEntriesFast() << " clusters  from " << fTrackArray->GetEntriesFast() << " selected tracks" << std::endl;
   }
 
   //loop over vertex candidates
@@ -359,8 +363,8 @@ vector<Candidate *> VertexFinderDA4D::vertices()
   Double_t z, dz, t, l, dt, d0, d0error;
 
   // loop over input tracks
-  fItInputArray->Reset();
-  while((candidate = static_cast<Candidate *>(fItInputArray->Next())))
+  fItTrackArray->Reset();
+  while((candidate = static_cast<Candidate *>(fItTrackArray->Next())))
   {
     //TBC everything in cm
     z = candidate->DZ / 10;
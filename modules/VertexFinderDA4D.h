@@ -46,7 +46,10 @@ private:
   Double_t fDtCutOff; // for when the beamspot has time
 
   TObjArray *fInputArray;
-  TIterator *fItInputArray;
+
+  // tracks sorted without reordering the input array read by other modules
+  TObjArray *fTrackArray; //!
+  TIterator *fItTrackArray; //!
 
   TObjArray *fOutputArray;
   TObjArray *fVertexOutputArray;
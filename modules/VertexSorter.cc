@@ -62,7 +62,7 @@ VertexSorter::~VertexSorter()
 
 void VertexSorter::Init()
 {
-  fInputArray = ImportArray(GetString("InputArray", "VertexFinder/vertices"));
+  fInputArray = UpdateArray(GetString("InputArray", "VertexFinder/vertices"));
 
   fTrackInputArray = ImportArray(GetString("TrackInputArray", "VertexFinder/tracks"));
   fItTrackInputArray = fTrackInputArray->MakeIterator();
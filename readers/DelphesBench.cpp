@@ -0,0 +1,422 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "TApplication.h"
+#include "TROOT.h"
+
+#include "TFile.h"
+#include "TList.h"
+#include "TObjArray.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+
+#include "classes/DelphesClasses.h"
+#include "classes/DelphesFactory.h"
+#include "classes/DelphesPileUpWriter.h"
+#include "classes/DelphesSyntheticGenerator.h"
+#include "modules/Delphes.h"
+
+#include "ExRootAnalysis/ExRootProgressBar.h"
+#include "ExRootAnalysis/ExRootTreeBranch.h"
+#include "ExRootAnalysis/ExRootTreeWriter.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+// count heap allocations made through operator new
+
+static atomic<Long64_t> allocationCounter(0), allocationBytes(0);
+
+void *operator new(size_t size)
+{
+  void *pointer = malloc(size > 0 ? size : 1);
+  if(!pointer) throw bad_alloc();
+  ++allocationCounter;
+  allocationBytes += size;
+  return pointer;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+  free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+  free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+  free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+  free(pointer);
+}
+
+//---------------------------------------------------------------------------
+
+static bool interrupted = false;
+
+void SignalHandler(int sig)
+{
+  interrupted = true;
+}
+
+//---------------------------------------------------------------------------
+
+static bool GetOption(const char *argument, const char *name, const char *&value)
+{
+  size_t length = strlen(name);
+  if(strncmp(argument, "--", 2) != 0 || strncmp(argument + 2, name, length) != 0 || argument[length + 2] != '=') return false;
+  value = argument + length + 3;
+  return true;
+}
+
+//---------------------------------------------------------------------------
+
+static Double_t GetPeakRSS()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1048576.0;
+#else
+  return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+//---------------------------------------------------------------------------
+
+// write minimum bias events to a pile-up file for cards using PileUpMerger
+void WritePileUpFile(const char *fileName, DelphesSyntheticGenerator *generator, Int_t events)
+{
+  DelphesPileUpWriter writer(fileName);
+  DelphesFactory factory("PileUpFactory");
+  TObjArray *outputArray = factory.NewPermanentArray();
+  TIter itParticle(outputArray);
+  Candidate *candidate;
+  Int_t i;
+
+  for(i = 0; i < events; ++i)
+  {
+    factory.Clear();
+    generator->GenerateMinBias(&factory, outputArray, 0.0, 0.0, 0);
+
+    itParticle.Reset();
+    while((candidate = static_cast<Candidate *>(itParticle.Next())))
+    {
+      const TLorentzVector &position = candidate->Position;
+      const TLorentzVector &momentum = candidate->Momentum;
+      writer.WriteParticle(candidate->PID,
+        position.X(), position.Y(), position.Z(), position.T(),
+        momentum.Px(), momentum.Py(), momentum.Pz(), momentum.E());
+    }
+
+    writer.WriteEntry();
+  }
+
+  writer.WriteIndex();
+}
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "DelphesBench";
+  stringstream message;
+  TFile *outputFile = 0;
+  FILE *jsonFile = 0;
+  TStopwatch genStopWatch, procStopWatch;
+  ExRootTreeWriter *treeWriter = 0;
+  ExRootTreeBranch *branchEvent = 0;
+  ExRootConfReader *confReader = 0;
+  Delphes *modularDelphes = 0;
+  DelphesFactory *factory = 0;
+  DelphesSyntheticGenerator *generator = 0;
+  TObjArray *stableParticleOutputArray = 0, *allParticleOutputArray = 0, *partonOutputArray = 0;
+  HepMCEvent *element;
+  ExRootTask *task;
+  const ExRootConfReader::ExRootTaskMap *modules;
+  ExRootConfReader::ExRootTaskMap::const_iterator itModules;
+  chrono::steady_clock::time_point start;
+  const char *value, *pileUpName = "DelphesBench.pileup";
+  TString parameter, jsonName;
+  Int_t i, seed = 1, minBiasEvents = 1000;
+  Int_t gunParticles = 2, jets = 2;
+  Double_t jetMultiplicity = 30.0, pileUp = 0.0, pileUpMultiplicity = 15.0;
+  Long64_t eventCounter, maxEvents = -1, acceptedCounter, allocations, bytes;
+  Double_t wallTime;
+
+  if(argc < 3)
+  {
+    cout << " Usage: " << appName << " config_file"
+         << " output_file"
+         << " [options]" << endl;
+    cout << " config_file - configuration file in Tcl format," << endl;
+    cout << " output_file - output file in ROOT format, overwritten," << endl;
+    cout << " options:" << endl;
+    cout << "  --events=N - number of events (default MaxEvents or 1000)," << endl;
+    cout << "  --seed=N - seed of the event generator (default 1)," << endl;
+    cout << "  --gun=N - gun particles per event (default 2)," << endl;
+    cout << "  --jets=N - jets per event (default 2)," << endl;
+    cout << "  --jet-multiplicity=X - mean number of jet constituents (default 30)," << endl;
+    cout << "  --pileup=X - mean number of in-time pile-up vertices (default 0)," << endl;
+    cout << "  --pileup-multiplicity=X - mean number of particles per pile-up vertex (default 15)," << endl;
+    cout << "  --pileup-file=FILE - synthetic pile-up file for PileUpMerger modules whose" << endl;
+    cout << "    PileUpFile is not readable (default DelphesBench.pileup)," << endl;
+    cout << "  --minbias-events=N - events in the synthetic pile-up file (default 1000)," << endl;
+    cout << "  --json=FILE - benchmark results in JSON format (default output_file with .json extension)." << endl;
+    return 1;
+  }
+
+  signal(SIGINT, SignalHandler);
+
+  gROOT->SetBatch();
+
+  int appargc = 1;
+  char *appargv[] = {appName};
+  TApplication app(appName, &appargc, appargv);
+
+  try
+  {
+    for(i = 3; i < argc; ++i)
+    {
+      if(GetOption(argv[i], "events", value))
+        maxEvents = atoll(value);
+      else if(GetOption(argv[i], "seed", value))
+        seed = atoi(value);
+      else if(GetOption(argv[i], "gun", value))
+        gunParticles = atoi(value);
+      else if(GetOption(argv[i], "jets", value))
+        jets = atoi(value);
+      else if(GetOption(argv[i], "jet-multiplicity", value))
+        jetMultiplicity = atof(value);
+      else if(GetOption(argv[i], "pileup", value))
+        pileUp = atof(value);
+      else if(GetOption(argv[i], "pileup-multiplicity", value))
+        pileUpMultiplicity = atof(value);
+      else if(GetOption(argv[i], "pileup-file", value))
+        pileUpName = value;
+      else if(GetOption(argv[i], "minbias-events", value))
+        minBiasEvents = atoi(value);
+      else if(GetOption(argv[i], "json", value))
+        jsonName = value;
+      else
+      {
+        message << "unknown option " << argv[i];
+        throw runtime_error(message.str());
+      }
+    }
+
+    if(jsonName.IsNull())
+    {
+      jsonName = argv[2];
+      if(jsonName.EndsWith(".root")) jsonName.Remove(jsonName.Length() - 5);
+      jsonName += ".json";
+    }
+
+    confReader = new ExRootConfReader;
+    confReader->ReadFile(argv[1]);
+
+    if(maxEvents < 0) maxEvents = confReader->GetInt("::MaxEvents", 0);
+    if(maxEvents <= 0) maxEvents = 1000;
+
+    generator = new DelphesSyntheticGenerator(seed);
+    generator->SetGun(gunParticles, 10.0, 100.0, 2.5);
+    generator->SetJets(jets, 30.0, 300.0, jetMultiplicity);
+    generator->SetPileUp(pileUp, pileUpMultiplicity);
+
+    // PileUpMerger modules read synthetic minimum bias events
+    // when their pile-up file is not available
+    modules = confReader->GetModules();
+    for(itModules = modules->begin(); itModules != modules->end(); ++itModules)
+    {
+      if(itModules->second != "PileUpMerger") continue;
+
+      parameter = itModules->first + "::PileUpFile";
+      if(!gSystem->AccessPathName(confReader->GetString(parameter, "MinBias.pileup"))) continue;
+
+      if(gSystem->AccessPathName(pileUpName))
+      {
+        cout << "** Writing " << minBiasEvents << " synthetic pile-up events to " << pileUpName << endl;
+        WritePileUpFile(pileUpName, generator, minBiasEvents);
+      }
+
+      cout << "** INFO: " << itModules->first << " reads " << pileUpName << endl;
+      confReader->SetParam(parameter, pileUpName);
+    }
+
+    generator->SetSeed(seed);
+
+    outputFile = TFile::Open(argv[2], "RECREATE");
+
+    if(outputFile == NULL)
+    {
+      message << "can't create output file " << argv[2];
+      throw runtime_error(message.str());
+    }
+
+    treeWriter = new ExRootTreeWriter(outputFile, "Delphes");
+
+    branchEvent = treeWriter->NewBranch("Event", HepMCEvent::Class());
+
+    modularDelphes = new Delphes("Delphes");
+    modularDelphes->SetConfReader(confReader);
+    modularDelphes->SetTreeWriter(treeWriter);
+
+    factory = modularDelphes->GetFactory();
+    allParticleOutputArray = modularDelphes->ExportArray("allParticles");
+    stableParticleOutputArray = modularDelphes->ExportArray("stableParticles");
+    partonOutputArray = modularDelphes->ExportArray("partons");
+
+    ExRootTask::SetTiming(kTRUE);
+
+    modularDelphes->InitTask();
+
+    ExRootProgressBar progressBar(maxEvents);
+
+    // Loop over all events
+    eventCounter = 0;
+    acceptedCounter = 0;
+    treeWriter->Clear();
+    modularDelphes->Clear();
+    genStopWatch.Reset();
+    procStopWatch.Reset();
+
+    allocations = allocationCounter;
+    bytes = allocationBytes;
+    start = chrono::steady_clock::now();
+
+    for(eventCounter = 0; eventCounter < maxEvents && !interrupted; ++eventCounter)
+    {
+      genStopWatch.Start(kFALSE);
+      generator->GenerateEvent(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray);
+      genStopWatch.Stop();
+
+      procStopWatch.Start(kFALSE);
+      modularDelphes->SetEventNumber(eventCounter);
+      modularDelphes->ProcessTask();
+
+      element = static_cast<HepMCEvent *>(branchEvent->NewEntry());
+      element->Number = eventCounter + 1;
+
+      if(modularDelphes->IsEventAccepted())
+      {
+        treeWriter->Fill();
+        ++acceptedCounter;
+      }
+
+      treeWriter->Clear();
+      modularDelphes->Clear();
+      procStopWatch.Stop();
+
+      progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
+      progressBar.Update(eventCounter, eventCounter);
+    }
+
+    wallTime = chrono::duration<Double_t>(chrono::steady_clock::now() - start).count();
+    allocations = allocationCounter - allocations;
+    bytes = allocationBytes - bytes;
+
+    progressBar.Update(eventCounter, eventCounter, kTRUE);
+    progressBar.Finish();
+
+    modularDelphes->FinishTask();
+    treeWriter->Write();
+
+    // Write benchmark results
+    jsonFile = fopen(jsonName, "w");
+    if(jsonFile == NULL)
+    {
+      message << "can't create " << jsonName;
+      throw runtime_error(message.str());
+    }
+
+    fprintf(jsonFile, "{\n");
+    fprintf(jsonFile, "  \"card\": \"%s\",\n", argv[1]);
+    fprintf(jsonFile, "  \"generator\": {\"seed\": %d, \"gun\": %d, \"jets\": %d, \"jet_multiplicity\": %g, \"pileup\": %g, \"pileup_multiplicity\": %g},\n",
+      seed, gunParticles, jets, jetMultiplicity, pileUp, pileUpMultiplicity);
+    fprintf(jsonFile, "  \"events\": %lld,\n", eventCounter);
+    fprintf(jsonFile, "  \"accepted_events\": %lld,\n", acceptedCounter);
+    fprintf(jsonFile, "  \"wall_seconds\": %.6f,\n", wallTime);
+    fprintf(jsonFile, "  \"generation_seconds\": %.6f,\n", genStopWatch.RealTime());
+    fprintf(jsonFile, "  \"processing_seconds\": %.6f,\n", procStopWatch.RealTime());
+    fprintf(jsonFile, "  \"processing_cpu_seconds\": %.6f,\n", procStopWatch.CpuTime());
+    fprintf(jsonFile, "  \"events_per_second\": %.3f,\n", procStopWatch.RealTime() > 0.0 ? eventCounter / procStopWatch.RealTime() : 0.0);
+    fprintf(jsonFile, "  \"peak_rss_mb\": %.3f,\n", GetPeakRSS());
+    fprintf(jsonFile, "  \"pool_peak_mb\": %.3f,\n", factory->GetPeakBytes() / 1048576.0);
+    fprintf(jsonFile, "  \"allocations\": %lld,\n", allocations);
+    fprintf(jsonFile, "  \"allocated_mb\": %.3f,\n", bytes / 1048576.0);
+    fprintf(jsonFile, "  \"allocations_per_event\": %.3f,\n", eventCounter > 0 ? Double_t(allocations) / eventCounter : 0.0);
+    fprintf(jsonFile, "  \"modules\": [");
+
+    TIter itTasks(modularDelphes->GetListOfTasks());
+    i = 0;
+    while((task = static_cast<ExRootTask *>(itTasks.Next())))
+    {
+      fprintf(jsonFile, "%s\n    {\"name\": \"%s\", \"class\": \"%s\", \"calls\": %lld, \"seconds\": %.6f, \"ms_per_event\": %.6f}",
+        i++ > 0 ? "," : "", task->GetName(), task->IsA()->GetName(), task->GetProcessCalls(), task->GetProcessTime(),
+        eventCounter > 0 ? task->GetProcessTime() * 1000.0 / eventCounter : 0.0);
+    }
+
+    fprintf(jsonFile, "\n  ]\n}\n");
+
+    fclose(jsonFile);
+
+    cout << "** Benchmark results written to " << jsonName << endl;
+    cout << "** Exiting..." << endl;
+
+    delete modularDelphes;
+    delete generator;
+    delete confReader;
+    delete treeWriter;
+    delete outputFile;
+
+    return 0;
+  }
+  catch(runtime_error &e)
+  {
+    if(treeWriter) delete treeWriter;
+    if(outputFile) delete outputFile;
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
@@ -408,16 +408,18 @@ int main(int argc, char *argv[])
         if(eventCounter >= skipEvents){
           ConvertInput(event, eventCounter, branchEvent, branchWeight, factory,
             allParticleOutputArray, stableParticleOutputArray, partonOutputArray, firstEvent);
+          modularDelphes->SetEventNumber(eventCounter, i - 3);
           modularDelphes->ProcessTask();
 
           firstEvent = kFALSE;
 
-          treeWriter->Fill();
+          if(modularDelphes->IsEventAccepted()) treeWriter->Fill();
 
           modularDelphes->Clear();
           treeWriter->Clear();
         }
 
+        progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
         progressBar.Update(eventCounter, eventCounter);
         ++eventCounter;
       }
@@ -0,0 +1,323 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "TApplication.h"
+#include "TROOT.h"
+
+#include "TFile.h"
+#include "TFolder.h"
+#include "TList.h"
+#include "TObjArray.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+#include "classes/DelphesCheckpointReader.h"
+#include "classes/DelphesClasses.h"
+#include "classes/DelphesFactory.h"
+#include "classes/DelphesModule.h"
+#include "modules/Delphes.h"
+
+#include "ExRootAnalysis/ExRootConfReader.h"
+#include "ExRootAnalysis/ExRootProgressBar.h"
+#include "ExRootAnalysis/ExRootTreeBranch.h"
+#include "ExRootAnalysis/ExRootTreeWriter.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+static bool interrupted = false;
+
+void SignalHandler(int sig)
+{
+  interrupted = true;
+}
+
+//---------------------------------------------------------------------------
+
+// array "Module/array" exported by a stand-in for the module that produced
+// it before the checkpoint, or by Delphes itself for the generator arrays
+TObjArray *NewCheckpointArray(Delphes *modularDelphes, map<TString, DelphesModule *> &sources, const char *path)
+{
+  stringstream message;
+  DelphesModule *source;
+  TFolder *folder;
+  TString module = path, name;
+  Ssiz_t slash = module.First('/');
+
+  if(slash <= 0)
+  {
+    message << "checkpoint array '" << path << "' is not of the form Module/array";
+    throw runtime_error(message.str());
+  }
+
+  name = module(slash + 1, module.Length());
+  module.Remove(slash);
+
+  if(module == modularDelphes->GetName()) return modularDelphes->ExportArray(name);
+
+  source = sources[module];
+  if(!source)
+  {
+    // folder shared by all modules, registered by Delphes with the browsables
+    folder = static_cast<TFolder *>(gROOT->GetListOfBrowsables()->FindObject(modularDelphes->GetName()));
+
+    source = new DelphesModule;
+    source->SetName(module);
+    source->SetFolder(folder);
+    sources[module] = source;
+  }
+
+  return source->ExportArray(name);
+}
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "DelphesCheckpoint";
+  stringstream message;
+  TFile *outputFile = 0;
+  TStopwatch readStopWatch, procStopWatch;
+  ExRootTreeWriter *treeWriter = 0;
+  ExRootTreeBranch *branchEvent = 0;
+  ExRootConfReader *confReader = 0;
+  DelphesCheckpointReader *checkpointReader = 0;
+  Delphes *modularDelphes = 0;
+  DelphesFactory *factory = 0;
+  Event *element;
+  map<TString, DelphesModule *> sources;
+  map<TString, DelphesModule *>::iterator itSources;
+  map<TString, TObjArray *> arrays;
+  map<TString, TObjArray *>::iterator itArrays;
+  vector<TString> arrayNames;
+  ExRootConfParam param;
+  TString moduleName, executionPath;
+  Int_t i, j, size, processes, worker;
+  Long64_t eventCounter, numberOfEvents, firstEntry, lastEntry, entry;
+
+  if(argc < 4)
+  {
+    cout << " Usage: " << appName << " config_file"
+         << " output_file"
+         << " checkpoint_file(s)" << endl;
+    cout << " config_file - configuration file in Tcl format," << endl;
+    cout << " output_file - output file in ROOT format," << endl;
+    cout << " checkpoint_file(s) - file(s) written by a Checkpoint module of config_file." << endl;
+    return 1;
+  }
+
+  signal(SIGINT, SignalHandler);
+
+  gROOT->SetBatch();
+
+  int appargc = 1;
+  char *appargv[] = {appName};
+  TApplication app(appName, &appargc, appargv);
+
+  try
+  {
+    // the first checkpoint file tells where ExecutionPath is resumed
+    // and which arrays are exported, it is opened again after the fork
+    checkpointReader = new DelphesCheckpointReader(argv[3]);
+    moduleName = checkpointReader->GetModuleName();
+    for(j = 0; j < checkpointReader->GetNumberOfArrays(); ++j)
+    {
+      arrayNames.push_back(checkpointReader->GetArrayName(j));
+    }
+    delete checkpointReader;
+    checkpointReader = 0;
+
+    outputFile = TFile::Open(argv[2], "CREATE");
+
+    if(outputFile == NULL)
+    {
+      message << "can't open " << argv[2] << endl;
+      throw runtime_error(message.str());
+    }
+
+    treeWriter = new ExRootTreeWriter(outputFile, "Delphes");
+
+    branchEvent = treeWriter->NewBranch("Event", Event::Class());
+
+    confReader = new ExRootConfReader;
+    confReader->ReadFile(argv[1]);
+
+    // run only the modules after the checkpoint
+    param = confReader->GetParam("::ExecutionPath");
+    size = param.GetSize();
+    for(i = 0; i < size; ++i)
+    {
+      if(moduleName == param[i].GetString()) break;
+    }
+
+    if(i == size)
+    {
+      message << "module '" << moduleName << "' that wrote " << argv[3];
+      message << " is not in ExecutionPath of " << argv[1];
+      throw runtime_error(message.str());
+    }
+
+    for(++i; i < size; ++i)
+    {
+      executionPath += param[i].GetString();
+      executionPath += " ";
+    }
+    confReader->SetParam("::ExecutionPath", executionPath);
+
+    modularDelphes = new Delphes("Delphes");
+    modularDelphes->SetConfReader(confReader);
+    modularDelphes->SetTreeWriter(treeWriter);
+
+    factory = modularDelphes->GetFactory();
+
+    for(j = 0; j < Int_t(arrayNames.size()); ++j)
+    {
+      arrays[arrayNames[j]] = NewCheckpointArray(modularDelphes, sources, arrayNames[j]);
+    }
+
+    modularDelphes->InitTask();
+
+    worker = modularDelphes->ForkProcesses();
+    processes = modularDelphes->GetNumberOfProcesses();
+
+    for(i = 3; i < argc && !interrupted && worker >= 0; ++i)
+    {
+      if(worker == 0) cout << "** Reading " << argv[i] << endl;
+
+      checkpointReader = new DelphesCheckpointReader(argv[i]);
+      if(moduleName != checkpointReader->GetModuleName())
+      {
+        message << argv[i] << " was written by module '" << checkpointReader->GetModuleName();
+        message << "' instead of '" << moduleName << "'";
+        throw runtime_error(message.str());
+      }
+
+      // arrays missing from the first file are not exported and are skipped,
+      // arrays missing from this file stay empty
+      for(j = 0; j < checkpointReader->GetNumberOfArrays(); ++j)
+      {
+        itArrays = arrays.find(checkpointReader->GetArrayName(j));
+        checkpointReader->SetArray(j, itArrays != arrays.end() ? itArrays->second : 0);
+      }
+
+      numberOfEvents = checkpointReader->GetEntries();
+
+      if(numberOfEvents <= 0)
+      {
+        delete checkpointReader;
+        checkpointReader = 0;
+        continue;
+      }
+
+      // each worker process takes a contiguous range of entries
+      firstEntry = numberOfEvents * worker / processes;
+      lastEntry = numberOfEvents * (worker + 1) / processes;
+
+      ExRootProgressBar progressBar(lastEntry - firstEntry - 1);
+
+      // Loop over all objects
+      eventCounter = 0;
+      modularDelphes->Clear();
+      treeWriter->Clear();
+      for(entry = firstEntry; entry < lastEntry && !interrupted; ++entry)
+      {
+        readStopWatch.Start();
+        checkpointReader->ReadEntry(entry, factory);
+        readStopWatch.Stop();
+
+        // same random streams as in the run that wrote the checkpoint
+        modularDelphes->SetEventNumber(checkpointReader->GetEventNumber(), checkpointReader->GetInputNumber());
+
+        procStopWatch.Start();
+        modularDelphes->ProcessTask();
+        procStopWatch.Stop();
+
+        if(modularDelphes->IsEventAccepted())
+        {
+          element = static_cast<Event *>(branchEvent->NewEntry());
+          element->Number = checkpointReader->GetEventNumber();
+          element->ReadTime = readStopWatch.RealTime();
+          element->ProcTime = procStopWatch.RealTime();
+
+          treeWriter->Fill();
+        }
+
+        modularDelphes->Clear();
+        treeWriter->Clear();
+
+        if(worker == 0)
+        {
+          progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
+          progressBar.Update(eventCounter, eventCounter);
+        }
+        ++eventCounter;
+      }
+
+      if(worker == 0)
+      {
+        progressBar.Update(eventCounter, eventCounter, kTRUE);
+        progressBar.Finish();
+      }
+
+      delete checkpointReader;
+      checkpointReader = 0;
+    }
+
+    if(worker >= 0)
+    {
+      modularDelphes->FinishTask();
+      treeWriter->Write();
+    }
+
+    modularDelphes->ExitProcess(0);
+
+    cout << "** Exiting..." << endl;
+
+    for(itSources = sources.begin(); itSources != sources.end(); ++itSources)
+    {
+      delete itSources->second;
+    }
+
+    delete modularDelphes;
+    delete confReader;
+    delete treeWriter;
+    delete outputFile;
+
+    return 0;
+  }
+  catch(runtime_error &e)
+  {
+    cerr << "** ERROR: " << e.what() << endl;
+    if(modularDelphes) modularDelphes->ExitProcess(1);
+    if(checkpointReader) delete checkpointReader;
+    if(treeWriter) delete treeWriter;
+    if(outputFile) delete outputFile;
+    return 1;
+  }
+}
@@ -19,6 +19,8 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <signal.h>
 
@@ -28,16 +30,19 @@
 #include "TDatabasePDG.h"
 #include "TFile.h"
 #include "TLorentzVector.h"
+#include "TMath.h"
 #include "TObjArray.h"
 #include "TParticlePDG.h"
 #include "TStopwatch.h"
 
 #include "classes/DelphesClasses.h"
+#include "classes/DelphesEventIndex.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesHepMC2Reader.h"
 #include "modules/Delphes.h"
 
 #include "ExRootAnalysis/ExRootProgressBar.h"
+#include "ExRootAnalysis/ExRootTimeline.h"
 #include "ExRootAnalysis/ExRootTreeBranch.h"
 #include "ExRootAnalysis/ExRootTreeWriter.h"
 
@@ -54,30 +59,57 @@ void SignalHandler(int sig)
 
 //---------------------------------------------------------------------------
 
+static vector<TString> SplitList(const char *list)
+{
+  vector<TString> items;
+  TString buffer = list, item;
+  Ssiz_t from = 0;
+
+  while(buffer.Tokenize(item, from, ","))
+  {
+    if(item.Length() > 0) items.push_back(item);
+  }
+
+  return items;
+}
+
+//---------------------------------------------------------------------------
+
 int main(int argc, char *argv[])
 {
   char appName[] = "DelphesHepMC2";
   stringstream message;
   FILE *inputFile = 0;
-  TFile *outputFile = 0;
   TStopwatch readStopWatch, procStopWatch;
-  ExRootTreeWriter *treeWriter = 0;
-  ExRootTreeBranch *branchEvent = 0, *branchWeight = 0;
+  vector<TString> configNames, outputNames;
+  vector<TFile *> outputFiles;
+  vector<ExRootTreeWriter *> treeWriters;
+  vector<ExRootTreeBranch *> branchEvents, branchWeights;
+  vector<ExRootConfReader *> confReaders;
+  vector<Delphes *> cards;
   ExRootConfReader *confReader = 0;
   Delphes *modularDelphes = 0;
   DelphesFactory *factory = 0;
   TObjArray *stableParticleOutputArray = 0, *allParticleOutputArray = 0, *partonOutputArray = 0;
   DelphesHepMC2Reader *reader = 0;
-  Int_t i, maxEvents, skipEvents;
-  Long64_t length, eventCounter;
+  ExRootTimeline *timeline = 0;
+  Double_t readStart;
+  DelphesEventIndex eventIndex(DelphesEventIndex::kHepMC);
+  string indexName;
+  Bool_t useEventIndex, hasEventIndex;
+  Int_t i, k, maxEvents, skipEvents, processes, worker, commonModules;
+  Long64_t memoryUsage;
+  Long64_t length, eventCounter, firstEvent, lastEvent, windowBegin, windowEnd;
+  Long64_t rangeBegin, rangeEnd, firstOffset, startOffset, stopOffset;
+  Long64_t fileSkipEvents, fileMaxEvents;
 
   if(argc < 3)
   {
-    cout << " Usage: " << appName << " config_file"
-         << " output_file"
+    cout << " Usage: " << appName << " config_file[,config_file...]"
+         << " output_file[,output_file...]"
          << " [input_file(s)]" << endl;
     cout << " config_file - configuration file in Tcl format," << endl;
-    cout << " output_file - output file in ROOT format," << endl;
+    cout << " output_file - output file in ROOT format, one for each configuration file," << endl;
     cout << " input_file(s) - input file(s) in HepMC format," << endl;
     cout << " with no input_file, or when input_file is -, read standard input." << endl;
     return 1;
@@ -93,21 +125,36 @@ int main(int argc, char *argv[])
 
   try
   {
-    outputFile = TFile::Open(argv[2], "CREATE");
+    configNames = SplitList(argv[1]);
+    outputNames = SplitList(argv[2]);
 
-    if(outputFile == NULL)
+    if(configNames.empty() || configNames.size() != outputNames.size())
     {
-      message << "can't create output file " << argv[2];
-      throw runtime_error(message.str());
+      throw runtime_error("each configuration file needs one output file");
     }
 
-    treeWriter = new ExRootTreeWriter(outputFile, "Delphes");
+    // the input is parsed once for all configuration files
+    for(k = 0; k < Int_t(configNames.size()); ++k)
+    {
+      outputFiles.push_back(TFile::Open(outputNames[k], "CREATE"));
 
-    branchEvent = treeWriter->NewBranch("Event", HepMCEvent::Class());
-    branchWeight = treeWriter->NewBranch("Weight", Weight::Class());
+      if(outputFiles.back() == NULL)
+      {
+        message << "can't create output file " << outputNames[k];
+        throw runtime_error(message.str());
+      }
 
-    confReader = new ExRootConfReader;
-    confReader->ReadFile(argv[1]);
+      treeWriters.push_back(new ExRootTreeWriter(outputFiles.back(), "Delphes"));
+
+      branchEvents.push_back(treeWriters.back()->NewBranch("Event", HepMCEvent::Class()));
+      branchWeights.push_back(treeWriters.back()->NewBranch("Weight", Weight::Class()));
+
+      confReaders.push_back(new ExRootConfReader);
+      confReaders.back()->ReadFile(configNames[k]);
+    }
+
+    // global parameters are taken from the first configuration file
+    confReader = confReaders.front();
 
     maxEvents = confReader->GetInt("::MaxEvents", 0);
     skipEvents = confReader->GetInt("::SkipEvents", 0);
@@ -122,9 +169,85 @@ int main(int argc, char *argv[])
       throw runtime_error("SkipEvents must be zero or positive");
     }
 
-    modularDelphes = new Delphes("Delphes");
-    modularDelphes->SetConfReader(confReader);
-    modularDelphes->SetTreeWriter(treeWriter);
+    useEventIndex = confReader->GetBool("::EventIndex", kFALSE);
+    rangeBegin = confReader->GetLong("::ByteRangeBegin", 0);
+    rangeEnd = confReader->GetLong("::ByteRangeEnd", 0);
+
+    if(rangeBegin < 0 || rangeEnd < 0 || (rangeEnd > 0 && rangeEnd <= rangeBegin))
+    {
+      throw runtime_error("ByteRangeBegin and ByteRangeEnd must define a non-empty range");
+    }
+
+    // worker processes split the events of each input file
+    // and need the event index to find and number them
+    processes = confReader->GetInt("::NumberOfProcesses", 1);
+    if(processes > 1 && confReaders.size() > 1)
+    {
+      throw runtime_error("NumberOfProcesses can't be used with several configuration files");
+    }
+
+    if(processes > 1)
+    {
+      if(argc == 3)
+      {
+        throw runtime_error("NumberOfProcesses can't be used with standard input");
+      }
+
+      useEventIndex = kTRUE;
+
+      for(i = 3; i < argc; ++i)
+      {
+        if(strncmp(argv[i], "-", 2) == 0)
+        {
+          throw runtime_error("NumberOfProcesses can't be used with standard input");
+        }
+
+        inputFile = fopen(argv[i], "r");
+
+        if(inputFile == NULL)
+        {
+          message << "can't open " << argv[i];
+          throw runtime_error(message.str());
+        }
+
+        fseek(inputFile, 0L, SEEK_END);
+        length = ftello(inputFile);
+        fseek(inputFile, 0L, SEEK_SET);
+
+        indexName = DelphesEventIndex::GetIndexName(argv[i]);
+        if(length > 0 && !eventIndex.Read(indexName.c_str(), length))
+        {
+          cout << "** Building event index " << indexName << endl;
+          eventIndex.Build(inputFile);
+          eventIndex.Write(indexName.c_str(), length);
+        }
+
+        fclose(inputFile);
+      }
+    }
+
+    for(k = 0; k < Int_t(confReaders.size()); ++k)
+    {
+      cards.push_back(new Delphes("Delphes"));
+      cards.back()->SetConfReader(confReaders[k]);
+      cards.back()->SetTreeWriter(treeWriters[k]);
+    }
+
+    // with several configuration files, the modules they have in common
+    // run once in a source instance that feeds all the others
+    if(cards.size() > 1)
+    {
+      commonModules = Delphes::GetCommonModules(confReaders);
+      cout << "** " << commonModules << " modules shared by " << cards.size() << " configurations" << endl;
+
+      modularDelphes = new Delphes("Delphes");
+      modularDelphes->SetConfReader(confReader);
+      modularDelphes->SetNumberOfModules(commonModules);
+    }
+    else
+    {
+      modularDelphes = cards.front();
+    }
 
     factory = modularDelphes->GetFactory();
     allParticleOutputArray = modularDelphes->ExportArray("allParticles");
@@ -135,10 +258,20 @@ int main(int argc, char *argv[])
 
     modularDelphes->InitTask();
 
+    for(k = 0; k < Int_t(cards.size()) && cards[k] != modularDelphes; ++k)
+    {
+      cards[k]->SetSource(modularDelphes);
+      cards[k]->InitTask();
+    }
+
+    worker = modularDelphes->ForkProcesses();
+
+    timeline = ExRootTimeline::GetTimeline();
+
     i = 3;
     do
     {
-      if(interrupted) break;
+      if(interrupted || worker < 0) break;
 
       if(i == argc || strncmp(argv[i], "-", 2) == 0)
       {
@@ -148,7 +281,7 @@ int main(int argc, char *argv[])
       }
       else
       {
-        cout << "** Reading " << argv[i] << endl;
+        if(worker == 0) cout << "** Reading " << argv[i] << endl;
         inputFile = fopen(argv[i], "r");
 
         if(inputFile == NULL)
@@ -173,13 +306,91 @@ int main(int argc, char *argv[])
 
       ExRootProgressBar progressBar(length);
 
-      // Loop over all objects
       eventCounter = 0;
-      treeWriter->Clear();
+      firstEvent = 0;
+      stopOffset = -1;
+      fileSkipEvents = skipEvents;
+      fileMaxEvents = maxEvents;
+
+      // Jump to the first event to process instead of parsing the skipped ones
+      if(inputFile != stdin && (useEventIndex || rangeBegin > 0 || rangeEnd > 0))
+      {
+        indexName = DelphesEventIndex::GetIndexName(argv[i]);
+        hasEventIndex = eventIndex.Read(indexName.c_str(), length);
+        if(!hasEventIndex && useEventIndex)
+        {
+          cout << "** Building event index " << indexName << endl;
+          eventIndex.Build(inputFile);
+          eventIndex.Write(indexName.c_str(), length);
+          hasEventIndex = kTRUE;
+        }
+
+        // Parse the header lines in front of the first event
+        if(hasEventIndex)
+        {
+          firstOffset = eventIndex.GetEntries() > 0 ? eventIndex.GetOffset(0) : length;
+        }
+        else
+        {
+          firstOffset = eventIndex.FindBoundary(inputFile, 0);
+        }
+        fseeko(inputFile, 0, SEEK_SET);
+        while(ftello(inputFile) < firstOffset && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray)) continue;
+
+        if(processes > 1)
+        {
+          // The events selected by the byte range, SkipEvents and MaxEvents
+          // form one window, split into equal shares of the workers
+          windowEnd = rangeEnd > 0 ? eventIndex.FindEntry(rangeEnd) : eventIndex.GetEntries();
+          windowBegin = Long64_t(eventIndex.FindEntry(TMath::Max(rangeBegin, firstOffset))) + skipEvents;
+          windowBegin = TMath::Min(windowBegin, windowEnd);
+          if(maxEvents > 0) windowEnd = TMath::Min(windowEnd, windowBegin + maxEvents);
+
+          firstEvent = windowBegin + (windowEnd - windowBegin) * worker / processes;
+          lastEvent = windowBegin + (windowEnd - windowBegin) * (worker + 1) / processes;
+
+          startOffset = firstEvent < eventIndex.GetEntries() ? eventIndex.GetOffset(firstEvent) : length;
+          if(lastEvent < eventIndex.GetEntries()) stopOffset = eventIndex.GetOffset(lastEvent);
+
+          eventCounter = firstEvent;
+          fileSkipEvents = 0;
+          fileMaxEvents = 0;
+        }
+        else if(rangeBegin > 0 || rangeEnd > 0)
+        {
+          // Events belong to the byte range in which their first line starts
+          startOffset = eventIndex.FindBoundary(inputFile, TMath::Max(rangeBegin, firstOffset));
+          if(rangeEnd > 0) stopOffset = eventIndex.FindBoundary(inputFile, rangeEnd);
+          if(hasEventIndex)
+          {
+            firstEvent = eventIndex.FindEntry(startOffset);
+          }
+          else
+          {
+            cout << "** WARNING: no event index, event numbers are counted from byte " << startOffset << endl;
+          }
+          eventCounter = firstEvent;
+        }
+        else
+        {
+          eventCounter = TMath::Min(Long64_t(skipEvents), Long64_t(eventIndex.GetEntries()));
+          startOffset = eventCounter < eventIndex.GetEntries() ? eventIndex.GetOffset(eventCounter) : length;
+        }
+
+        fseeko(inputFile, startOffset, SEEK_SET);
+      }
+
+      // Loop over all objects
+      for(k = 0; k < Int_t(cards.size()); ++k)
+      {
+        treeWriters[k]->Clear();
+        cards[k]->Clear();
+      }
       modularDelphes->Clear();
       reader->Clear();
       readStopWatch.Start();
-      while((maxEvents <= 0 || eventCounter - skipEvents < maxEvents) && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray) && !interrupted)
+      readStart = timeline ? timeline->Now() : 0.0;
+      while((fileMaxEvents <= 0 || eventCounter - firstEvent - fileSkipEvents < fileMaxEvents) && (stopOffset < 0 || ftello(inputFile) < stopOffset) && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray) && !interrupted)
       {
         if(reader->EventReady())
         {
@@ -187,55 +398,117 @@ int main(int argc, char *argv[])
 
           readStopWatch.Stop();
 
-          if(eventCounter > skipEvents)
+          if(eventCounter - firstEvent > fileSkipEvents)
           {
+            if(timeline && timeline->IsSampled(eventCounter - 1))
+            {
+              timeline->AddSpan("ReadBlock", "reader", readStart, timeline->Now(), eventCounter - 1,
+                Form("\"particles\":%d", allParticleOutputArray->GetEntriesFast()));
+            }
+
             procStopWatch.Start();
+            modularDelphes->SetEventNumber(eventCounter - 1, i - 3);
             modularDelphes->ProcessTask();
+            for(k = 0; k < Int_t(cards.size()) && cards[k] != modularDelphes && modularDelphes->IsEventAccepted(); ++k)
+            {
+              cards[k]->SetEventNumber(eventCounter - 1, i - 3);
+              cards[k]->ProcessTask();
+            }
             procStopWatch.Stop();
 
-            reader->AnalyzeEvent(branchEvent, eventCounter, &readStopWatch, &procStopWatch);
-            reader->AnalyzeWeight(branchWeight);
+            // the objects of all configurations are cleared together,
+            // after they have all been written
+            for(k = 0; k < Int_t(cards.size()); ++k)
+            {
+              reader->AnalyzeEvent(branchEvents[k], eventCounter, &readStopWatch, &procStopWatch);
+              reader->AnalyzeWeight(branchWeights[k]);
 
-            treeWriter->Fill();
+              if(modularDelphes->IsEventAccepted() && cards[k]->IsEventAccepted()) treeWriters[k]->Fill();
 
-            treeWriter->Clear();
+              treeWriters[k]->Clear();
+            }
           }
 
+          for(k = 0; k < Int_t(cards.size()) && cards[k] != modularDelphes; ++k)
+          {
+            cards[k]->Clear();
+          }
           modularDelphes->Clear();
           reader->Clear();
 
           readStopWatch.Start();
+          if(timeline) readStart = timeline->Now();
+        }
+        if(worker == 0)
+        {
+          memoryUsage = modularDelphes->GetMemoryUsage();
+          for(k = 0; k < Int_t(cards.size()) && cards[k] != modularDelphes; ++k)
+          {
+            memoryUsage += cards[k]->GetMemoryUsage();
+          }
+          progressBar.SetMemoryUsage(memoryUsage);
+          progressBar.Update(ftello(inputFile), eventCounter);
         }
-        progressBar.Update(ftello(inputFile), eventCounter);
       }
 
-      fseek(inputFile, 0L, SEEK_END);
-      progressBar.Update(ftello(inputFile), eventCounter, kTRUE);
-      progressBar.Finish();
+      if(worker == 0)
+      {
+        fseek(inputFile, 0L, SEEK_END);
+        progressBar.Update(ftello(inputFile), eventCounter, kTRUE);
+        progressBar.Finish();
+      }
 
       if(inputFile != stdin) fclose(inputFile);
 
       ++i;
     } while(i < argc);
 
-    modularDelphes->FinishTask();
-    treeWriter->Write();
+    if(worker >= 0)
+    {
+      // in the reverse order of initialization
+      for(k = Int_t(cards.size()) - 1; k >= 0; --k)
+      {
+        if(cards[k] != modularDelphes) cards[k]->FinishTask();
+      }
+      modularDelphes->FinishTask();
+
+      for(k = 0; k < Int_t(cards.size()); ++k)
+      {
+        treeWriters[k]->Write();
+      }
+    }
+
+    modularDelphes->ExitProcess(0);
 
     cout << "** Exiting..." << endl;
 
     delete reader;
+    for(k = Int_t(cards.size()) - 1; k >= 0; --k)
+    {
+      if(cards[k] != modularDelphes) delete cards[k];
+    }
     delete modularDelphes;
-    delete confReader;
-    delete treeWriter;
-    delete outputFile;
+    for(k = 0; k < Int_t(confReaders.size()); ++k)
+    {
+      delete confReaders[k];
+      delete treeWriters[k];
+      delete outputFiles[k];
+    }
 
     return 0;
   }
   catch(runtime_error &e)
   {
-    if(treeWriter) delete treeWriter;
-    if(outputFile) delete outputFile;
     cerr << "** ERROR: " << e.what() << endl;
+    if(modularDelphes) modularDelphes->ExitProcess(1);
+    for(k = 0; k < Int_t(treeWriters.size()); ++k)
+    {
+      delete treeWriters[k];
+    }
+    for(k = 0; k < Int_t(outputFiles.size()); ++k)
+    {
+      if(outputFiles[k]) delete outputFiles[k];
+    }
     return 1;
   }
 }
@@ -19,6 +19,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include <signal.h>
 
@@ -28,16 +29,19 @@
 #include "TDatabasePDG.h"
 #include "TFile.h"
 #include "TLorentzVector.h"
+#include "TMath.h"
 #include "TObjArray.h"
 #include "TParticlePDG.h"
 #include "TStopwatch.h"
 
 #include "classes/DelphesClasses.h"
+#include "classes/DelphesEventIndex.h"
 #include "classes/DelphesFactory.h"
 #include "classes/DelphesLHEFReader.h"
 #include "modules/Delphes.h"
 
 #include "ExRootAnalysis/ExRootProgressBar.h"
+#include "ExRootAnalysis/ExRootTimeline.h"
 #include "ExRootAnalysis/ExRootTreeBranch.h"
 #include "ExRootAnalysis/ExRootTreeWriter.h"
 
@@ -68,8 +72,14 @@ int main(int argc, char *argv[])
   DelphesFactory *factory = 0;
   TObjArray *stableParticleOutputArray = 0, *allParticleOutputArray = 0, *partonOutputArray = 0;
   DelphesLHEFReader *reader = 0;
+  ExRootTimeline *timeline = 0;
+  Double_t readStart;
+  DelphesEventIndex eventIndex(DelphesEventIndex::kLHEF);
+  string indexName;
+  Bool_t useEventIndex, hasEventIndex;
   Int_t i, maxEvents, skipEvents;
-  Long64_t length, eventCounter;
+  Long64_t length, eventCounter, firstEvent;
+  Long64_t rangeBegin, rangeEnd, firstOffset, startOffset, stopOffset;
 
   if(argc < 3)
   {
@@ -122,6 +132,15 @@ int main(int argc, char *argv[])
       throw runtime_error("SkipEvents must be zero or positive");
     }
 
+    useEventIndex = confReader->GetBool("::EventIndex", kFALSE);
+    rangeBegin = confReader->GetLong("::ByteRangeBegin", 0);
+    rangeEnd = confReader->GetLong("::ByteRangeEnd", 0);
+
+    if(rangeBegin < 0 || rangeEnd < 0 || (rangeEnd > 0 && rangeEnd <= rangeBegin))
+    {
+      throw runtime_error("ByteRangeBegin and ByteRangeEnd must define a non-empty range");
+    }
+
     modularDelphes = new Delphes("Delphes");
     modularDelphes->SetConfReader(confReader);
     modularDelphes->SetTreeWriter(treeWriter);
@@ -135,6 +154,8 @@ int main(int argc, char *argv[])
 
     modularDelphes->InitTask();
 
+    timeline = ExRootTimeline::GetTimeline();
+
     i = 3;
     do
     {
@@ -173,13 +194,66 @@ int main(int argc, char *argv[])
 
       ExRootProgressBar progressBar(length);
 
-      // Loop over all objects
       eventCounter = 0;
+      firstEvent = 0;
+      stopOffset = -1;
+
+      // Jump to the first event to process instead of parsing the skipped ones
+      if(inputFile != stdin && (useEventIndex || rangeBegin > 0 || rangeEnd > 0))
+      {
+        indexName = DelphesEventIndex::GetIndexName(argv[i]);
+        hasEventIndex = eventIndex.Read(indexName.c_str(), length);
+        if(!hasEventIndex && useEventIndex)
+        {
+          cout << "** Building event index " << indexName << endl;
+          eventIndex.Build(inputFile);
+          eventIndex.Write(indexName.c_str(), length);
+          hasEventIndex = kTRUE;
+        }
+
+        // Parse the header lines in front of the first event
+        if(hasEventIndex)
+        {
+          firstOffset = eventIndex.GetEntries() > 0 ? eventIndex.GetOffset(0) : length;
+        }
+        else
+        {
+          firstOffset = eventIndex.FindBoundary(inputFile, 0);
+        }
+        fseeko(inputFile, 0, SEEK_SET);
+        while(ftello(inputFile) < firstOffset && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray)) continue;
+
+        if(rangeBegin > 0 || rangeEnd > 0)
+        {
+          // Events belong to the byte range in which their first line starts
+          startOffset = eventIndex.FindBoundary(inputFile, TMath::Max(rangeBegin, firstOffset));
+          if(rangeEnd > 0) stopOffset = eventIndex.FindBoundary(inputFile, rangeEnd);
+          if(hasEventIndex)
+          {
+            firstEvent = eventIndex.FindEntry(startOffset);
+          }
+          else
+          {
+            cout << "** WARNING: no event index, event numbers are counted from byte " << startOffset << endl;
+          }
+          eventCounter = firstEvent;
+        }
+        else
+        {
+          eventCounter = TMath::Min(Long64_t(skipEvents), Long64_t(eventIndex.GetEntries()));
+          startOffset = eventCounter < eventIndex.GetEntries() ? eventIndex.GetOffset(eventCounter) : length;
+        }
+
+        fseeko(inputFile, startOffset, SEEK_SET);
+      }
+
+      // Loop over all objects
       treeWriter->Clear();
       modularDelphes->Clear();
       reader->Clear();
       readStopWatch.Start();
-      while((maxEvents <= 0 || eventCounter - skipEvents < maxEvents) && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray) && !interrupted)
+      readStart = timeline ? timeline->Now() : 0.0;
+      while((maxEvents <= 0 || eventCounter - firstEvent - skipEvents < maxEvents) && (stopOffset < 0 || ftello(inputFile) < stopOffset) && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray) && !interrupted)
       {
         if(reader->EventReady())
         {
@@ -187,17 +261,24 @@ int main(int argc, char *argv[])
 
           readStopWatch.Stop();
 
-          if(eventCounter > skipEvents)
+          if(eventCounter - firstEvent > skipEvents)
           {
             readStopWatch.Stop();
+            if(timeline && timeline->IsSampled(eventCounter - 1))
+            {
+              timeline->AddSpan("ReadBlock", "reader", readStart, timeline->Now(), eventCounter - 1,
+                Form("\"particles\":%d", allParticleOutputArray->GetEntriesFast()));
+            }
+
             procStopWatch.Start();
+            modularDelphes->SetEventNumber(eventCounter - 1, i - 3);
             modularDelphes->ProcessTask();
             procStopWatch.Stop();
 
             reader->AnalyzeEvent(branchEvent, eventCounter, &readStopWatch, &procStopWatch);
             reader->AnalyzeWeight(branchWeight);
 
-            treeWriter->Fill();
+            if(modularDelphes->IsEventAccepted()) treeWriter->Fill();
 
             treeWriter->Clear();
           }
@@ -206,7 +287,9 @@ int main(int argc, char *argv[])
           reader->Clear();
 
           readStopWatch.Start();
+          if(timeline) readStart = timeline->Now();
         }
+        progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
         progressBar.Update(ftello(inputFile), eventCounter);
       }
 
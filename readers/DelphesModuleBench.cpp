@@ -0,0 +1,512 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TApplication.h"
+#include "TROOT.h"
+
+#include "TFolder.h"
+#include "TList.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TString.h"
+
+#include "classes/DelphesFactory.h"
+#include "classes/DelphesModule.h"
+#include "classes/DelphesSyntheticGenerator.h"
+#include "modules/Delphes.h"
+
+#include "ExRootAnalysis/ExRootConfReader.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+static bool interrupted = false;
+
+void SignalHandler(int sig)
+{
+  interrupted = true;
+}
+
+//---------------------------------------------------------------------------
+
+static bool GetOption(const char *argument, const char *name, const char *&value)
+{
+  size_t length = strlen(name);
+  if(strncmp(argument, "--", 2) != 0 || strncmp(argument + 2, name, length) != 0 || argument[length + 2] != '=') return false;
+  value = argument + length + 3;
+  return true;
+}
+
+//---------------------------------------------------------------------------
+
+struct InputArray
+{
+  TString name;
+  TObjArray *array;
+  Int_t size; // fixed multiplicity, or -1 to follow the sweep
+};
+
+struct SweepPoint
+{
+  Int_t size;
+  Long64_t iterations;
+  Double_t mean, minimum; // seconds per call
+  Double_t exponent; // local scaling exponent with respect to the previous point
+  TString arguments; // sizes of the imported and exported arrays
+};
+
+//---------------------------------------------------------------------------
+
+// array "Module/array" exported by a stand-in for the upstream module,
+// filled by the harness instead of the real producer
+TObjArray *NewInputArray(Delphes *modularDelphes, map<TString, DelphesModule *> &sources, const char *path)
+{
+  stringstream message;
+  DelphesModule *source;
+  TFolder *folder;
+  TString module = path, name;
+  Ssiz_t slash = module.First('/');
+
+  if(slash <= 0)
+  {
+    message << "input array '" << path << "' is not of the form Module/array";
+    throw runtime_error(message.str());
+  }
+
+  name = module(slash + 1, module.Length());
+  module.Remove(slash);
+
+  source = sources[module];
+  if(!source)
+  {
+    // folder shared by all modules, registered by Delphes with the browsables
+    folder = static_cast<TFolder *>(gROOT->GetListOfBrowsables()->FindObject(modularDelphes->GetName()));
+
+    source = new DelphesModule;
+    source->SetName(module);
+    source->SetFolder(folder);
+    sources[module] = source;
+  }
+
+  return source->ExportArray(name);
+}
+
+//---------------------------------------------------------------------------
+
+// least squares slope of log(time) against log(size)
+Double_t FitExponent(const vector<SweepPoint> &points, Int_t minSize)
+{
+  Double_t x, y, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+  Int_t n = 0;
+  size_t i;
+
+  for(i = 0; i < points.size(); ++i)
+  {
+    if(points[i].size < minSize || points[i].minimum <= 0.0) continue;
+    x = TMath::Log(points[i].size);
+    y = TMath::Log(points[i].minimum);
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+    ++n;
+  }
+
+  if(n < 2 || n * sxx - sx * sx <= 0.0) return 0.0;
+
+  return (n * sxy - sx * sy) / (n * sxx - sx * sx);
+}
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "DelphesModuleBench";
+  stringstream message;
+  FILE *jsonFile = 0;
+  ExRootConfReader *confReader = 0;
+  Delphes *modularDelphes = 0;
+  DelphesFactory *factory = 0;
+  DelphesModule *module = 0;
+  DelphesSyntheticGenerator *generator = 0;
+  const ExRootConfReader::ExRootTaskMap *modules;
+  ExRootConfReader::ExRootTaskMap::const_iterator itModules;
+  vector<TString> names;
+  vector<InputArray> inputs;
+  vector<SweepPoint> points;
+  map<TString, Int_t> fixedSizes;
+  map<TString, Int_t>::const_iterator itFixed;
+  map<TString, DelphesModule *> sources;
+  map<TString, DelphesModule *>::iterator itSources;
+  InputArray input;
+  SweepPoint point;
+  ExRootConfParam param;
+  const char *value;
+  TString moduleName, parameter, path, jsonName;
+  Int_t i, j, k, size, seed = 1, minSize = 10, maxSize = 100000, pointsPerDecade = 3, fitSize = 1000;
+  Long64_t iteration, eventCounter, minIterations = 3, maxIterations = 10000;
+  Double_t minTime = 0.2, maxCallTime = 5.0, maxExponent = 1.5, radius = 1290.0, halfLength = 3000.0;
+  Double_t time, total, minimum, exponent, nsMax;
+  Bool_t truncated = kFALSE, regression = kFALSE;
+
+  if(argc < 3)
+  {
+    cout << " Usage: " << appName << " config_file"
+         << " module_name"
+         << " [options]" << endl;
+    cout << " config_file - configuration file in Tcl format," << endl;
+    cout << " module_name - name of the module instance to benchmark," << endl;
+    cout << " options:" << endl;
+    cout << "  --min-size=N - smallest input multiplicity (default 10)," << endl;
+    cout << "  --max-size=N - largest input multiplicity (default 100000)," << endl;
+    cout << "  --points-per-decade=N - input multiplicities per factor of ten (default 3)," << endl;
+    cout << "  --min-time=X - minimum time spent in Process per point in seconds (default 0.2)," << endl;
+    cout << "  --min-iterations=N - minimum number of calls per point (default 3)," << endl;
+    cout << "  --max-iterations=N - maximum number of calls per point (default 10000)," << endl;
+    cout << "  --max-call-time=X - stop the sweep when a call takes longer, in seconds (default 5)," << endl;
+    cout << "  --fit-size=N - smallest multiplicity used to fit the scaling exponent (default 1000)," << endl;
+    cout << "  --max-exponent=X - scaling exponent reported as a regression (default 1.5)," << endl;
+    cout << "  --input=Module/array - input array not declared as *Input*Array parameter," << endl;
+    cout << "  --fixed=Parameter:N - fixed multiplicity of the array of an input parameter," << endl;
+    cout << "  --radius=X, --half-length=X - cylinder the candidates are propagated to, in mm" << endl;
+    cout << "    (default 1290 and 3000)," << endl;
+    cout << "  --seed=N - seed of the candidate generator (default 1)," << endl;
+    cout << "  --json=FILE - results in JSON format (default module_name.json)." << endl;
+    cout << " Exit status is 2 if the fitted scaling exponent exceeds --max-exponent." << endl;
+    return 1;
+  }
+
+  signal(SIGINT, SignalHandler);
+
+  gROOT->SetBatch();
+
+  int appargc = 1;
+  char *appargv[] = {appName};
+  TApplication app(appName, &appargc, appargv);
+
+  try
+  {
+    moduleName = argv[2];
+    jsonName = moduleName + ".json";
+
+    for(i = 3; i < argc; ++i)
+    {
+      if(GetOption(argv[i], "min-size", value))
+        minSize = atoi(value);
+      else if(GetOption(argv[i], "max-size", value))
+        maxSize = atoi(value);
+      else if(GetOption(argv[i], "points-per-decade", value))
+        pointsPerDecade = atoi(value);
+      else if(GetOption(argv[i], "min-time", value))
+        minTime = atof(value);
+      else if(GetOption(argv[i], "min-iterations", value))
+        minIterations = atoll(value);
+      else if(GetOption(argv[i], "max-iterations", value))
+        maxIterations = atoll(value);
+      else if(GetOption(argv[i], "max-call-time", value))
+        maxCallTime = atof(value);
+      else if(GetOption(argv[i], "fit-size", value))
+        fitSize = atoi(value);
+      else if(GetOption(argv[i], "max-exponent", value))
+        maxExponent = atof(value);
+      else if(GetOption(argv[i], "input", value))
+      {
+        input.name = value;
+        input.array = 0;
+        input.size = -1;
+        inputs.push_back(input);
+      }
+      else if(GetOption(argv[i], "fixed", value))
+      {
+        parameter = value;
+        k = parameter.Last(':');
+        if(k <= 0)
+        {
+          message << "option " << argv[i] << " is not of the form --fixed=Parameter:N";
+          throw runtime_error(message.str());
+        }
+        fixedSizes[parameter(0, k)] = atoi(parameter.Data() + k + 1);
+      }
+      else if(GetOption(argv[i], "radius", value))
+        radius = atof(value);
+      else if(GetOption(argv[i], "half-length", value))
+        halfLength = atof(value);
+      else if(GetOption(argv[i], "seed", value))
+        seed = atoi(value);
+      else if(GetOption(argv[i], "json", value))
+        jsonName = value;
+      else
+      {
+        message << "unknown option " << argv[i];
+        throw runtime_error(message.str());
+      }
+    }
+
+    if(minSize < 1 || maxSize < minSize || pointsPerDecade < 1)
+    {
+      message << "invalid range of input multiplicities";
+      throw runtime_error(message.str());
+    }
+
+    confReader = new ExRootConfReader;
+    confReader->ReadFile(argv[1]);
+
+    modules = confReader->GetModules();
+    itModules = modules->find(moduleName);
+    if(itModules == modules->end())
+    {
+      message << "module '" << moduleName << "' is not configured in " << argv[1];
+      throw runtime_error(message.str());
+    }
+
+    // run the module alone, sequentially and without pruning
+    confReader->SetParam("::ExecutionPath", moduleName);
+    confReader->SetParam("::PruneExecutionPath", "false");
+    confReader->SetParam("::ParallelExecution", "false");
+    confReader->SetParam("::TimelineFile", "");
+
+    // inputs are the arrays named by the *Input*Array parameters of the module
+    names = confReader->GetParamNames(moduleName);
+    for(j = 0; j < Int_t(names.size()); ++j)
+    {
+      if(!names[j].Contains("Input") || !names[j].EndsWith("Array")) continue;
+
+      param = confReader->GetParam(moduleName + "::" + names[j]);
+      for(k = 0; k < param.GetSize(); ++k)
+      {
+        path = param[k].GetString();
+        if(!path.Contains("/")) continue;
+
+        itFixed = fixedSizes.find(names[j]);
+
+        input.name = path;
+        input.array = 0;
+        input.size = itFixed != fixedSizes.end() ? itFixed->second : -1;
+        inputs.push_back(input);
+      }
+    }
+
+    if(inputs.empty())
+    {
+      message << "module '" << moduleName << "' has no input arrays, use --input=Module/array";
+      throw runtime_error(message.str());
+    }
+
+    modularDelphes = new Delphes("Delphes");
+    modularDelphes->SetConfReader(confReader);
+
+    factory = modularDelphes->GetFactory();
+
+    // several parameters may name the same array, it is filled once
+    for(j = 0; j < Int_t(inputs.size()); ++j)
+    {
+      for(k = 0; k < j; ++k)
+      {
+        if(inputs[k].name == inputs[j].name) break;
+      }
+      inputs[j].array = k < j ? 0 : NewInputArray(modularDelphes, sources, inputs[j].name);
+    }
+
+    ExRootTask::SetTiming(kTRUE);
+
+    modularDelphes->InitTask();
+
+    module = static_cast<DelphesModule *>(modularDelphes->GetListOfTasks()->FindObject(moduleName));
+    if(!module)
+    {
+      message << "can't create module '" << moduleName << "'";
+      throw runtime_error(message.str());
+    }
+
+    cout << "** Benchmarking " << moduleName << " (" << itModules->second << ") with inputs:" << endl;
+    for(j = 0; j < Int_t(inputs.size()); ++j)
+    {
+      if(!inputs[j].array) continue;
+      cout << "**   " << inputs[j].name;
+      if(inputs[j].size >= 0) cout << " (fixed size " << inputs[j].size << ")";
+      cout << endl;
+    }
+
+    generator = new DelphesSyntheticGenerator(seed);
+
+    // sweep the input multiplicity on a logarithmic grid
+    eventCounter = 0;
+    for(i = 0; !interrupted && !truncated; ++i)
+    {
+      size = TMath::Nint(minSize * TMath::Power(10.0, Double_t(i) / pointsPerDecade));
+      if(size > maxSize) break;
+      if(!points.empty() && size <= points.back().size) continue;
+
+      point.size = size;
+      point.iterations = 0;
+      total = 0.0;
+      minimum = 0.0;
+
+      // the first call warms up caches and lazily built tables and is not counted
+      for(iteration = -1; !interrupted; ++iteration)
+      {
+        if(iteration >= minIterations && (total >= minTime || iteration >= maxIterations)) break;
+
+        modularDelphes->Clear();
+        generator->SetSeed(seed + iteration + 1);
+        for(j = 0; j < Int_t(inputs.size()); ++j)
+        {
+          if(!inputs[j].array) continue;
+          generator->GenerateCandidates(factory, inputs[j].array,
+            inputs[j].size >= 0 ? inputs[j].size : size, radius, halfLength);
+        }
+
+        time = module->GetProcessTime();
+        modularDelphes->SetEventNumber(eventCounter++);
+        modularDelphes->ProcessTask();
+        time = module->GetProcessTime() - time;
+
+        if(iteration < 0)
+        {
+          point.arguments = module->GetTraceArguments();
+        }
+        else
+        {
+          total += time;
+          if(iteration == 0 || time < minimum) minimum = time;
+          ++point.iterations;
+        }
+
+        if(time > maxCallTime)
+        {
+          truncated = kTRUE;
+          if(iteration >= 0) break;
+        }
+      }
+
+      if(point.iterations == 0) break;
+
+      point.mean = total / point.iterations;
+      point.minimum = minimum;
+      point.exponent = 0.0;
+      if(!points.empty() && points.back().minimum > 0.0 && minimum > 0.0)
+      {
+        point.exponent = TMath::Log(minimum / points.back().minimum) / TMath::Log(Double_t(size) / points.back().size);
+      }
+      points.push_back(point);
+    }
+
+    modularDelphes->FinishTask();
+
+    if(points.empty())
+    {
+      message << "no input multiplicity was benchmarked";
+      throw runtime_error(message.str());
+    }
+
+    exponent = FitExponent(points, fitSize);
+    if(exponent == 0.0) exponent = FitExponent(points, 0);
+    regression = exponent > maxExponent;
+
+    // time per input candidate: flat for linear modules, rising for O(N^2) loops
+    nsMax = 0.0;
+    for(j = 0; j < Int_t(points.size()); ++j)
+    {
+      nsMax = TMath::Max(nsMax, points[j].minimum * 1.0e9 / points[j].size);
+    }
+
+    cout << endl;
+    cout << "      Size    Calls    Mean/call     Min/call   ns/candidate  Exponent" << endl;
+    for(j = 0; j < Int_t(points.size()); ++j)
+    {
+      time = points[j].minimum * 1.0e9 / points[j].size;
+      printf("%10d %8lld %10.4f ms %10.4f ms %12.2f   %6s  ", points[j].size, points[j].iterations,
+        points[j].mean * 1.0e3, points[j].minimum * 1.0e3, time,
+        j > 0 ? Form("%6.2f", points[j].exponent) : "");
+      for(k = 0; nsMax > 0.0 && k < TMath::Nint(30.0 * time / nsMax); ++k) cout << "#";
+      cout << endl;
+    }
+    cout << endl;
+
+    printf("** %s scales as N^%.2f", moduleName.Data(), exponent);
+    if(truncated) printf(", sweep stopped after a call longer than %g s", maxCallTime);
+    printf("\n");
+
+    if(regression)
+    {
+      cout << "** WARNING: scaling exponent above " << maxExponent;
+      cout << ", look for loops over all pairs of input candidates" << endl;
+    }
+
+    // Write benchmark results
+    jsonFile = fopen(jsonName, "w");
+    if(jsonFile == NULL)
+    {
+      message << "can't create " << jsonName;
+      throw runtime_error(message.str());
+    }
+
+    fprintf(jsonFile, "{\n");
+    fprintf(jsonFile, "  \"card\": \"%s\",\n", argv[1]);
+    fprintf(jsonFile, "  \"module\": \"%s\",\n", moduleName.Data());
+    fprintf(jsonFile, "  \"class\": \"%s\",\n", itModules->second.Data());
+    fprintf(jsonFile, "  \"exponent\": %.4f,\n", exponent);
+    fprintf(jsonFile, "  \"max_exponent\": %g,\n", maxExponent);
+    fprintf(jsonFile, "  \"regression\": %s,\n", regression ? "true" : "false");
+    fprintf(jsonFile, "  \"truncated\": %s,\n", truncated ? "true" : "false");
+    fprintf(jsonFile, "  \"points\": [");
+
+    for(j = 0; j < Int_t(points.size()); ++j)
+    {
+      fprintf(jsonFile, "%s\n    {\"size\": %d, \"calls\": %lld, \"mean_seconds\": %.9f, \"min_seconds\": %.9f, \"ns_per_candidate\": %.3f, \"exponent\": %.4f, %s}",
+        j > 0 ? "," : "", points[j].size, points[j].iterations, points[j].mean, points[j].minimum,
+        points[j].minimum * 1.0e9 / points[j].size, points[j].exponent, points[j].arguments.Data());
+    }
+
+    fprintf(jsonFile, "\n  ]\n}\n");
+
+    fclose(jsonFile);
+
+    cout << "** Benchmark results written to " << jsonName << endl;
+    cout << "** Exiting..." << endl;
+
+    for(itSources = sources.begin(); itSources != sources.end(); ++itSources)
+    {
+      delete itSources->second;
+    }
+
+    delete generator;
+    delete modularDelphes;
+    delete confReader;
+
+    return regression ? 2 : 0;
+  }
+  catch(runtime_error &e)
+  {
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
@@ -277,12 +277,13 @@ int main(int argc, char *argv[])
         modularDelphes->ProcessTask();
         procStopWatch.Stop();
 
-        treeWriter->Fill();
+        if(modularDelphes->IsEventAccepted()) treeWriter->Fill();
 
         modularDelphes->Clear();
         treeWriter->Clear();
 
         readStopWatch.Start();
+        progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
         progressBar.Update(eventCounter);
       }
 
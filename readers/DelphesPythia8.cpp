@@ -236,6 +236,8 @@ int main(int argc, char *argv[])
   DelphesLHEFReader *reader = 0;
   Long64_t eventCounter, errorCounter;
   Long64_t numberOfEvents, timesAllowErrors;
+  Long64_t firstEvent, lastEvent, skipCounter;
+  Int_t processes, worker, seed;
   Bool_t spareFlag1;
   Int_t spareMode1;
   Double_t spareParm1, spareParm2;
@@ -347,6 +349,33 @@ int main(int argc, char *argv[])
 
     pythia->init();
 
+    worker = modularDelphes->ForkProcesses();
+    processes = modularDelphes->GetNumberOfProcesses();
+
+    // each worker process generates a contiguous range of events
+    // with its own random number sequence
+    firstEvent = numberOfEvents * TMath::Max(worker, 0) / processes;
+    lastEvent = worker < 0 ? 0 : numberOfEvents * (worker + 1) / processes;
+
+    if(processes > 1 && worker >= 0)
+    {
+      seed = pythia->flag("Random:setSeed") ? pythia->mode("Random:seed") : 19780503;
+      if(seed < 0) seed = 19780503;
+      pythia->rndm.init(seed + worker);
+
+      if(reader && firstEvent > 0)
+      {
+        pythia->LHAeventSkip(firstEvent);
+        for(skipCounter = 0; skipCounter < firstEvent; ++skipCounter)
+        {
+          while(reader->ReadBlock(factory, allParticleOutputArrayLHEF, stableParticleOutputArrayLHEF, partonOutputArrayLHEF) && !reader->EventReady())
+            ;
+          modularDelphes->Clear();
+          reader->Clear();
+        }
+      }
+    }
+
     // ExRootProgressBar progressBar(numberOfEvents - 1);
     ExRootProgressBar progressBar(-1);
 
@@ -355,7 +384,7 @@ int main(int argc, char *argv[])
     treeWriter->Clear();
     modularDelphes->Clear();
     readStopWatch.Start();
-    for(eventCounter = 0; eventCounter < numberOfEvents && !interrupted; ++eventCounter)
+    for(eventCounter = firstEvent; eventCounter < lastEvent && !interrupted; ++eventCounter)
     {
       while(reader && reader->ReadBlock(factory, allParticleOutputArrayLHEF, stableParticleOutputArrayLHEF, partonOutputArrayLHEF) && !reader->EventReady())
         ;
@@ -399,6 +428,7 @@ int main(int argc, char *argv[])
       ConvertInput(eventCounter, pythia, branchEvent, factory,
         allParticleOutputArray, stableParticleOutputArray, partonOutputArray,
         &readStopWatch, &procStopWatch);
+      modularDelphes->SetEventNumber(eventCounter);
       modularDelphes->ProcessTask();
       procStopWatch.Stop();
 
@@ -408,23 +438,35 @@ int main(int argc, char *argv[])
         reader->AnalyzeWeight(branchWeightLHEF);
       }
 
-      treeWriter->Fill();
+      if(modularDelphes->IsEventAccepted()) treeWriter->Fill();
 
       treeWriter->Clear();
       modularDelphes->Clear();
       if(reader) reader->Clear();
 
       readStopWatch.Start();
-      progressBar.Update(eventCounter, eventCounter);
+      if(worker == 0)
+      {
+        progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
+        progressBar.Update(eventCounter, eventCounter);
+      }
     }
 
-    progressBar.Update(eventCounter, eventCounter, kTRUE);
-    progressBar.Finish();
+    if(worker >= 0)
+    {
+      if(worker == 0)
+      {
+        progressBar.Update(eventCounter, eventCounter, kTRUE);
+        progressBar.Finish();
+      }
 
-    pythia->stat();
+      pythia->stat();
 
-    modularDelphes->FinishTask();
-    treeWriter->Write();
+      modularDelphes->FinishTask();
+      treeWriter->Write();
+    }
+
+    modularDelphes->ExitProcess(0);
 
     cout << "** Exiting..." << endl;
 
@@ -439,9 +481,10 @@ int main(int argc, char *argv[])
   }
   catch(runtime_error &e)
   {
+    cerr << "** ERROR: " << e.what() << endl;
+    if(modularDelphes) modularDelphes->ExitProcess(1);
     if(treeWriter) delete treeWriter;
     if(outputFile) delete outputFile;
-    cerr << "** ERROR: " << e.what() << endl;
     return 1;
   }
 }
@@ -85,8 +85,8 @@ int main(int argc, char *argv[])
   const Double_t c_light = 2.99792458E8;
 
   TObjArray *allParticleOutputArray = 0, *stableParticleOutputArray = 0, *partonOutputArray = 0;
-  Int_t i;
-  Long64_t eventCounter, numberOfEvents;
+  Int_t i, processes, worker;
+  Long64_t eventCounter, numberOfEvents, firstEntry, lastEntry;
 
   if(argc < 4)
   {
@@ -137,9 +137,12 @@ int main(int argc, char *argv[])
 
     modularDelphes->InitTask();
 
-    for(i = 3; i < argc && !interrupted; ++i)
+    worker = modularDelphes->ForkProcesses();
+    processes = modularDelphes->GetNumberOfProcesses();
+
+    for(i = 3; i < argc && !interrupted && worker >= 0; ++i)
     {
-      cout << "** Reading " << argv[i] << endl;
+      if(worker == 0) cout << "** Reading " << argv[i] << endl;
 
       chain->Add(argv[i]);
       ExRootTreeReader *treeReader = new ExRootTreeReader(chain);
@@ -158,14 +161,18 @@ int main(int argc, char *argv[])
 
       if(numberOfEvents <= 0) continue;
 
+      // each worker process takes a contiguous range of entries
+      firstEntry = numberOfEvents * worker / processes;
+      lastEntry = numberOfEvents * (worker + 1) / processes;
+
       // ExRootProgressBar progressBar(numberOfEvents - 1);
       ExRootProgressBar progressBar(-1);
 
       // Loop over all objects
-      eventCounter = 0;
+      eventCounter = firstEntry;
       modularDelphes->Clear();
       treeWriter->Clear();
-      for(Int_t entry = 0; entry < numberOfEvents && !interrupted; ++entry)
+      for(Long64_t entry = firstEntry; entry < lastEntry && !interrupted; ++entry)
       {
 
         treeReader->ReadEntry(entry);
@@ -230,27 +237,40 @@ int main(int argc, char *argv[])
           }
         }
 
+        modularDelphes->SetEventNumber(entry, i - 3);
         modularDelphes->ProcessTask();
 
-        treeWriter->Fill();
+        if(modularDelphes->IsEventAccepted()) treeWriter->Fill();
 
         modularDelphes->Clear();
         treeWriter->Clear();
 
-        progressBar.Update(eventCounter, eventCounter);
+        if(worker == 0)
+        {
+          progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
+          progressBar.Update(eventCounter, eventCounter);
+        }
         ++eventCounter;
       }
 
-      progressBar.Update(eventCounter, eventCounter, kTRUE);
-      progressBar.Finish();
+      if(worker == 0)
+      {
+        progressBar.Update(eventCounter, eventCounter, kTRUE);
+        progressBar.Finish();
+      }
 
       inputFile->Close();
 
       delete treeReader;
     }
 
-    modularDelphes->FinishTask();
-    treeWriter->Write();
+    if(worker >= 0)
+    {
+      modularDelphes->FinishTask();
+      treeWriter->Write();
+    }
+
+    modularDelphes->ExitProcess(0);
 
     cout << "** Exiting..." << endl;
 
@@ -264,9 +284,10 @@ int main(int argc, char *argv[])
   }
   catch(runtime_error &e)
   {
+    cerr << "** ERROR: " << e.what() << endl;
+    if(modularDelphes) modularDelphes->ExitProcess(1);
     if(treeWriter) delete treeWriter;
     if(outputFile) delete outputFile;
-    cerr << "** ERROR: " << e.what() << endl;
     return 1;
   }
 }
@@ -38,6 +38,7 @@
 #include "modules/Delphes.h"
 
 #include "ExRootAnalysis/ExRootProgressBar.h"
+#include "ExRootAnalysis/ExRootTimeline.h"
 #include "ExRootAnalysis/ExRootTreeBranch.h"
 #include "ExRootAnalysis/ExRootTreeWriter.h"
 
@@ -68,6 +69,8 @@ int main(int argc, char *argv[])
   DelphesFactory *factory = 0;
   TObjArray *stableParticleOutputArray = 0, *allParticleOutputArray = 0, *partonOutputArray = 0;
   DelphesSTDHEPReader *reader = 0;
+  ExRootTimeline *timeline = 0;
+  Double_t readStart;
   Int_t i, maxEvents, skipEvents;
   Long64_t length, eventCounter;
 
@@ -134,6 +137,8 @@ int main(int argc, char *argv[])
 
     modularDelphes->InitTask();
 
+    timeline = ExRootTimeline::GetTimeline();
+
     i = 3;
     do
     {
@@ -178,6 +183,7 @@ int main(int argc, char *argv[])
       modularDelphes->Clear();
       reader->Clear();
       readStopWatch.Start();
+      readStart = timeline ? timeline->Now() : 0.0;
       while((maxEvents <= 0 || eventCounter - skipEvents < maxEvents) && reader->ReadBlock(factory, allParticleOutputArray, stableParticleOutputArray, partonOutputArray) && !interrupted)
       {
         if(reader->EventReady())
@@ -188,13 +194,20 @@ int main(int argc, char *argv[])
 
           if(eventCounter > skipEvents)
           {
+            if(timeline && timeline->IsSampled(eventCounter - 1))
+            {
+              timeline->AddSpan("ReadBlock", "reader", readStart, timeline->Now(), eventCounter - 1,
+                Form("\"particles\":%d", allParticleOutputArray->GetEntriesFast()));
+            }
+
             procStopWatch.Start();
+            modularDelphes->SetEventNumber(eventCounter - 1, i - 3);
             modularDelphes->ProcessTask();
             procStopWatch.Stop();
 
             reader->AnalyzeEvent(branchEvent, eventCounter, &readStopWatch, &procStopWatch);
 
-            treeWriter->Fill();
+            if(modularDelphes->IsEventAccepted()) treeWriter->Fill();
 
             treeWriter->Clear();
           }
@@ -203,7 +216,9 @@ int main(int argc, char *argv[])
           reader->Clear();
 
           readStopWatch.Start();
+          if(timeline) readStart = timeline->Now();
         }
+        progressBar.SetMemoryUsage(modularDelphes->GetMemoryUsage());
         progressBar.Update(ftello(inputFile), eventCounter);
       }
 
@@ -0,0 +1,825 @@
+/*
+ *  Delphes: a framework for fast simulation of a generic collider experiment
+ *  Copyright (C) 2012-2014  Universite catholique de Louvain (UCL), Belgium
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fnmatch.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TApplication.h"
+#include "TROOT.h"
+
+#include "TBaseClass.h"
+#include "TBranch.h"
+#include "TChain.h"
+#include "TClass.h"
+#include "TClonesArray.h"
+#include "TDataMember.h"
+#include "TDataType.h"
+#include "TFile.h"
+#include "TH1D.h"
+#include "TList.h"
+#include "TMath.h"
+#include "TRef.h"
+#include "TRefArray.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+#include "classes/DelphesClasses.h"
+
+#include "ExRootAnalysis/ExRootProgressBar.h"
+#include "ExRootAnalysis/ExRootTreeReader.h"
+
+using namespace std;
+
+//---------------------------------------------------------------------------
+
+static bool interrupted = false;
+
+void SignalHandler(int sig)
+{
+  interrupted = true;
+}
+
+//---------------------------------------------------------------------------
+
+static bool GetOption(const char *argument, const char *name, const char *&value)
+{
+  size_t length = strlen(name);
+  if(strncmp(argument, "--", 2) != 0 || strncmp(argument + 2, name, length) != 0 || argument[length + 2] != '=') return false;
+  value = argument + length + 3;
+  return true;
+}
+
+//---------------------------------------------------------------------------
+
+enum FieldType
+{
+  kFieldInteger, // compared bit by bit
+  kFieldUnsigned,
+  kFieldFloat,
+  kFieldDouble,
+  kFieldRef,
+  kFieldRefArray
+};
+
+struct Field
+{
+  TString name; // Branch.Member, members of embedded objects as Branch.Member.fMember
+  Long_t offset;
+  Int_t type, size, count; // size of one element in bytes, number of elements
+  Double_t tolerance; // relative
+  Long64_t ulps;
+  Long64_t compared, differing, inexact;
+  Double_t maxRelative;
+  Long64_t maxUlps;
+  TH1D *histogram;
+};
+
+struct Branch
+{
+  TString name;
+  TClonesArray *arrays[2];
+  vector<Field> fields;
+  Long64_t sizeMismatches;
+};
+
+// per-event map from the unique identifiers stored in TRef to the branch and
+// index of the referenced objects; TRef::GetObject is not used as files
+// written by the same process would share their TProcessID tables
+typedef unordered_map<UInt_t, pair<Int_t, Int_t> > ObjectMap;
+
+// lower bits of TObject::fUniqueID holding the object number
+static const UInt_t kUniqueIDMask = 0xffffff;
+
+struct Tolerance
+{
+  TString pattern;
+  Double_t tolerance;
+  Long64_t ulps;
+};
+
+//---------------------------------------------------------------------------
+
+// flatten the persistent members of a class into fields, following base
+// classes and embedded objects, TObject members are not compared
+void AddFields(TClass *cl, const TString &prefix, Long_t offset, vector<Field> &fields)
+{
+  TBaseClass *base;
+  TDataMember *member;
+  TClass *memberClass;
+  Field field;
+  TString typeName;
+  Int_t i, count;
+
+  TIter itBases(cl->GetListOfBases());
+  while((base = static_cast<TBaseClass *>(itBases.Next())))
+  {
+    if(!base->GetClassPointer() || base->GetClassPointer() == TObject::Class()) continue;
+    AddFields(base->GetClassPointer(), prefix, offset + base->GetDelta(), fields);
+  }
+
+  TIter itMembers(cl->GetListOfDataMembers());
+  while((member = static_cast<TDataMember *>(itMembers.Next())))
+  {
+    if(!member->IsPersistent() || member->IsaPointer() || (member->Property() & kIsStatic)) continue;
+
+    count = 1;
+    for(i = 0; i < member->GetArrayDim(); ++i) count *= member->GetMaxIndex(i);
+
+    field.name = prefix + member->GetName();
+    field.offset = offset + member->GetOffset();
+    field.count = count;
+    field.size = member->GetUnitSize();
+    field.tolerance = 0.0;
+    field.ulps = 0;
+    field.compared = 0;
+    field.differing = 0;
+    field.inexact = 0;
+    field.maxRelative = 0.0;
+    field.maxUlps = 0;
+    field.histogram = 0;
+
+    typeName = member->GetTypeName();
+
+    if(member->IsBasic() || member->IsEnum())
+    {
+      switch(member->IsEnum() ? kInt_t : member->GetDataType()->GetType())
+      {
+        case kFloat_t:
+        case kFloat16_t:
+          field.type = kFieldFloat;
+          break;
+        case kDouble_t:
+        case kDouble32_t:
+          field.type = kFieldDouble;
+          break;
+        case kUChar_t:
+        case kUShort_t:
+        case kUInt_t:
+        case kULong_t:
+        case kULong64_t:
+        case kBool_t:
+          field.type = kFieldUnsigned;
+          break;
+        default:
+          field.type = kFieldInteger;
+      }
+      fields.push_back(field);
+    }
+    else if(typeName == "TRef")
+    {
+      field.type = kFieldRef;
+      fields.push_back(field);
+    }
+    else if(typeName == "TRefArray")
+    {
+      field.type = kFieldRefArray;
+      fields.push_back(field);
+    }
+    else if((memberClass = TClass::GetClass(typeName)))
+    {
+      for(i = 0; i < count; ++i)
+      {
+        AddFields(memberClass, count > 1 ? TString(Form("%s[%d].", field.name.Data(), i)) : field.name + ".",
+          field.offset + i * memberClass->Size(), fields);
+      }
+    }
+    else
+    {
+      cout << "** WARNING: member " << field.name << " of type " << typeName << " is not compared" << endl;
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+
+// distance in units in the last place, from the ordering of the bit patterns
+template <typename Real, typename Integer>
+Long64_t GetUlps(Real a, Real b)
+{
+  Integer ia, ib;
+  ULong64_t distance;
+
+  memcpy(&ia, &a, sizeof(Real));
+  memcpy(&ib, &b, sizeof(Real));
+
+  // negative numbers are stored as sign and magnitude, reverse their order
+  if(ia < 0) ia = numeric_limits<Integer>::min() - ia;
+  if(ib < 0) ib = numeric_limits<Integer>::min() - ib;
+
+  distance = ia > ib ? ULong64_t(ia) - ULong64_t(ib) : ULong64_t(ib) - ULong64_t(ia);
+
+  return distance > ULong64_t(numeric_limits<Long64_t>::max()) ? numeric_limits<Long64_t>::max() : Long64_t(distance);
+}
+
+//---------------------------------------------------------------------------
+
+Double_t GetInteger(const char *pointer, Int_t size, Bool_t isUnsigned)
+{
+  switch(size)
+  {
+    case 1:
+      return isUnsigned ? Double_t(*reinterpret_cast<const UChar_t *>(pointer)) : Double_t(*reinterpret_cast<const Char_t *>(pointer));
+    case 2:
+      return isUnsigned ? Double_t(*reinterpret_cast<const UShort_t *>(pointer)) : Double_t(*reinterpret_cast<const Short_t *>(pointer));
+    case 4:
+      return isUnsigned ? Double_t(*reinterpret_cast<const UInt_t *>(pointer)) : Double_t(*reinterpret_cast<const Int_t *>(pointer));
+    default:
+      return isUnsigned ? Double_t(*reinterpret_cast<const ULong64_t *>(pointer)) : Double_t(*reinterpret_cast<const Long64_t *>(pointer));
+  }
+}
+
+//---------------------------------------------------------------------------
+
+void BuildObjectMap(vector<Branch> &branches, Int_t file, ObjectMap &objects)
+{
+  TClonesArray *array;
+  TObject *object;
+  Int_t i, j;
+
+  objects.clear();
+  for(i = 0; i < Int_t(branches.size()); ++i)
+  {
+    array = branches[i].arrays[file];
+    for(j = 0; j < array->GetEntriesFast(); ++j)
+    {
+      object = array->UncheckedAt(j);
+      if(object->TestBit(TObject::kIsReferenced)) objects[object->GetUniqueID() & kUniqueIDMask] = make_pair(i, j);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+
+// branch and index of a referenced object, (-1, -1) if it is not in the event
+pair<Int_t, Int_t> FindObject(const ObjectMap &objects, UInt_t uid)
+{
+  ObjectMap::const_iterator itObjects;
+
+  if((uid & kUniqueIDMask) == 0) return make_pair(-1, -1);
+
+  itObjects = objects.find(uid & kUniqueIDMask);
+  return itObjects != objects.end() ? itObjects->second : make_pair(-1, -1);
+}
+
+//---------------------------------------------------------------------------
+
+// reads the entries of the second file while the main thread reads the first
+class EntryReader
+{
+public:
+  EntryReader(ExRootTreeReader *reader) :
+    fReader(reader), fRequested(-1), fDone(-1), fStop(false), fThread(&EntryReader::Run, this) {}
+
+  ~EntryReader()
+  {
+    {
+      lock_guard<mutex> lock(fMutex);
+      fStop = true;
+    }
+    fCondition.notify_all();
+    fThread.join();
+  }
+
+  void Request(Long64_t entry)
+  {
+    {
+      lock_guard<mutex> lock(fMutex);
+      fRequested = entry;
+    }
+    fCondition.notify_all();
+  }
+
+  void Wait(Long64_t entry)
+  {
+    unique_lock<mutex> lock(fMutex);
+    fCondition.wait(lock, [this, entry] { return fDone == entry; });
+  }
+
+private:
+  void Run()
+  {
+    Long64_t entry;
+    while(true)
+    {
+      {
+        unique_lock<mutex> lock(fMutex);
+        fCondition.wait(lock, [this] { return fStop || fRequested != fDone; });
+        if(fStop) return;
+        entry = fRequested;
+      }
+
+      fReader->ReadEntry(entry);
+
+      {
+        lock_guard<mutex> lock(fMutex);
+        fDone = entry;
+      }
+      fCondition.notify_all();
+    }
+  }
+
+  ExRootTreeReader *fReader;
+  Long64_t fRequested, fDone;
+  bool fStop;
+  mutex fMutex;
+  condition_variable fCondition;
+  thread fThread;
+};
+
+//---------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  char appName[] = "DelphesDiff";
+  stringstream message;
+  TChain *chains[2] = {0, 0};
+  ExRootTreeReader *readers[2] = {0, 0};
+  EntryReader *entryReader = 0;
+  TFile *histogramFile = 0;
+  TH1D *histogramDifferences = 0;
+  TClonesArray *arrays[2];
+  TBranch *branchObject;
+  vector<Branch> branches;
+  vector<Tolerance> tolerances;
+  vector<Long64_t> differingEvents;
+  ObjectMap objects[2];
+  Bool_t objectsBuilt;
+  Branch branch;
+  Tolerance tolerance;
+  const char *value, *treeName = "Delphes", *histogramName = 0;
+  const char *files[2];
+  TRefArray *refs[2];
+  char *objectA, *objectB;
+  TString parameter, name;
+  TStopwatch stopWatch;
+  Int_t i, j, k, l, m, n, size, file, reports = 0, maxReports = 20, maxEvents = 10, cacheSize = 64;
+  Long64_t entry, allEntries, eventDifferences, totalDifferences = 0, ulps, defaultUlps = 0;
+  Double_t a, b, relative, defaultTolerance = 0.0;
+  Bool_t parallel = kTRUE, equal, structural = kFALSE;
+  pair<Int_t, Int_t> target[2];
+  Float_t fa, fb;
+
+  if(argc < 3)
+  {
+    cout << " Usage: " << appName << " input_file_1"
+         << " input_file_2"
+         << " [options]" << endl;
+    cout << " input_file_1, input_file_2 - Delphes output files in ROOT format," << endl;
+    cout << " options:" << endl;
+    cout << "  --tree=NAME - name of the tree (default Delphes)," << endl;
+    cout << "  --tolerance=X - relative tolerance of floating point fields (default 0, exact)," << endl;
+    cout << "  --ulps=N - tolerance of floating point fields in units in the last place (default 0)," << endl;
+    cout << "  --field-tolerance=PATTERN:X - relative tolerance of the fields matching" << endl;
+    cout << "    the shell pattern, e.g. Jet.PT:1e-6 or *.Eta:1e-7," << endl;
+    cout << "  --field-ulps=PATTERN:N - tolerance in units in the last place of the fields matching" << endl;
+    cout << "    the shell pattern," << endl;
+    cout << "  --max-reports=N - number of differences printed (default 20)," << endl;
+    cout << "  --max-events=N - number of differing events listed (default 10)," << endl;
+    cout << "  --histograms=FILE - ROOT file with the distributions of the differences," << endl;
+    cout << "  --cache-size=N - read cache of each file in MB (default 64)," << endl;
+    cout << "  --sequential - read both files in the main thread." << endl;
+    cout << " Exit status is 0 for identical files and 2 if they differ." << endl;
+    return 1;
+  }
+
+  signal(SIGINT, SignalHandler);
+
+  gROOT->SetBatch();
+
+  int appargc = 1;
+  char *appargv[] = {appName};
+  TApplication app(appName, &appargc, appargv);
+
+  try
+  {
+    files[0] = argv[1];
+    files[1] = argv[2];
+
+    for(i = 3; i < argc; ++i)
+    {
+      if(GetOption(argv[i], "tree", value))
+        treeName = value;
+      else if(GetOption(argv[i], "tolerance", value))
+        defaultTolerance = atof(value);
+      else if(GetOption(argv[i], "ulps", value))
+        defaultUlps = atoll(value);
+      else if(GetOption(argv[i], "field-tolerance", value) || GetOption(argv[i], "field-ulps", value))
+      {
+        parameter = value;
+        k = parameter.Last(':');
+        if(k <= 0)
+        {
+          message << "option " << argv[i] << " is not of the form PATTERN:VALUE";
+          throw runtime_error(message.str());
+        }
+        tolerance.pattern = parameter(0, k);
+        tolerance.tolerance = -1.0;
+        tolerance.ulps = -1;
+        if(strncmp(argv[i], "--field-tolerance", 17) == 0)
+          tolerance.tolerance = atof(parameter.Data() + k + 1);
+        else
+          tolerance.ulps = atoll(parameter.Data() + k + 1);
+        tolerances.push_back(tolerance);
+      }
+      else if(GetOption(argv[i], "max-reports", value))
+        maxReports = atoi(value);
+      else if(GetOption(argv[i], "max-events", value))
+        maxEvents = atoi(value);
+      else if(GetOption(argv[i], "histograms", value))
+        histogramName = value;
+      else if(GetOption(argv[i], "cache-size", value))
+        cacheSize = atoi(value);
+      else if(strcmp(argv[i], "--sequential") == 0)
+        parallel = kFALSE;
+      else
+      {
+        message << "unknown option " << argv[i];
+        throw runtime_error(message.str());
+      }
+    }
+
+    if(parallel) ROOT::EnableThreadSafety();
+
+    for(file = 0; file < 2; ++file)
+    {
+      chains[file] = new TChain(treeName);
+      if(chains[file]->Add(files[file], -1) <= 0)
+      {
+        message << "can't open tree '" << treeName << "' in " << files[file];
+        throw runtime_error(message.str());
+      }
+
+      // bulk reads of whole clusters of baskets
+      chains[file]->SetCacheSize(Long64_t(cacheSize) * 1048576);
+      chains[file]->AddBranchToCache("*", kTRUE);
+
+      readers[file] = new ExRootTreeReader(chains[file]);
+    }
+
+    // branches present in both files with the same class
+    TIter itBranches(chains[0]->GetListOfBranches());
+    while((branchObject = static_cast<TBranch *>(itBranches.Next())))
+    {
+      name = branchObject->GetName();
+      if(!chains[1]->GetBranch(name))
+      {
+        cout << "** DIFFERENCE: branch " << name << " is only in " << files[0] << endl;
+        structural = kTRUE;
+        continue;
+      }
+
+      arrays[0] = readers[0]->UseBranch(name);
+      arrays[1] = readers[1]->UseBranch(name);
+      if(!arrays[0] || !arrays[1])
+      {
+        cout << "** WARNING: branch " << name << " is not a TClonesArray branch and is not compared" << endl;
+        continue;
+      }
+
+      if(arrays[0]->GetClass() != arrays[1]->GetClass())
+      {
+        cout << "** DIFFERENCE: branch " << name << " holds " << arrays[0]->GetClass()->GetName();
+        cout << " in " << files[0] << " and " << arrays[1]->GetClass()->GetName() << " in " << files[1] << endl;
+        structural = kTRUE;
+        continue;
+      }
+
+      branch.name = name;
+      branch.arrays[0] = arrays[0];
+      branch.arrays[1] = arrays[1];
+      branch.fields.clear();
+      branch.sizeMismatches = 0;
+
+      AddFields(arrays[0]->GetClass(), name + ".", 0, branch.fields);
+
+      for(j = 0; j < Int_t(branch.fields.size()); ++j)
+      {
+        Field &field = branch.fields[j];
+        field.tolerance = defaultTolerance;
+        field.ulps = defaultUlps;
+        for(k = 0; k < Int_t(tolerances.size()); ++k)
+        {
+          if(fnmatch(tolerances[k].pattern, field.name, 0) != 0) continue;
+          if(tolerances[k].tolerance >= 0.0) field.tolerance = tolerances[k].tolerance;
+          if(tolerances[k].ulps >= 0) field.ulps = tolerances[k].ulps;
+        }
+      }
+
+      branches.push_back(branch);
+    }
+
+    TIter itOtherBranches(chains[1]->GetListOfBranches());
+    while((branchObject = static_cast<TBranch *>(itOtherBranches.Next())))
+    {
+      if(chains[0]->GetBranch(branchObject->GetName())) continue;
+      cout << "** DIFFERENCE: branch " << branchObject->GetName() << " is only in " << files[1] << endl;
+      structural = kTRUE;
+    }
+
+    allEntries = TMath::Min(readers[0]->GetEntries(), readers[1]->GetEntries());
+    if(readers[0]->GetEntries() != readers[1]->GetEntries())
+    {
+      cout << "** DIFFERENCE: " << readers[0]->GetEntries() << " events in " << files[0];
+      cout << " and " << readers[1]->GetEntries() << " events in " << files[1];
+      cout << ", comparing the first " << allEntries << endl;
+      structural = kTRUE;
+    }
+
+    if(histogramName)
+    {
+      histogramDifferences = new TH1D("Differences", "values beyond tolerance per differing event;differences;events", 100, 0.0, 1000.0);
+      histogramDifferences->SetDirectory(0);
+    }
+
+    cout << "** Comparing " << branches.size() << " branches in " << allEntries << " events" << endl;
+
+    if(parallel) entryReader = new EntryReader(readers[1]);
+
+    ExRootProgressBar progressBar(allEntries);
+
+    stopWatch.Start();
+
+    // Loop over all events
+    for(entry = 0; entry < allEntries && !interrupted; ++entry)
+    {
+      if(entryReader)
+      {
+        entryReader->Request(entry);
+        readers[0]->ReadEntry(entry);
+        entryReader->Wait(entry);
+      }
+      else
+      {
+        readers[0]->ReadEntry(entry);
+        readers[1]->ReadEntry(entry);
+      }
+
+      eventDifferences = 0;
+      objectsBuilt = kFALSE;
+
+      for(i = 0; i < Int_t(branches.size()); ++i)
+      {
+        Branch &current = branches[i];
+
+        size = current.arrays[0]->GetEntriesFast();
+        if(size != current.arrays[1]->GetEntriesFast())
+        {
+          ++current.sizeMismatches;
+          ++eventDifferences;
+          if(reports++ < maxReports)
+          {
+            cout << "** event " << entry << ", " << current.name << ": " << size;
+            cout << " != " << current.arrays[1]->GetEntriesFast() << " objects" << endl;
+          }
+          size = TMath::Min(size, current.arrays[1]->GetEntriesFast());
+        }
+
+        for(j = 0; j < size; ++j)
+        {
+          objectA = reinterpret_cast<char *>(current.arrays[0]->UncheckedAt(j));
+          objectB = reinterpret_cast<char *>(current.arrays[1]->UncheckedAt(j));
+
+          for(k = 0; k < Int_t(current.fields.size()); ++k)
+          {
+            Field &field = current.fields[k];
+            char *pa = objectA + field.offset;
+            char *pb = objectB + field.offset;
+
+            for(l = 0; l < field.count; ++l)
+            {
+              ++field.compared;
+              relative = 0.0;
+              ulps = 0;
+
+              switch(field.type)
+              {
+                case kFieldInteger:
+                case kFieldUnsigned:
+                  equal = memcmp(pa + l * field.size, pb + l * field.size, field.size) == 0;
+                  if(equal) break;
+                  a = GetInteger(pa + l * field.size, field.size, field.type == kFieldUnsigned);
+                  b = GetInteger(pb + l * field.size, field.size, field.type == kFieldUnsigned);
+                  ulps = -1;
+                  break;
+                case kFieldFloat:
+                  memcpy(&fa, pa + l * sizeof(Float_t), sizeof(Float_t));
+                  memcpy(&fb, pb + l * sizeof(Float_t), sizeof(Float_t));
+                  a = fa;
+                  b = fb;
+                  equal = fa == fb || (TMath::IsNaN(fa) && TMath::IsNaN(fb));
+                  if(!equal) ulps = GetUlps<Float_t, Int_t>(fa, fb);
+                  break;
+                case kFieldDouble:
+                  memcpy(&a, pa + l * sizeof(Double_t), sizeof(Double_t));
+                  memcpy(&b, pb + l * sizeof(Double_t), sizeof(Double_t));
+                  equal = a == b || (TMath::IsNaN(a) && TMath::IsNaN(b));
+                  if(!equal) ulps = GetUlps<Double_t, Long64_t>(a, b);
+                  break;
+                default:
+                  // references are compared as branch and index of the target
+                  if(!objectsBuilt)
+                  {
+                    BuildObjectMap(branches, 0, objects[0]);
+                    BuildObjectMap(branches, 1, objects[1]);
+                    objectsBuilt = kTRUE;
+                  }
+                  a = b = 0.0;
+                  if(field.type == kFieldRef)
+                  {
+                    target[0] = FindObject(objects[0], reinterpret_cast<TRef *>(pa)->GetUniqueID());
+                    target[1] = FindObject(objects[1], reinterpret_cast<TRef *>(pb)->GetUniqueID());
+                    equal = target[0] == target[1];
+                    a = target[0].second;
+                    b = target[1].second;
+                  }
+                  else
+                  {
+                    refs[0] = reinterpret_cast<TRefArray *>(pa);
+                    refs[1] = reinterpret_cast<TRefArray *>(pb);
+                    n = refs[0]->GetEntriesFast();
+                    equal = n == refs[1]->GetEntriesFast();
+                    a = n;
+                    b = refs[1]->GetEntriesFast();
+                    for(m = 0; equal && m < n; ++m)
+                    {
+                      target[0] = FindObject(objects[0], refs[0]->GetUID(m));
+                      target[1] = FindObject(objects[1], refs[1]->GetUID(m));
+                      equal = target[0] == target[1];
+                      if(!equal)
+                      {
+                        a = target[0].second;
+                        b = target[1].second;
+                      }
+                    }
+                  }
+                  if(!equal) ulps = -1;
+              }
+
+              if(equal) continue;
+
+              ++field.inexact;
+
+              if(ulps > 0)
+              {
+                relative = TMath::Abs(a - b) / TMath::Max(TMath::Abs(a), TMath::Abs(b));
+                field.maxRelative = TMath::Max(field.maxRelative, relative);
+                field.maxUlps = TMath::Max(field.maxUlps, ulps);
+
+                if(histogramName)
+                {
+                  if(!field.histogram)
+                  {
+                    field.histogram = new TH1D(field.name, field.name + ";log_{10}(relative difference);values", 64, -16.0, 0.0);
+                    field.histogram->SetDirectory(0);
+                  }
+                  field.histogram->Fill(TMath::Log10(TMath::Max(relative, 1.0e-16)));
+                }
+
+                if(relative <= field.tolerance || ulps <= field.ulps) continue;
+              }
+
+              ++field.differing;
+              ++eventDifferences;
+
+              if(reports++ < maxReports)
+              {
+                cout << "** event " << entry << ", " << current.name << "[" << j << "]";
+                cout << field.name.Data() + current.name.Length();
+                if(field.count > 1) cout << "[" << l << "]";
+                if(field.type == kFieldRef)
+                  printf(": references to objects %g != %g", a, b);
+                else if(field.type == kFieldRefArray)
+                  printf(": references %g != %g", a, b);
+                else
+                  printf(": %.17g != %.17g", a, b);
+                if(ulps > 0) printf(" (relative %.3g, %lld ulps)", relative, ulps);
+                cout << endl;
+              }
+            }
+          }
+        }
+      }
+
+      if(eventDifferences > 0)
+      {
+        ++totalDifferences;
+        if(Int_t(differingEvents.size()) < maxEvents) differingEvents.push_back(entry);
+        if(histogramDifferences) histogramDifferences->Fill(eventDifferences);
+      }
+
+      progressBar.Update(entry, entry);
+    }
+
+    progressBar.Update(entry, entry, kTRUE);
+    progressBar.Finish();
+
+    stopWatch.Stop();
+
+    if(entryReader) delete entryReader;
+
+    // Summary
+    cout << endl;
+    cout << "** Compared " << entry << " events in " << stopWatch.RealTime() << " s, ";
+    cout << totalDifferences << " events differ" << endl;
+
+    if(!differingEvents.empty())
+    {
+      cout << "** First differing events:";
+      for(i = 0; i < Int_t(differingEvents.size()); ++i) cout << " " << differingEvents[i];
+      cout << endl;
+    }
+
+    cout << endl;
+    cout << "                                  Field       Values    Inexact  Differing   Max relative   Max ulps" << endl;
+    for(i = 0; i < Int_t(branches.size()); ++i)
+    {
+      if(branches[i].sizeMismatches > 0)
+      {
+        printf("%40s %12s %10s %10lld\n", (branches[i].name + "_size").Data(), "", "", branches[i].sizeMismatches);
+      }
+      for(j = 0; j < Int_t(branches[i].fields.size()); ++j)
+      {
+        Field &field = branches[i].fields[j];
+        if(field.inexact == 0) continue;
+        printf("%40s %12lld %10lld %10lld %14.3g %10lld\n", field.name.Data(), field.compared,
+          field.inexact, field.differing, field.maxRelative, field.maxUlps);
+      }
+    }
+    cout << endl;
+
+    if(histogramName)
+    {
+      histogramFile = TFile::Open(histogramName, "RECREATE");
+      if(!histogramFile)
+      {
+        message << "can't create " << histogramName;
+        throw runtime_error(message.str());
+      }
+
+      histogramDifferences->Write();
+      for(i = 0; i < Int_t(branches.size()); ++i)
+      {
+        for(j = 0; j < Int_t(branches[i].fields.size()); ++j)
+        {
+          if(branches[i].fields[j].histogram) branches[i].fields[j].histogram->Write();
+        }
+      }
+
+      histogramFile->Close();
+      cout << "** Histograms written to " << histogramName << endl;
+    }
+
+    if(structural || totalDifferences > 0)
+      cout << "** Files differ" << endl;
+    else if(defaultTolerance > 0.0 || defaultUlps > 0 || !tolerances.empty())
+      cout << "** Files are identical within tolerances" << endl;
+    else
+      cout << "** Files are identical" << endl;
+
+    cout << "** Exiting..." << endl;
+
+    for(file = 0; file < 2; ++file)
+    {
+      delete readers[file];
+      delete chains[file];
+    }
+
+    return structural || totalDifferences > 0 ? 2 : 0;
+  }
+  catch(runtime_error &e)
+  {
+    if(entryReader) delete entryReader;
+    cerr << "** ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
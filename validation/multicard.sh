@@ -0,0 +1,45 @@
+#!/bin/bash
+################################################################################
+#
+# This code checks that processing several detector cards in one pass gives
+# the same output as processing each card on its own.
+#
+# Execute from Delphes main dir after compiling DelphesHepMC2 and DelphesDiff:
+#
+# ./validation/multicard.sh [detector_card_1] [detector_card_2] [input_file]
+#
+#  e.g.
+#
+# ./validation/multicard.sh cards/delphes_card_CMS.tcl cards/delphes_card_ATLAS.tcl test.hepmc
+#
+# The script exits with a non-zero status if any of the outputs differ.
+#
+################################################################################
+
+EXPECTED_ARGS=3
+E_BADARGS=65
+
+if [ $# -ne $EXPECTED_ARGS ]
+then
+  echo "Usage: ./validation/multicard.sh [detector_card_1] [detector_card_2] [input_file]"
+  echo "for instance: ./validation/multicard.sh cards/delphes_card_CMS.tcl cards/delphes_card_ATLAS.tcl test.hepmc"
+  exit $E_BADARGS
+fi
+
+outputdir=multicard_report
+status=0
+
+mkdir -p $outputdir
+rm -f $outputdir/*.root
+
+./DelphesHepMC2 $1,$2 $outputdir/multi_1.root,$outputdir/multi_2.root $3 || exit 1
+./DelphesHepMC2 $1 $outputdir/single_1.root $3 || exit 1
+./DelphesHepMC2 $2 $outputdir/single_2.root $3 || exit 1
+
+for i in 1 2
+do
+  echo "comparing card $i"
+  ./DelphesDiff $outputdir/single_$i.root $outputdir/multi_$i.root || status=1
+done
+
+exit $status